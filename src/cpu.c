@@ -20,56 +20,93 @@
 */
 
 #include <stdio.h>
+#include "gb.h"
 #include "cpu.h"
+#include "lcd.h"
+#include "timer.h"
+#include "scheduler.h"
+#include "trace.h"
 
 /*
 Resets the CPU's registers to the state it should be in after the BIOS
 releases control of the system.
 */
-void CPU_reset()
+void CPU_reset(struct gb_context *gb)
 {
-	A = 0x01;
-	B = 0;
-	C = 0x13;
-	D = 0;
-	E = 0xD8;
-	H = 0x01;
-	L = 0x4D;
-
-	F.Z = 1;
-	F.N = 0;
-	F.H = 1;
-	F.C = 1;
-	F.F = 0xB0;
-
-	/*AF = 0x01B0;
-	BC = 0x0013;
-	DE = 0x00D8;
-	HL = 0x014D;*/
-
-	PC = 0x0100;
-	SP = 0xFFFE;
-
-	memory[0xFF05] = 0x00;
-	memory[0xFF06] = 0x00;
-	memory[0xFF07] = 0x00;
+	gb->AF.w = 0x01B0;
+	gb->BC.w = 0x0013;
+	gb->DE.w = 0x00D8;
+	gb->HL.w = 0x014D;
+
+	gb->F.Z = 1;
+	gb->F.N = 0;
+	gb->F.H = 1;
+	gb->F.C = 1;
+	gb->flags.op = FLAGS_KNOWN;
+
+	gb->PC = 0x0100;
+	gb->SP = 0xFFFE;
+
+	gb->memory[0xFF00] = 0xCF;
+	gb->buttons = 0;
+	gb->memory[0xFF05] = 0x00;
+	gb->memory[0xFF06] = 0x00;
+	gb->memory[0xFF07] = 0x00;
 	/* TODO finish these */
 
-	memory[0xFF40] = 0x91;
-	memory[0xFF42] = 0x00;
-	memory[0xFF43] = 0x00;
-	memory[0xFF45] = 0x00;
-	memory[0xFF47] = 0xFC;
-	memory[0xFF48] = 0xFF;
-	memory[0xFF49] = 0xFF;
-	memory[0xFF4A] = 0x00;
-	memory[0xFF4B] = 0x00;
-	memory[0xFFFF] = 0x00;
-
-	cycles = 0;
-	max_cycles = 69905;
-	ie = 0;
-	interrupt_step = 0;
+	gb->memory[0xFF40] = 0x91;
+	gb->memory[0xFF42] = 0x00;
+	gb->memory[0xFF43] = 0x00;
+	gb->memory[0xFF45] = 0x00;
+	gb->memory[0xFF47] = 0xFC;
+	gb->memory[0xFF48] = 0xFF;
+	gb->memory[0xFF49] = 0xFF;
+	gb->memory[0xFF4A] = 0x00;
+	gb->memory[0xFF4B] = 0x00;
+	gb->memory[0xFFFF] = 0x00;
+
+	gb->cycles = 0;
+	gb->total_cycles = 0;
+	gb->max_cycles = 69905;
+	gb->frames = 0;
+	gb->stop = 0;
+	gb->ie = 0;
+	gb->interrupt_step = 0;
+
+	/* Start the hardware off with an empty event queue */
+	SCHEDULER_reset(gb);
+	LCD_init(gb);
+	TIMER_reset(gb);
+}
+
+/*
+	Everything that has to happen between two instructions: keep
+	count of the cycles and, if the LCD, timer or interrupts are
+	due some attention, run their events.
+*/
+void CPU_tick(struct gb_context *gb)
+{
+	gb->total_cycles += gb->cycles;
+	gb->scheduler_now += gb->cycles;
+
+	if(gb->scheduler_now >= gb->scheduler_next)
+		SCHEDULER_run(gb);
+
+	if(gb->total_cycles >= gb->max_cycles)
+	{
+		gb->total_cycles = 0;
+		gb->frames++;
+
+		if(gb->frames == gb->frame_limit)
+			gb->stop = 1;
+
+		/*
+			Frames are put on screen by the LCD at V-blank,
+			see GL_present(), this count isn't in step with
+			it. The batch runner ends its frames there and
+			only counts here while the LCD's off
+		*/
+	}
 }
 
 
@@ -87,16 +124,15 @@ void CPU_reset()
 	few can do the necessary work within the CPU switch and
 	send a 0 in the flag and condition parameter
 
-	Returns 0 if the condition wasn't true, this is done so that
-	if there were no jump, the switch case can increase the PC to
-	prevent endless loops. Returns 1 on success.
+	Returns 0 if the condition wasn't true, PC is then left
+	pointing at the next instruction. Returns 1 on success.
 */
-byte CPU_jump(byte flag, word address, byte condition)
+byte CPU_jump(struct gb_context *gb, byte flag, word address, byte condition)
 {
 	byte ret = 1;
 
 	if(flag == condition)
-		PC = address;
+		gb->PC = address;
 	else
 		ret = 0;
 
@@ -108,18 +144,16 @@ byte CPU_jump(byte flag, word address, byte condition)
 
 /* 8-BIT LOADS */
 
-/* Load immediate data(PC + 1) into register */
-void CPU_load_immediate(byte *reg)
+/* Load the immediate byte into register */
+void CPU_load_immediate(struct gb_context *gb, byte *reg)
 {
-	*reg = memory_readb(PC + 1);
-	PC += 2;
+	*reg = gb->operand8;
 }
 
 /* Load the value in the from register into the to register */
 void CPU_load_register(byte *to, byte *from)
 {
 	*to = *from;
-	PC += 1;
 }
 
 /*
@@ -127,14 +161,13 @@ void CPU_load_register(byte *to, byte *from)
 	direction = 0: load register with the data at address
 	direction = 1: load data at address with register
 */
-void CPU_load_address(byte *reg, word address, byte direction)
+void CPU_load_address(struct gb_context *gb, byte *reg, word address,
+	byte direction)
 {
 	if(direction == 0)
-		*reg = memory_readb(address);
+		*reg = memory_readb(gb, address);
 	else
-		memory_writeb(address, *reg);
-
-	PC += 1;
+		memory_writeb(gb, address, *reg);
 }
 
 /* 16-BIT LOADS */
@@ -142,33 +175,33 @@ void CPU_load_address(byte *reg, word address, byte direction)
 /*
 	Load the immediate 16-bit value into a register pair
 */
-void CPU_load_immediate16(byte *pair_a, byte *pair_b)
+void CPU_load_immediate16(struct gb_context *gb, word *pair)
 {
-	/* These are switched TODO */
-	*pair_a = memory_readb(PC + 2);
-	*pair_b = memory_readb(PC + 1);
-
-	PC += 3;
+	*pair = gb->operand16;
 }
 
 /*
-	Push two bytes onto the stack, used with register
-	pairs or immediate addresses.
+	Push a register pair onto the stack, the high byte
+	goes first
 */
-void CPU_load_sp_16(byte *pair_a, byte *pair_b)
+void CPU_load_sp_16(struct gb_context *gb, word pair)
 {
-	SP_push(*pair_a);
-	SP_push(*pair_b);
+	SP_push(gb, pair >> 8);
+	SP_push(gb, pair & 0xFF);
 }
 
 /*
-	Pop two bytes off the stack into registers or
-	immediate addresses.
+	Pop a register pair off the stack, the low byte
+	comes off first
 */
-void CPU_load_16_sp(byte *pair_a, byte *pair_b)
+void CPU_load_16_sp(struct gb_context *gb, word *pair)
 {
-	SP_pop(pair_a);
-	SP_pop(pair_b);
+	byte low, high;
+
+	SP_pop(gb, &low);
+	SP_pop(gb, &high);
+
+	*pair = (high << 8) | low;
 }
 
 /* ++++ ALU ++++ */
@@ -186,15 +219,14 @@ void CPU_load_16_sp(byte *pair_a, byte *pair_b)
 	Half Carry flag is set if there is a carry
 		from bit 3 to bit 4.
 */
-void CPU_add_8(byte* toAdd, byte Carry)
+void CPU_add_8(struct gb_context *gb, byte* toAdd, byte Carry)
 {
 	/*
 	Example:
 		A = 1011-1001
 		toAdd = 1111-1111
 	*/
-	byte half = A;
-	CPU_clear_flags();
+	gb->flags.a = gb->AF.b.hi;
 
 	/*
 		If Carry is set to 1, add it to toAdd,
@@ -205,35 +237,16 @@ void CPU_add_8(byte* toAdd, byte Carry)
 		into the same function
 	*/
 	*toAdd += Carry;
+	gb->flags.b = *toAdd;
 
-	/* If A will overflow after the addition, set Carry flag */
-	/* If:
-		(1011-1001 + 1111-1111) > 1111-1111
-	*/
-	if((A + *toAdd) > 0xFF)
-		F.C = 1;
-
-	A += *toAdd;
-
-	/* If A is zero after the addition, set Zero flag */
-	if(A == 0)
-		F.Z = 1;
-
-	half = (half & 0xF);
-	/* half = 1001 (lower nibble of original A) */
-	half += (*toAdd & 0xF);
-	/* half += 1111 (lower nibble of toAdd) */
+	gb->AF.b.hi += *toAdd;
 
 	/*
-		If half is greater than 0xF, then we know that
-		there was a Carry from the lower to upper nibble
-		and that the Half Carry flag should be set.
-
-		In our example, half is now equal to 0001-1000,
-		so Half Carry should be set
+		Adding A to itself changes what the Half Carry is
+		worked out from, see CPU_flags()
 	*/
-	if(half > 0xF)
-		F.H = 1;
+	gb->flags.op = (toAdd == &gb->AF.b.hi) ? FLAGS_ADD_A : FLAGS_ADD;
+	gb->flags.result = gb->AF.b.hi;
 }
 
 /*
@@ -248,16 +261,13 @@ void CPU_add_8(byte* toAdd, byte Carry)
 	Half Carry flag is set if there's no borrow from bit 4
 	Carry flag is set if there's no borrow(if the result < 0)
 */
-void CPU_subtract_8(byte *toSub, byte Carry)
+void CPU_subtract_8(struct gb_context *gb, byte *toSub, byte Carry)
 {
 	/*
 	Example:
 		A = 1011-1001
 		toSub = 1111-1111
 	*/
-	byte half = A;
-	CPU_clear_flags();
-
 	/*
 		If Carry is set, toSub will be incremented
 		if not, toSub will be the same
@@ -268,42 +278,14 @@ void CPU_subtract_8(byte *toSub, byte Carry)
 	*/
 	*toSub += Carry;
 
-	/*
-		Set the subtraction flag as this function will
-		likely use subtraction
-	*/
-	F.N = 1;
-
-	/*
-		If the result of A - toSub is less than 0, then
-		set the Carry flag
-
-		If:
-		(1011-1001 - 1111-1111) < 0000-0000
-	*/
-	if((A - *toSub) < 0)
-		F.C = 1;
+	gb->flags.op = FLAGS_SUB;
+	gb->flags.a = gb->AF.b.hi;
+	gb->flags.b = *toSub;
 
 	/* Do the actual subtraction */
-	A -= *toSub;
+	gb->AF.b.hi -= *toSub;
 
-	/* If the result of the subtraction is 0, set the Zero flag */
-	if(A == 0)
-		F.Z = 1;
-
-	half = (half & 0xF);
-	/* half = 1001 (lower nibble of half) */
-	half -= (*toSub & 0xF);
-	/* half -= 1111 (lower nibble of toSub) */
-
-	/*
-		If half is less than zero, then we borrowed from bit 4
-
-		In our example, half is now equal to -6(9-15), so we
-		need to set the Half Carry flag
-	*/
-	if(half < 0)
-		F.H = 1;
+	gb->flags.result = gb->AF.b.hi;
 }
 
 /*
@@ -314,19 +296,13 @@ void CPU_subtract_8(byte *toSub, byte Carry)
 	Half Carry flag is set
 	Carry flag is reset
 */
-void CPU_and_8(byte *toAnd)
+void CPU_and_8(struct gb_context *gb, byte *toAnd)
 {
-	CPU_clear_flags();
-
 	/* Do the actual ANDing */
-	A &= *toAnd;
+	gb->AF.b.hi &= *toAnd;
 
-	/* If result is zero, set Zero flag */
-	if(A == 0)
-		F.Z = 1;
-
-	/* Set Half Carry flag */
-	F.H = 1;
+	gb->flags.op = FLAGS_AND;
+	gb->flags.result = gb->AF.b.hi;
 }
 
 /*
@@ -337,16 +313,13 @@ void CPU_and_8(byte *toAnd)
 	Half Carry flag is reset
 	Carry flag is reset
 */
-void CPU_or_8(byte *toOR)
+void CPU_or_8(struct gb_context *gb, byte *toOR)
 {
-	CPU_clear_flags();
-
 	/* Do the ORing */
-	A |= *toOR;
+	gb->AF.b.hi |= *toOR;
 
-	/* If the result was 0, set Zero flag */
-	if(A == 0)
-		F.Z = 1;
+	gb->flags.op = FLAGS_ZERO;
+	gb->flags.result = gb->AF.b.hi;
 }
 
 /*
@@ -357,16 +330,13 @@ void CPU_or_8(byte *toOR)
 	Half Carry flag is reset
 	Carry flag is reset
 */
-void CPU_xor_8(byte* toXOR)
+void CPU_xor_8(struct gb_context *gb, byte* toXOR)
 {
-	CPU_clear_flags();
-
 	/* Do the XORing */
-	A ^= *toXOR;
+	gb->AF.b.hi ^= *toXOR;
 
-	/* If the result was 0, set Zero flag */
-	if(A == 0)
-		F.Z = 1;
+	gb->flags.op = FLAGS_ZERO;
+	gb->flags.result = gb->AF.b.hi;
 }
 
 /*
@@ -382,34 +352,19 @@ void CPU_xor_8(byte* toXOR)
 	where the results are thrown away, we will piggy
 	back on the subtract function
 */
-void CPU_compare_8(byte *toCompare)
+void CPU_compare_8(struct gb_context *gb, byte *toCompare)
 {
 	/*
 		Make a backup of A so we can reinstate
 		A to clear the results of the subtract
 	*/
-	byte before = A;
+	byte before = gb->AF.b.hi;
 
 	/*
-		We'll call subtract as it will set the
-		subtract flag and properly work out the
-		Half Carry flag for us
+		We'll call subtract as it records everything the
+		flags need: Zero when A == byte, Carry when A < byte
 	*/
-	CPU_subtract_8(toCompare, 0);
-
-	/*
-		If the original A is the same as the
-		compared value, set the Zero flag
-	*/
-	if(before == *toCompare)
-		F.Z = 1;
-
-	/*
-		If the original A is less than the
-		compared value, set the Carry flag
-	*/
-	if(before < *toCompare)
-		F.C = 1;
+	CPU_subtract_8(gb, toCompare, 0);
 
 	/*
 		Since we don't care about the result
@@ -417,7 +372,7 @@ void CPU_compare_8(byte *toCompare)
 		we'll reinstate the original value of
 		A here
 	*/
-	A = before;
+	gb->AF.b.hi = before;
 }
 
 /*
@@ -433,41 +388,21 @@ void CPU_compare_8(byte *toCompare)
 		increment; set if no borrow from bit 4 on decrement
 	Carry flag is not affected, resetting it
 */
-void CPU_incdec_8(byte *reg, byte direction)
+void CPU_incdec_8(struct gb_context *gb, byte *reg, byte direction)
 {
-	CPU_clear_flags();
-
 	if(direction == 0)
 	{
-		/*
-			If the lower nibble of reg is 1111, then
-			the Half Carry flag should be set as adding
-			one to this will cause a cary from bit 3
-		*/
-		if((*reg & 0xF) == 0xF)
-			F.H = 1;
-
 		*reg += 1;
+		gb->flags.op = FLAGS_INC;
 	}
 	else
 	{
-		F.N = 1;
-
-		/*
-			If the lower nibble of reg is 0, then
-			the Half Carry flag should be set as subtracting
-			one from this will mean there was no borrow
-			from bit 4
-		*/
-		if((*reg & 0xF) == 0)
-			F.H = 1;
-
 		*reg -= 1;
+		gb->flags.op = FLAGS_DEC;
 	}
 
-	/* If reg is zero, set Zero flag */
-	if(*reg == 0)
-		F.Z = 1;
+	/* The nibble carry/borrow can be read back off the result */
+	gb->flags.result = *reg;
 }
 
 
@@ -475,46 +410,22 @@ void CPU_incdec_8(byte *reg, byte direction)
 /* 16-BIT ALU */
 
 /*
-	Add two 16-bit numbers(a pair), leave result in pair 1
+	Add a 16-bit number to a register pair, leave the result
+	in the pair
 
 	Zero flag unaffected(reset)
 	Subtract flag reset
 	Half Carry set if carry from bit 11
 	Carry set if carry from bit 15
 */
-void CPU_add_16(byte *pair1_a, byte *pair1_b, byte *pair2_a, byte *pair2_b)
+void CPU_add_16(struct gb_context *gb, word *pair, word value)
 {
-	word pair1, pair2;
-
-	CPU_clear_flags();
-
-	/* Convert individual registers to pairs */
-	convert_to_pair(pair1_a, pair1_b, &pair1);
-	convert_to_pair(pair2_a, pair2_b, &pair2);
-
-	/*
-		If the two added pairs are larger
-		than 16 bits, then set the Carry flag
-	*/
-	if((pair1 + pair2) > 0xFFFF)
-		F.C = 1;
-
-	/*
-		If the two added pairs are larger
-		than 12 bits, set the Half Carry
-		flag
-	*/
-	if(((pair1 & 0xFFF) + pair2) > 0xFFF)
-		F.H = 1;
+	gb->flags.op = FLAGS_ADD_16;
+	gb->flags.a16 = *pair;
+	gb->flags.b16 = value;
 
 	/* Do the actual adding */
-	pair1 += pair2;
-
-	/*
-		Update the individual registers with
-		the calculated numbers
-	*/
-	convert_to_bytes(pair1_a, pair1_b, &pair1);
+	*pair += value;
 }
 
 /*
@@ -525,10 +436,8 @@ void CPU_add_16(byte *pair1_a, byte *pair1_b, byte *pair2_a, byte *pair2_b)
 	Half Carry flag is set on carry from bit 3 to 4
 	Carry flag is set on carry from bit 7 to 8
 */
-void CPU_add_sp_n(byte immediate)
+void CPU_add_sp_n(struct gb_context *gb, byte immediate)
 {
-	CPU_clear_flags();
-
 	/*
 		The result will be the value of SP plus the
 		immediate byte(n), since this may go over the
@@ -541,35 +450,14 @@ void CPU_add_sp_n(byte immediate)
 		FF9B + CB = 10066(overflow)
 		10066 AND FFFF = 66(good)
 
-		The extra data will be used to calculate Carry
-		and Half carry flags
-	*/
-	SP = (SP + immediate) & 0xFFFF;
-
-	/*
-		Carry is set when there's an overflow
-		from bit 7 to bit 8(00FF to 010F). Here we will
-		grab the lower byte from SP(SP & 0xFF) and add n
-		to it, if it overflows from 7 to 8, then we need
-		to set the carry flag
+		The flags are worked out from the new SP and n
+		when they're needed, see CPU_flags()
 	*/
-	if(((SP & 0xFF) + immediate) > 0xFF)
-	{
-		F.C = 1;
-	}
+	gb->SP = (gb->SP + immediate) & 0xFFFF;
 
-	/*
-		The Half carry flag is set when there's an overflow
-		from bit 3 to bit 4(000F to 0010). This is just
-		ike the carry flag, except we need just the lower
-		4 bits from both SP and n(SP & 0xF; n & 0xF), if
-		these combined nibbles are greater than 0xF, then
-		the half carry should be set.
-	*/
-	if(((SP & 0xF) + (immediate & 0xF)) > 0xF)
-	{
-		F.H = 1;
-	}
+	gb->flags.op = FLAGS_ADD_SP;
+	gb->flags.a16 = gb->SP;
+	gb->flags.b = immediate;
 }
 
 /*
@@ -581,24 +469,13 @@ void CPU_add_sp_n(byte immediate)
 	Flags affected:
 	None!
 */
-void CPU_incdec_16(byte *pair_a, byte *pair_b, byte direction)
+void CPU_incdec_16(word *pair, byte direction)
 {
-	word pair;
-
-	/*
-		group the two registers into a word for
-		easy manipulation
-	*/
-	convert_to_pair(pair_a, pair_b, &pair);
-
 	/* Increment or decrement */
 	if(direction == 0)
-		pair++;
+		(*pair)++;
 	else
-		pair--;
-
-	/* Update the registers with the manipulated pair */
-	convert_to_bytes(pair_a, pair_b, &pair);
+		(*pair)--;
 }
 
 /* ++++++ CALLS, RESTARTS, AND RETURNS ++++++ */
@@ -607,102 +484,73 @@ void CPU_incdec_16(byte *pair_a, byte *pair_b, byte direction)
 	Push next address onto the stack and jump to the 2 byte
 	immediate address
 */
-void CPU_call()
+void CPU_call(struct gb_context *gb)
 {
 	word address;
 	byte high, low;
 
-	printf("DBG CALL CURRENT OP: %X\n", PC);
-
-	/* Get next instruction address */
-	address = PC + 3;
-
-	printf("DBG CALL NEXT INSTR: %X\n", PC+3);
+	/* PC already holds the next instruction's address */
+	address = gb->PC;
 
 	/* Break next instruction's address into bytes */
-	convert_to_bytes(&low, &high, &address);
-
-	printf("DBG CALL HIGH/LOW PUSH: %X%X\n", high, low);
+	low = address >> 8;
+	high = address & 0xFF;
 
 	/* Push the instruction's bytes onto the stack */
-	SP_push(low);
-	SP_push(high);
-
-	/* Get immediate two-byte value */
-	high = memory_readb(PC+1);
-	low = memory_readb(PC+2);
-
-	printf("DBG CALL HIGH;LOW: %X;%X\n", high, low);
-
-	/* Convert to LSB-first address */
-	convert_to_pair(&low, &high, &address);
-
-	printf("DBG CALL PAIRED ADDRESS: %X\n", address);
+	SP_push(gb, low);
+	SP_push(gb, high);
 
 	/* Finally, we jump, but we do not ask how high */
-	PC = address;
-	/* TODO DELETE THIS DEBUG CALLS */
-	printf("DBG CALL PC: %X\n", PC);
+	gb->PC = gb->operand16;
+
+	TRACE4(TRACE_CALL, address, high, low, gb->PC);
 }
 
 /*
 	Push current address onto the stack and jump to an
 	offset
 
-	TODO clarify restart
 	note: all documentation says current address but it
 	appears that current means the OP after restart
-		i.e. next instruction
+		i.e. next instruction, which is what PC holds by
+		the time the handler runs
 */
-void CPU_restart(byte offset)
+void CPU_restart(struct gb_context *gb, byte offset)
 {
 	byte lower, upper;
-	word address = PC + 1;
+	word address = gb->PC;
 
-	printf("DBG RST OFFSET: %X\n", offset);
+	TRACE1(TRACE_RESTART, offset);
 
-	/* Break the current address into bytes
-		NOTE adding +1 to PC to satisfy
-		possible weirdness with restarts*/
-	convert_to_bytes(&lower, &upper, &address);
+	/* Break the current address into bytes */
+	lower = address >> 8;
+	upper = address & 0xFF;
 
 	/* Push current addres onto stack, LSB first */
-	SP_push(lower);
-	SP_push(upper);
+	SP_push(gb, lower);
+	SP_push(gb, upper);
 
 	/* Jump to 0x00 + offset */
-	PC = offset;
+	gb->PC = offset;
 }
 
 /*
 	Pop an address from the stack and jump to it
 */
-void CPU_return()
+void CPU_return(struct gb_context *gb)
 {
 	word address;
-	byte temp;
+	byte low, high;
 
-	/* Pop the most significant byte and insert */
-	SP_pop(&temp);
-	printf("DBG RET TEMP1: %X\n", temp);
-	address = temp;
-	printf("DBG RET ADDRESS1: %X\n", address);
+	/* CALL pushed the MSB first, so the LSB comes off first */
+	SP_pop(gb, &low);
+	SP_pop(gb, &high);
+	address = (high << 8) | low;
 
-	/*
-		Push the MSB to the left side of the word
-		????????-MMMMMMMM -> MMMMMMMM-????????
-	*/
-	address <<= 8;
-	printf("DBG RET ADDRESS2: %X\n", address);
-
-	/* Pop the least significant byte and insert into address */
-	SP_pop(&temp);
-	printf("DBG RET TEMP2: %X\n", temp);
-	address += temp;
-	printf("DBG RET ADDRESS3: %X\n", address);
+	TRACE3(TRACE_RETURN, high, low, address);
 
 	/* Jump */
-	PC = address;
+	gb->PC = address;
 }
 
 /* ++++++ ROTATES AND SHIFTS ++++++ */
@@ -714,45 +562,43 @@ void CPU_return()
 	reg - Register to be rotated, duh
 	direction - Rotate left of right (0 == left, 1 == right)
 */
-void CPU_rotate(byte *reg, byte direction)
+void CPU_rotate(struct gb_context *gb, byte *reg, byte direction)
 {
+	/*
+		Keep the value going in, the Carry flag is the
+		bit rotated out of it, see CPU_flags()
+	*/
+	gb->flags.a = *reg;
+
 	if(direction == 0)
 	{
-		/* Save the left-most bit in the Carry flag */
-		F.C = *reg & 0x80;
 		/* Shift left one position */
 		*reg <<= 1;
 		/* Add the most sig. bit back to the right side */
-		*reg += F.C;
+		*reg += gb->flags.a & 0x80;
+
+		gb->flags.op = FLAGS_ROTATE_LEFT;
 	}
 	else
 	{
-		/* Save the right-most bit in the Carry flag */
-		F.C = *reg & 0x01;
 		/* Shift right */
 		*reg >>= 1;
 
 		/*
-			If the carry flag is set, then we need to set
-			the most significant bit. Shifting leaves 0's
-			in the data, so if the Carry bit is zero, then
-			we're already done
+			If the right-most bit was set, then we need to
+			set the most significant bit. Shifting leaves 0's
+			in the data, so if it was zero, then we're
+			already done
 		*/
-		if(F.C == 1)
+		if(gb->flags.a & 0x01)
 		{
 			*reg = *reg | 0x80;
 		}
-	}
 
-	/* Check to see if register is empty, if it is, set Zero flag */
-	if(*reg == 0)
-		F.Z = 1;
-	else
-		F.Z = 0;
+		gb->flags.op = FLAGS_ROTATE_RIGHT;
+	}
 
-	/* Reset N and H flag */
-	F.N = 0;
-	F.H = 0;
+	gb->flags.result = *reg;
 }
 
 /*
@@ -766,35 +612,32 @@ void CPU_rotate(byte *reg, byte direction)
 	reg - Register to be rotated
 	direction - Rotate left or right(0 == left, 1 == right)
 */
-void CPU_rotate_through(byte *reg, byte direction)
+void CPU_rotate_through(struct gb_context *gb, byte *reg, byte direction)
 {
-	byte temp = F.C;
+	byte temp = CPU_flag_C(gb);
+
+	gb->flags.a = *reg;
 
 	if(direction == 0)
 	{
-		F.C = *reg & 0x80;
 		*reg <<= 1;
 		*reg += temp;
+
+		gb->flags.op = FLAGS_ROTATE_LEFT;
 	}
 	else
 	{
-		F.C = *reg & 0x01;
 		*reg >>= 1;
 
 		if(temp == 1)
 		{
 			*reg = *reg | temp;
 		}
-	}
 
-	if(*reg == 0)
-		F.Z = 1;
-	else
-		F.Z = 0;
+		gb->flags.op = FLAGS_ROTATE_RIGHT;
+	}
 
-	/* Reset N and H flags */
-	F.N = 0;
-	F.H = 0;
+	gb->flags.result = *reg;
 }
 
 
@@ -867,7 +710,7 @@ void CPU_res(byte bit, byte *reg)
 	H - Reset
 	C - Reset
 */
-void CPU_swap(byte *reg)
+void CPU_swap(struct gb_context *gb, byte *reg)
 {
 	/* Ex. Reg == UUUU-LLLL */
 	byte upper;
@@ -888,11 +731,9 @@ void CPU_swap(byte *reg)
 	/*	*reg == LLLL-UUUU	*/
 	*reg += upper;
 
-	CPU_clear_flags();
-
-	/* See if Z should be set */
-	if(*reg == 0)
-		F.Z = 1;
+	/* Only Z can be set */
+	gb->flags.op = FLAGS_ZERO;
+	gb->flags.result = *reg;
 }
 
 /*
@@ -910,42 +751,55 @@ void CPU_complement(byte *reg)
 	Function handles both the Enable/Disable Interrupts
 	instructions.
 */
-void CPU_interrupt_switch()
+void CPU_interrupt_switch(struct gb_context *gb)
 {
 	/* Setup the wonky EI/DI work-around */
-	interrupt_step = 2;
+	gb->interrupt_step = 2;
 
-	PC++;
-	cycles = 4;
+	SCHEDULER_add(gb, EVENT_INTERRUPT, 0);
+}
+
+/*
+	Interrupts only need looking at after something changes: a
+	request, a write to the enable register or EI/DI/RETI. Those
+	queue this to run once the current instruction has finished.
+*/
+void CPU_interrupt_event(struct gb_context *gb, long due)
+{
+	CPU_check_interrupts(gb);
+
+	/* EI and DI take effect after the next instruction, come back then */
+	if(gb->interrupt_step > 0)
+		SCHEDULER_add(gb, EVENT_INTERRUPT, 1);
 }
 
 /* See if interrupts are enabled, if they are, see if any have fired */
-void CPU_check_interrupts()
+void CPU_check_interrupts(struct gb_context *gb)
 {
 	/*
 		If interrupt step is more than zero, then the master
 		interrupt enabled flag will be getting switched soon.
 	*/
-	if(interrupt_step > 0)
+	if(gb->interrupt_step > 0)
 	{
-		interrupt_step--;
+		gb->interrupt_step--;
 
 		/* 
 			If interrupt_step hits zero, flip the master
 			IE flag.
 		*/
-		if(interrupt_step == 0)
+		if(gb->interrupt_step == 0)
 		{
-			printf("DBG INTSTEP 0, IE-B: %i\n", ie);
-			if(interrupt_direction == 1)
-				ie = 1;
+			TRACE2(TRACE_IE_SWITCH, gb->ie,
+				gb->interrupt_direction == 1);
+			if(gb->interrupt_direction == 1)
+				gb->ie = 1;
 			else
-				ie = 0;
-			printf("DBG INTSTEP 0, IE-A: %i\n", ie);
+				gb->ie = 0;
 		}
 	}
 
-	if(ie)
+	if(gb->ie)
 	{
 		byte intfired, intenabled;
 		byte bit;
@@ -953,10 +807,11 @@ void CPU_check_interrupts()
 		/*
 			Read the interrupt fired(0xFF0F) and the
 			interrupt enabled(0xFFFF) registers into bytes
-			that we can work with later
+			that we can work with later. IF's unused top bits
+			read as 1, so only its five interrupt bits count.
 		*/
-		intfired = memory_readb(0xFF0F);
-		intenabled = memory_readb(0xFFFF);
+		intfired = memory_readb(gb, 0xFF0F) & 0x1F;
+		intenabled = memory_readb(gb, 0xFFFF);
 
 		/*
 			If no interrupts have fired, just leave cause we
@@ -965,7 +820,7 @@ void CPU_check_interrupts()
 		if(intfired == 0)
 			return;
 
-		printf("DBG IE; INTF: %X, INTE: %X\n", intfired, intenabled);
+		TRACE2(TRACE_INT_PENDING, intfired, intenabled);
 
 		/* 
 			Iterate through all possible interrupts, starting with
@@ -1003,7 +858,7 @@ void CPU_check_interrupts()
 				*/
 				if(bitset(&intenabled, bit))
 				{
-					CPU_service_interrupt(bit);
+					CPU_service_interrupt(gb, bit);
 
 					/*
 						Remove this if we find out ALL
@@ -1023,52 +878,50 @@ void CPU_check_interrupts()
 	More or less, we push the current address to the stack and jump to
 	the appropriate handler in the ROM which are at set addresses
 */
-void CPU_service_interrupt(byte bit)
+void CPU_service_interrupt(struct gb_context *gb, byte bit)
 {
 	/* TODO implement a proper SP_push/pop for words */
 	byte low, high;
 	word address;
 
-	printf("DBG SERV INT: %i\n", bit);
-
 	/* Disable interrupts and reset interrupt_step */
-	ie = 0;
-	interrupt_step = 0;
+	gb->ie = 0;
+	gb->interrupt_step = 0;
 
-	/* Push PC to the stack, LSB first */
-	address = PC;
-	printf("DBG INTSERV PC: %X\n", PC);
-	convert_to_bytes(&high, &low, &address);
+	/* Push PC to the stack, MSB first, like CALL */
+	address = gb->PC;
+	high = address >> 8;
+	low = address & 0xFF;
 
-	printf("DBG INTSERV low: %X; high: %X\n", low, high);
-	SP_push(low);
-	SP_push(high);
+	TRACE4(TRACE_INT_SERVICE, bit, gb->PC, low, high);
+	SP_push(gb, high);
+	SP_push(gb, low);
 
 	/* Reset the interrupt we're about to service's bit */
 	/* TODO make this more clear? */
-	memory[0xFF0F] &= ~(1 << bit);
+	gb->memory[0xFF0F] &= ~(1 << bit);
 
 	/* Jump to the interrupt handler in the ROM */
 	switch(bit)
 	{
 		case 0:
 		{
-			PC = 0x40;
+			gb->PC = 0x40;
 			break;
 		}
 		case 1:
 		{
-			PC = 0x48;
+			gb->PC = 0x48;
 			break;
 		}
 		case 2:
 		{
-			PC = 0x50;
+			gb->PC = 0x50;
 			break;
 		}
 		case 4:
 		{
-			PC = 0x60;
+			gb->PC = 0x60;
 			break;
 		}
 	}
@@ -1077,30 +930,28 @@ void CPU_service_interrupt(byte bit)
 /*
 	Set the appropriate bit in the flag fired register (0xFF0F)
 */
-void CPU_request_interrupt(byte interrupt)
+void CPU_request_interrupt(struct gb_context *gb, byte interrupt)
 {
-	byte flagreg = memory_readb(0xFF0F);
-	printf("DBG REQ INT: %i\n", interrupt);
+	byte flagreg = memory_readb(gb, 0xFF0F);
 
-	printf("DBG REQ INT FLAG: %X\n", flagreg);
 	/* Set the proper interrupt bit in the flag copy */
 	setbit(&flagreg, interrupt);
 
 	/* Update real interrupt flag with updated bits */
-	memory_writeb(0xFF0F, flagreg);
+	memory_writeb(gb, 0xFF0F, flagreg);
 
-	printf("DBG REQ INT READ: %X\n", memory_readb(0xFF0F));
+	TRACE3(TRACE_INT_REQUEST, interrupt, flagreg, memory_readb(gb, 0xFF0F));
 }
 
 /* ++++ MISC. CPU-RELATED HELPER FUNCTIONS ++++ */
 
 /* Function to convert two bytes into a word */
-word convert_to16m(word location1, word location2)
+word convert_to16m(struct gb_context *gb, word location1, word location2)
 {
 	word result;
 	/* 0000-0000 */
-	byte least = memory_readb(location1);
-	byte most = memory_readb(location2);
+	byte least = memory_readb(gb, location1);
+	byte most = memory_readb(gb, location2);
 	
 	/*
 		Put the significant byte into the 16-bit variable(word)
@@ -1118,74 +969,6 @@ word convert_to16m(word location1, word location2)
 	return result;
 }
 
-/*
-	Registers within the GameBoy can be paired in order to simulate
-	16-bit registers, these 16-bit registers are not the result
-	of pairing within this program, so we need this function to
-	update the paired 16-bit registers(AF, BC, etc.) with the
-	values within the individual 8-bit registers
-*/
-void convert_to_pair(byte *reg1, byte *reg2, word *fullreg)
-{
-	/*
-		Set fullreg's LSB to reg1
-		????-reg1
-	*/
-	*fullreg = *reg1;
-
-	/*
-		Move reg1 over to the MSB
-		reg1-0000
-	*/
-	*fullreg <<= 8;
-
-	/*
-		Fill LSB with reg2
-		reg1-reg2
-	*/
-	*fullreg += *reg2;
-}
-
-/*
-	Like convert_to_pair, sometimes we need to update the individual
-	8-bit registers when the equivalent 16-bit pseudo registers are
-	worked on, this function takes in a 16-bit word and breaks it
-	down into the individual bytes and updates the single registers
-*/
-void convert_to_bytes(byte *reg1, byte *reg2, word *fullreg)
-{
-	word temp;
-	/* fullreg == mmmm-llll */
-
-	*reg1 = *fullreg >> 8;
-	/* reg1 == 0000-mmmm */
-
-	temp = *fullreg << 8;
-	/* temp == llll-0000 */
-
-	temp = temp >> 8;
-	/* temp == 0000-llll */
-
-	*reg2 = temp;
-}
-
-/*
-	Sometimes we need to use the paired 16-bit registers as addresses,
-	in order to do this within the program, we need to swap the
-	high and low bytes for addressing reasons
-*/
-word swap_byte_order(word *reg)
-{
-	/* reg == llll-mmmm */
-	word result = *reg << 8;
-	/* result == mmmm-0000 */
-
-	result += *reg >> 8;
-	/* result == mmmm-llll */
-
-	return result;
-}
-
 /*
 	This function will either take all the individual parts
 	of the F register struct and compile them into one byte
@@ -1197,7 +980,7 @@ word swap_byte_order(word *reg)
 	0: compile into a byte
 	1: decompile byte into variables
 */
-void compiler_F(byte direction)
+void compiler_F(struct gb_context *gb, byte direction)
 {
 	if(direction == 0)
 	{
@@ -1208,30 +991,15 @@ void compiler_F(byte direction)
 			H = 1
 			C = 1
 
-		F:
-			????-????
-		*/
-
-		F.F += F.Z;
-		/* F: ????-???1 */
-		F.F = F.F << 1;
-		/* F: ????-??10 */
-
-		F.F += F.N;
-		/* F: ????-??10 */
-		F.F = F.F << 1;
-		/* F: ????-?100 */
-
-		F.F += F.H;
-		/* F: ????-?101 */
-		F.F = F.F << 1;
-		/* F: ????-1010 */
+		F: 1011-0000
 
-		F.F += F.C;
-		/* F: ????-1011 */
+		C may hold the rotated out bit itself rather than 1,
+		so it's tested instead of shifted
+		*/
+		CPU_flags(gb);
 
-		F.F = F.F << 4;
-		/* F: 1011-0000 */
+		gb->AF.b.lo = (gb->F.Z << 7) | (gb->F.N << 6) | (gb->F.H << 5) |
+			((gb->F.C != 0) << 4);
 	}
 	else
 	{
@@ -1240,39 +1008,184 @@ void compiler_F(byte direction)
 
 			F: 1011-0000
 
-		This is basically done by shifting F.F over a
+		This is basically done by shifting the F byte over a
 		number of places and setting the individual
 		flags to whatever is in the right-most location
 		*/
 
-		F.Z = ((F.F >> 7) & 0x1);
+		gb->F.Z = ((gb->AF.b.lo >> 7) & 0x1);
 		/*
 			F.Z = 0000-0001
 			F.Z = ????-???^
 			F.Z = 0000-0001
 		*/
 
-		F.N = ((F.F >> 6) & 0x1);
+		gb->F.N = ((gb->AF.b.lo >> 6) & 0x1);
 		/*
 			F.N = 0000-0010
 			F.N = ????-???^
 			F.N = 0000-0000
 		*/
 
-		F.H = ((F.F >> 5) & 0x1);
+		gb->F.H = ((gb->AF.b.lo >> 5) & 0x1);
 		/*
 			F.H = 0000-0101
 			F.H = ????-???^
 			F.H = 0000-0001
 		*/
 
-		F.C = ((F.F >> 4) & 0x1);
+		gb->F.C = ((gb->AF.b.lo >> 4) & 0x1);
 		/*
 			F.C = 0000-1011
 			F.C = ????-???^
 			F.C = 0000-0001
 		*/
+
+		gb->flags.op = FLAGS_KNOWN;
+	}
+}
+
+/*
+	Work out the flags left behind by the last flag setting
+	operation and store them in F
+
+	Until this is called the members of F hold whatever the
+	flags were before that operation.
+*/
+void CPU_flags(struct gb_context *gb)
+{
+	switch(gb->flags.op)
+	{
+		case FLAGS_KNOWN:
+			return;
+
+		case FLAGS_ADD:
+		case FLAGS_ADD_A:
+			gb->F.Z = (gb->flags.result == 0);
+			gb->F.N = 0;
+
+			/*
+				ADD A, A reads A back once it's been
+				added to, so the carry comes from
+				doubling the operand and the half carry
+				from the result
+			*/
+			if(gb->flags.op == FLAGS_ADD)
+			{
+				gb->F.C = ((gb->flags.a + gb->flags.b) > 0xFF);
+				gb->F.H = (((gb->flags.a & 0xF) +
+					(gb->flags.b & 0xF)) > 0xF);
+			}
+			else
+			{
+				gb->F.C = ((gb->flags.b + gb->flags.b) > 0xFF);
+				gb->F.H = (((gb->flags.a & 0xF) +
+					(gb->flags.result & 0xF)) > 0xF);
+			}
+			break;
+
+		case FLAGS_SUB:
+			gb->F.Z = (gb->flags.result == 0);
+			gb->F.N = 1;
+			/* Borrow from bit 4 isn't tracked yet */
+			gb->F.H = 0;
+			gb->F.C = (gb->flags.a < gb->flags.b);
+			break;
+
+		case FLAGS_AND:
+			gb->F.Z = (gb->flags.result == 0);
+			gb->F.N = 0;
+			gb->F.H = 1;
+			gb->F.C = 0;
+			break;
+
+		case FLAGS_ZERO:
+			gb->F.Z = (gb->flags.result == 0);
+			gb->F.N = 0;
+			gb->F.H = 0;
+			gb->F.C = 0;
+			break;
+
+		case FLAGS_INC:
+			/* Carry from bit 3 leaves a lower nibble of 0 */
+			gb->F.Z = (gb->flags.result == 0);
+			gb->F.N = 0;
+			gb->F.H = ((gb->flags.result & 0xF) == 0);
+			gb->F.C = 0;
+			break;
+
+		case FLAGS_DEC:
+			/* Borrow from bit 4 leaves a lower nibble of F */
+			gb->F.Z = (gb->flags.result == 0);
+			gb->F.N = 1;
+			gb->F.H = ((gb->flags.result & 0xF) == 0xF);
+			gb->F.C = 0;
+			break;
+
+		case FLAGS_ADD_16:
+			gb->F.Z = 0;
+			gb->F.N = 0;
+			gb->F.H = (((gb->flags.a16 & 0xFFF) + gb->flags.b16)
+				> 0xFFF);
+			gb->F.C = ((gb->flags.a16 + gb->flags.b16) > 0xFFFF);
+			break;
+
+		case FLAGS_ADD_SP:
+			/* Worked out from the lower byte of the new SP */
+			gb->F.Z = 0;
+			gb->F.N = 0;
+			gb->F.H = (((gb->flags.a16 & 0xF) +
+				(gb->flags.b & 0xF)) > 0xF);
+			gb->F.C = (((gb->flags.a16 & 0xFF) + gb->flags.b)
+				> 0xFF);
+			break;
+
+		case FLAGS_ROTATE_LEFT:
+		case FLAGS_ROTATE_RIGHT:
+			/* Carry holds the bit that was rotated out */
+			gb->F.Z = (gb->flags.result == 0);
+			gb->F.N = 0;
+			gb->F.H = 0;
+
+			if(gb->flags.op == FLAGS_ROTATE_LEFT)
+				gb->F.C = gb->flags.a & 0x80;
+			else
+				gb->F.C = gb->flags.a & 0x01;
+			break;
 	}
+
+	gb->flags.op = FLAGS_KNOWN;
+}
+
+/*
+	Work out just the Zero flag, for the conditional jumps
+*/
+byte CPU_flag_Z(struct gb_context *gb)
+{
+	switch(gb->flags.op)
+	{
+		case FLAGS_KNOWN:
+			return gb->F.Z;
+
+		case FLAGS_ADD_16:
+		case FLAGS_ADD_SP:
+			return 0;
+
+		default:
+			return (gb->flags.result == 0);
+	}
+}
+
+/*
+	Carry flag, for the conditional jumps and the rotates through
+	Carry; Carry depends on the operation in most cases so all the
+	flags are brought up to date
+*/
+byte CPU_flag_C(struct gb_context *gb)
+{
+	CPU_flags(gb);
+
+	return gb->F.C;
 }
 
 /*
@@ -1385,38 +1298,35 @@ void setbit(byte *reg, byte bit)
 	operations, this function will clear the flag register state for
 	new use.
 */
-void CPU_clear_flags()
+void CPU_clear_flags(struct gb_context *gb)
 {
-	F.Z = 0;
-	F.N = 0;
-	F.C = 0;
-	F.H = 0;
+	gb->F.Z = 0;
+	gb->F.N = 0;
+	gb->F.C = 0;
+	gb->F.H = 0;
 
-	F.F = 0;
+	gb->AF.b.lo = 0;
+	gb->flags.op = FLAGS_KNOWN;
 }
 
 /*
 	Decrement Stack Pointer(TM) and write a byte to it
 */
-void SP_push(byte b)
+void SP_push(struct gb_context *gb, byte b)
 {
-	printf("DBG SP:ps B4DEC: %X; PC: %X; Data: %X\n", SP, PC, b);
-	SP--;
-	printf("DBG SP:ps AFDEC: %X; PC: %X; Data: %X\n", SP, PC, b);
+	gb->SP--;
+	TRACE4(TRACE_PUSH, (word)(gb->SP + 1), gb->SP, gb->PC, b);
 
-	memory_writeb(SP, b);
+	memory_writeb(gb, gb->SP, b);
 }
 
 /*
 	Assign passed byte to the latest item on the stack;
 	increment Stack Pointer
 */
-void SP_pop(byte *reg)
+void SP_pop(struct gb_context *gb, byte *reg)
 {
-	*reg = memory_readb(SP);
-	printf("DBG SP:pop Data: %X\n", *reg);
-
-	printf("DBG SP:pop B4INC: %X\n", SP, PC);
-	SP++;
-	printf("DBG SP:pop AFINC: %X\n", SP, PC);
+	*reg = memory_readb(gb, gb->SP);
+	gb->SP++;
+	TRACE3(TRACE_POP, (word)(gb->SP - 1), gb->SP, *reg);
 }
@@ -28,14 +28,36 @@
 #include "memory.h"
 
 /* REGISTERS */
-/* Declare the 8-bit CPU registers */
-byte A;
-byte B;
-byte C;
-byte D;
-byte E;
-byte H;
-byte L;
+
+/*
+	Hosts that don't identify themselves to the compiler as big
+	endian can be built with -DHOST_BIG_ENDIAN
+*/
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__)
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define HOST_BIG_ENDIAN
+#endif
+#endif
+
+/*
+	A register pair, used as the 16-bit word (w) or as its two 8-bit
+	registers (b.hi, b.lo) without any converting between the two.
+	The halves are laid out in the host's byte order so that both
+	views share the same storage.
+*/
+union reg_pair {
+	word w;
+
+	struct {
+#ifdef HOST_BIG_ENDIAN
+		byte hi;
+		byte lo;
+#else
+		byte lo;
+		byte hi;
+#endif
+	} b;
+};
 
 /* Flag register, implemented as struct */
 struct fREG {
@@ -55,95 +77,138 @@ struct fREG {
 	byte C;
 
 	/*
-		The flag(F) register is a byte that is comprised
-		of the previous flags in the upper half and zeros
-		in the lower: ZNHC-0000; this byte will be used
-		to store the compiled F register
+		The flag(F) register byte itself is comprised of
+		the previous flags in the upper half and zeros in
+		the lower: ZNHC-0000; it's compiled into AF.b.lo
 	*/
-	byte F;
-} F;
+};
 
-/* Declare the 16-bit CPU registers */
-word SP; /* Stack pointer */
-word PC; /* Program counter */
+/*
+	Lazy flags
+
+	The ALU helpers don't work out Z/N/H/C as they go, they record
+	what the last flag setting operation was along with what's
+	needed to work the flags out later. Most flags are overwritten
+	before anything looks at them. The members of F are only up to
+	date after CPU_flags(), CPU_flag_Z() works out just Z without
+	touching F.
+*/
+#define FLAGS_KNOWN		0	/* F is up to date */
+#define FLAGS_ADD		1	/* ADD/ADC */
+#define FLAGS_ADD_A		2	/* ADD/ADC A, A */
+#define FLAGS_SUB		3	/* SUB/SBC/CP */
+#define FLAGS_AND		4	/* AND */
+#define FLAGS_ZERO		5	/* OR/XOR/SWAP, only Z can be set */
+#define FLAGS_INC		6	/* 8-bit INC */
+#define FLAGS_DEC		7	/* 8-bit DEC */
+#define FLAGS_ADD_16		8	/* ADD HL, rr */
+#define FLAGS_ADD_SP		9	/* ADD SP, n */
+#define FLAGS_ROTATE_LEFT	10	/* left rotates of A */
+#define FLAGS_ROTATE_RIGHT	11	/* right rotates of A */
+
+struct lazy_flags {
+	/* One of the FLAGS_ values above */
+	byte op;
+
+	/* Operands going in and the result coming out */
+	byte a;
+	byte b;
+	byte result;
+
+	/* Operands of the 16-bit adds */
+	word a16;
+	word b16;
+};
 
 /* +++++ END REGISTERS +++++ */
 
 
+/* +++++ OPCODE TABLES +++++ */
 
-/* +++++++ EMULATION-RELATED VARIABLES +++++++ */
-
-/* Hold the number of cycles an instruction takes to execute */
-int cycles;
-/* Used as a total number of cycles for use in timing */
-int total_cycles;
-/* Hold the maximum number of cycles between Vsyncs */
-int max_cycles;
-/* Master interupt enable switch */
-byte ie;
-/*
-	The enable/disable instructions are silly gooses and
-	don't actually set or reset until after the instruction
-	following them. This variable will be used to emulate
-	this function. I would like this comment to be just a
-	little bit longer. This should satisfy my want.
-*/
-byte interrupt_step;
 /*
-	Note whether interrupts will be disabled (0) or enabled (1)
-	after interrupt step is zeroed
+	An entry in the opcode tables, the handler does the work of
+	the instruction while the length and cycles are applied by
+	the dispatcher
 */
-byte interrupt_direction;
+struct opcode {
+	/* Handler for the instruction, NULL if not implemented */
+	void (*execute)(struct gb_context*);
+
+	/* Size of the instruction in bytes, opcode included */
+	byte length;
+
+	/*
+		Number of cycles the instruction takes, for conditional
+		calls, returns and jumps when the condition fails. The
+		handler adds the *_TAKEN_CYCLES below when it's taken.
+	*/
+	byte cycles;
+};
+
+#define CALL_TAKEN_CYCLES 12
+#define JUMP_TAKEN_CYCLES 4
+
+/* Base instruction set, indexed by opcode */
+extern const struct opcode CPU_opcodes[256];
+/* CB prefixed instruction set, indexed by the byte after CB */
+extern const struct opcode CPU_extended_opcodes[256];
+
+/* +++++ END OPCODE TABLES +++++ */
 
 
 
 /* ++++ FUNCTIONS ++++ */
 
-void CPU_reset();
-int CPU(word);
-int CPU_EXTENDED(word);
+void CPU_reset(struct gb_context*);
+void CPU_tick(struct gb_context*);
+int CPU(struct gb_context*, word);
+int CPU_EXTENDED(struct gb_context*, word);
+long CPU_run(struct gb_context*);
+
+/* Name of the dispatch loop CPU_run was built with */
+extern const char CPU_dispatch_mode[];
 
 /* ++++ JUMP ++++ */
-byte CPU_jump(byte, word, byte);
+byte CPU_jump(struct gb_context*, byte, word, byte);
 
 /* ++++ LOADS ++++ */
 
 /* 8-BIT LOADS */
-void CPU_load_immediate(byte*);
+void CPU_load_immediate(struct gb_context*, byte*);
 void CPU_load_register(byte*, byte*);
-void CPU_load_address(byte*, word, byte);
+void CPU_load_address(struct gb_context*, byte*, word, byte);
 
 /* 16-BIT LOADS */
-void CPU_load_immediate16(byte*, byte*);
-void CPU_load_sp_16(byte*, byte*);
-void CPU_load_16_sp(byte*, byte*);
+void CPU_load_immediate16(struct gb_context*, word*);
+void CPU_load_sp_16(struct gb_context*, word);
+void CPU_load_16_sp(struct gb_context*, word*);
 
 /* ++++ ALU ++++ */
 
 /* 8-BIT ALU */
-void CPU_add_8(byte*, byte);
-void CPU_subtract_8(byte*, byte);
-void CPU_and_8(byte*);
-void CPU_or_8(byte*);
-void CPU_xor_8(byte*);
-void CPU_compare_8(byte*);
-void CPU_incdec_8(byte*, byte);
+void CPU_add_8(struct gb_context*, byte*, byte);
+void CPU_subtract_8(struct gb_context*, byte*, byte);
+void CPU_and_8(struct gb_context*, byte*);
+void CPU_or_8(struct gb_context*, byte*);
+void CPU_xor_8(struct gb_context*, byte*);
+void CPU_compare_8(struct gb_context*, byte*);
+void CPU_incdec_8(struct gb_context*, byte*, byte);
 
 /* 16-BIT ALU */
-void CPU_add_16(byte*, byte*, byte*, byte*);
-void CPU_add_sp_n(byte);
-void CPU_incdec_16(byte*, byte*, byte);
+void CPU_add_16(struct gb_context*, word*, word);
+void CPU_add_sp_n(struct gb_context*, byte);
+void CPU_incdec_16(word*, byte);
 
 /* ++++ END ALU ++++ */
 
 /* CALLS, RESTARTS, AND RETURNS */
-void CPU_call();
-void CPU_restart(byte);
-void CPU_return();
+void CPU_call(struct gb_context*);
+void CPU_restart(struct gb_context*, byte);
+void CPU_return(struct gb_context*);
 
 /* ROTATES AND SHIFTS */
-void CPU_rotate(byte*, byte);
-void CPU_rotate_through(byte*, byte);
+void CPU_rotate(struct gb_context*, byte*, byte);
+void CPU_rotate_through(struct gb_context*, byte*, byte);
 
 /* EXTENDED */
 void CPU_bit(byte, byte*);
@@ -152,27 +217,28 @@ void CPU_res(byte, byte*);
 
 /* MISC */
 void CPU_decimal_adjust();
-void CPU_swap(byte*);
+void CPU_swap(struct gb_context*, byte*);
 void CPU_compliment(byte*);
 
 /* ++++++ INTERRUPT RELATED FUNCTIONS ++++++ */
-void CPU_interrupt_switch();
-void CPU_check_interrupts();
-void CPU_service_interrupt(byte);
-void CPU_request_interrupt(byte);
+void CPU_interrupt_switch(struct gb_context*);
+void CPU_interrupt_event(struct gb_context*, long);
+void CPU_check_interrupts(struct gb_context*);
+void CPU_service_interrupt(struct gb_context*, byte);
+void CPU_request_interrupt(struct gb_context*, byte);
 
 /* ++++ CPU HELPER FUNCTIONS ++++ */
-word convert_to16m(word, word);
-void convert_to_pair(byte*, byte*, word*);
-void convert_to_bytes(byte*, byte*, word*);
-word swap_byte_order(word*);
-void compiler_F(byte);
+word convert_to16m(struct gb_context*, word, word);
+void compiler_F(struct gb_context*, byte);
+void CPU_flags(struct gb_context*);
+byte CPU_flag_Z(struct gb_context*);
+byte CPU_flag_C(struct gb_context*);
 byte bitset(byte*, byte);
 void setbit(byte*, byte);
 
-void CPU_clear_flags();
+void CPU_clear_flags(struct gb_context*);
 
-void SP_push(byte);
-void SP_pop(byte*);
+void SP_push(struct gb_context*, byte);
+void SP_pop(struct gb_context*, byte*);
 
 #endif
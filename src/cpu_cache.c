@@ -0,0 +1,247 @@
+/*
+	Copyright 2012, 2013 Charles O.
+	Email: charles.0x4f@gmail.com
+	Github: https://github.com/charles-0x4f/
+
+	This file is part of TermGB.
+
+	TermGB is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	TermGB is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with TermGB.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+	Decoded basic block cache
+
+	Running code out of the cache skips fetching and decoding each
+	instruction through the opcode tables every time it is run.
+	Blocks are kept in a direct mapped table indexed by the start
+	address and are keyed on the start address and ROM bank.
+
+	Every byte covered by a block is counted in cache_marks, when
+	memory_writeb hits a marked byte the blocks covering it are
+	dropped, so code that writes over itself keeps working.
+*/
+
+#include <string.h>
+#include "gb.h"
+#include "cpu_cache.h"
+#include "cpu.h"
+
+
+/*
+	The bank mapped at an address, so blocks decoded from one bank
+	aren't run once another is switched in
+*/
+static word CACHE_bank(struct gb_context *gb, word address)
+{
+	if(address <= 0x3FFF)
+		return gb->rom_bank0;
+	if(address <= 0x7FFF)
+		return gb->rom_bank;
+	if(address >= 0xA000 && address <= 0xBFFF)
+		return gb->ram_bank;
+
+	return 0;
+}
+
+/*
+	Returns 1 if the opcode can change PC, which ends a block
+*/
+static byte CACHE_ends_block(struct gb_context *gb, byte op)
+{
+	switch(op)
+	{
+		/* JR */
+		case 0x18: case 0x20: case 0x28: case 0x30: case 0x38:
+		/* JP */
+		case 0xC2: case 0xC3: case 0xCA: case 0xD2: case 0xDA:
+		case 0xE9:
+		/* CALL */
+		case 0xC4: case 0xCC: case 0xCD: case 0xD4: case 0xDC:
+		/* RET */
+		case 0xC0: case 0xC8: case 0xC9: case 0xD0: case 0xD8:
+		case 0xD9:
+		/* RST */
+		case 0xC7: case 0xCF: case 0xD7: case 0xDF:
+		case 0xE7: case 0xEF: case 0xF7: case 0xFF:
+			return 1;
+	}
+
+	return 0;
+}
+
+/* Remove a block from the cache and unmark its code */
+static void CACHE_drop(struct gb_context *gb, struct cached_block *block)
+{
+	word address;
+
+	block->valid = 0;
+	block->native = NULL;
+
+	for(address = block->start; address != block->end; address++)
+		gb->cache_marks[address]--;
+}
+
+/*
+	Decode the instructions starting at address into block
+
+	Returns 0 if nothing could be decoded; the caller should run
+	the instruction through CPU() instead.
+*/
+static byte CACHE_build(struct gb_context *gb, struct cached_block *block,
+	word address)
+{
+	const struct opcode *entry;
+	struct cached_instruction *instruction;
+	word pc = address;
+	byte op, length;
+
+	/*
+		Echo RAM, OAM and I/O registers are never run from the
+		cache. Writes to WRAM would have to invalidate blocks
+		decoded through its echo as well.
+	*/
+	if(address >= 0xE000 && address < 0xFF80)
+		return 0;
+
+	block->count = 0;
+	block->cycles = 0;
+	block->runs = 0;
+	block->native = NULL;
+	block->native_count = 0;
+	block->native_cycles = 0;
+
+	while(block->count < CACHE_BLOCK_INSTRUCTIONS)
+	{
+		op = memory_readb(gb, pc);
+
+		if(op == 0xCB)
+		{
+			entry = &CPU_extended_opcodes[memory_readb(gb, pc + 1)];
+			length = 2;
+		}
+		else
+		{
+			entry = &CPU_opcodes[op];
+			length = entry->length;
+		}
+
+		/* Stop before anything the tables don't handle */
+		if(entry->execute == NULL)
+			break;
+
+		/*
+			Keep the block within its size limit and within
+			one 8KB region, so the whole block comes from a
+			single ROM or RAM bank (and stays out of echo RAM)
+		*/
+		if((word)(pc - address) + length > CACHE_BLOCK_BYTES)
+			break;
+		if((address >> 13) != ((long)pc + length - 1) >> 13)
+			break;
+
+		instruction = &block->instructions[block->count];
+		instruction->execute = entry->execute;
+		instruction->opcode = op;
+		instruction->length = length;
+		instruction->cycles = entry->cycles;
+		instruction->operand8 = 0;
+		instruction->operand16 = 0;
+
+		if(length > 1 && op != 0xCB)
+			instruction->operand8 = memory_readb(gb, pc + 1);
+		if(length > 2)
+			instruction->operand16 =
+				convert_to16m(gb, pc + 1, pc + 2);
+
+		block->count++;
+		block->cycles += entry->cycles;
+		pc += length;
+
+		if(CACHE_ends_block(gb, op))
+			break;
+	}
+
+	if(block->count == 0)
+		return 0;
+
+	block->start = address;
+	block->end = pc;
+	block->bank = CACHE_bank(gb, address);
+	block->valid = 1;
+
+	for(address = block->start; address != block->end; address++)
+		gb->cache_marks[address]++;
+
+	return 1;
+}
+
+/* Drop every block from the cache */
+void CACHE_flush(struct gb_context *gb)
+{
+	memset(gb->cache, 0, sizeof(gb->cache));
+	memset(gb->cache_marks, 0, sizeof(gb->cache_marks));
+}
+
+/*
+	Return the block that starts at address, decoding it first if it
+	isn't cached yet. Returns NULL if there's nothing to cache there.
+*/
+struct cached_block *CACHE_get_block(struct gb_context *gb, word address)
+{
+	struct cached_block *block = &gb->cache[address & (CACHE_SIZE - 1)];
+
+	/*
+		While OAM DMA has the bus, fetches from anywhere but HRAM
+		read 0xFF, leave that to CPU()
+	*/
+	if(gb->dma_active)
+		return NULL;
+
+	if(block->valid && block->start == address &&
+		block->bank == CACHE_bank(gb, address))
+		return block;
+
+	/* Evict whatever held the slot before */
+	if(block->valid)
+		CACHE_drop(gb, block);
+
+	if(!CACHE_build(gb, block, address))
+		return NULL;
+
+	return block;
+}
+
+/*
+	Drop every block covering address
+
+	A block covering address must start at most CACHE_BLOCK_BYTES - 1
+	bytes before it, so only the slots for those start addresses need
+	to be checked.
+*/
+void CACHE_invalidate(struct gb_context *gb, word address)
+{
+	struct cached_block *block;
+	word start;
+	int x;
+
+	for(x = 0; x < CACHE_BLOCK_BYTES; x++)
+	{
+		start = address - x;
+		block = &gb->cache[start & (CACHE_SIZE - 1)];
+
+		if(block->valid && (word)(address - block->start) <
+			(word)(block->end - block->start))
+			CACHE_drop(gb, block);
+	}
+}
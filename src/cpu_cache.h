@@ -0,0 +1,94 @@
+/*
+	Copyright 2012, 2013 Charles O.
+	Email: charles.0x4f@gmail.com
+	Github: https://github.com/charles-0x4f/
+
+	This file is part of TermGB.
+
+	TermGB is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	TermGB is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with TermGB.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* cpu_cache.h */
+
+#ifndef CPU_CACHE_H
+#define CPU_CACHE_H
+
+#include "memory.h"
+
+/* Number of blocks the cache can hold, must be a power of two */
+#define CACHE_SIZE 4096
+/* Most instructions a single block will hold */
+#define CACHE_BLOCK_INSTRUCTIONS 32
+/* Most bytes of code a single block will cover */
+#define CACHE_BLOCK_BYTES 64
+
+/* An instruction that has already been fetched and decoded */
+struct cached_instruction {
+	/* Handler from the opcode tables */
+	void (*execute)(struct gb_context*);
+
+	/* The opcode byte, 0xCB for the extended instructions */
+	byte opcode;
+
+	/* Operands, as CPU() would have fetched them */
+	byte operand8;
+	word operand16;
+
+	/* Length in bytes (CB prefix included) and cycles */
+	byte length;
+	byte cycles;
+};
+
+/*
+	A basic block: a run of instructions that ends at the first
+	one that can change PC, or when the block is full
+*/
+struct cached_block {
+	/* Address range of the code, end is one past the last byte */
+	word start;
+	word end;
+
+	/* ROM or RAM bank the code was decoded from */
+	word bank;
+
+	/* Cleared when the code underneath is written to */
+	byte valid;
+
+	/* Number of instructions and total cycles if all of them run */
+	byte count;
+	int cycles;
+
+	/* Number of times the block has been run */
+	int runs;
+
+	/*
+		Native translation of the first native_count instructions,
+		NULL until the JIT has compiled the block
+	*/
+	void (*native)();
+	byte native_count;
+	int native_cycles;
+
+	struct cached_instruction instructions[CACHE_BLOCK_INSTRUCTIONS];
+};
+
+
+/* Drop every block from the cache */
+void CACHE_flush(struct gb_context*);
+/* Return the block starting at address, decoding it if needed */
+struct cached_block *CACHE_get_block(struct gb_context*, word);
+/* Drop any block covering address */
+void CACHE_invalidate(struct gb_context*, word);
+
+#endif
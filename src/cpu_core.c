@@ -20,4557 +20,4351 @@
 */
 
 /*
-	Contains the main CPU core/jumptable to unclutter CPU function
-	definitions.
+	Contains the main CPU core to unclutter CPU function definitions.
+
+	Every base opcode has a handler function below, and the handlers
+	are collected into the CPU_opcodes table along with the length and
+	cycle count of each instruction. CPU() uses the table to fetch the
+	operands, advance PC and set cycles, so the handlers themselves only
+	do the work of the instruction.
 
 	i.e. int CPU(word)
 */
 
 #include <stdio.h>
+#include "gb.h"
 #include "cpu.h"
+#include "cpu_cache.h"
+#include "cpu_jit.h"
+#include "trace.h"
 
 
 /* The main GBZ80 emulation core, all descriptions and op information
 	taken from the Gameboy CPU Manual:
 	marc.rawer.de/Gameboy/Docs/GBCPUman.pdf
 */
-int CPU(word op)
-{
-	int result = 0;
-
-	switch(op)
-	{
-	case 0xCB:
-	{
-		/*
-		CB -
-
-		Description:
-		The Gameboy has an extended instruction set prefixed
-		by CB. Here we will increment PC and call CPU_EXTENDED
-		to handle the additional jump table
-		*/
-		PC++;
-
-		result = CPU_EXTENDED(memory_readb(PC));
-		break;
-	}
-	case 0x00:
-	{
-		/*
-		NOP
-
-		Description:
-		No operation.
-		*/
-		PC++;
-		cycles = 4;
-		break;
-	}
-
-	
-
-		/* ++++++ LOADS ++++++ */
 
-		/* 8-BIT IMMEDIATE LOADS */
-	case 0x06:
-	{
-		/*
-		LD B, n
-
-		Description:
-		Put value n into register B
-
-		Use with:
-		n = immediate 8-bit value
-		*/
-		CPU_load_immediate(&B);
-		cycles = 8;
-		break;
-	}
-	case 0x0E:
-	{
-		/*
-		LD C, n
-
-		Description:
-		Put value n into register C
-
-		Use with:
-		n = immediate 8-bit value
-		*/
-		CPU_load_immediate(&C);
-		cycles = 8;
-		break;
-	}
-	case 0x16:
-	{
-		/*
-		LD D, n
-
-		Description:
-		Put value n into register D
-
-		Use with:
-		n = immediate 8-bit value
-		*/
-		CPU_load_immediate(&D);
-		cycles = 8;
-		break;
-	}
-	case 0x1E:
-	{
-		/*
-		LD E, n
-
-		Description:
-		Put value n into register E
-
-		Use with:
-		n = immediate 8-bit value
-		*/
-		CPU_load_immediate(&E);
-		cycles = 8;
-		break;
-	}
-	case 0x26:
-	{
-		/*
-		LD H, n
-
-		Description:
-		Put value n into register H
-
-		Use with:
-		n = immediate 8-bit value
-		*/
-		CPU_load_immediate(&H);
-		cycles = 8;
-		break;
-	}
-	case 0x2E:
-	{
-		/*
-		LD L, n
+/*
+	NOP
 
-		Description:
-		Put value n into register L
+	Description:
+	No operation.
+*/
+static void op_00(struct gb_context *gb)
+{
+}
 
-		Use with:
-		n = immediate 8-bit value
-		*/
-		CPU_load_immediate(&L);
-		cycles = 8;
-		break;
-	}
+/* ++++++ LOADS ++++++ */
 
-		/* 8-BIT LOAD REGISTER/ADDRESS */
-	case 0x7F:
-	{
-		/*
-		LD A, A
+/* 8-BIT IMMEDIATE LOADS */
 
-		Description:
-		Put value of A into register A
-		*/
-		CPU_load_register(&A, &A);
-		cycles = 4;
-		break;
-	}
-	case 0x78:
-	{
-		/*
-		LD A, B
-
-		Description:
-		Put value of B into register A
-		*/
-		CPU_load_register(&A, &B);
-		cycles = 4;
-		break;
-	}
-	case 0x79:
-	{
-		/*
-		LD A, C
+/*
+	LD B, n
 
-		Description:
-		Put value of C into register A
-		*/
-		CPU_load_register(&A, &C);
-		cycles = 4;
-		break;
-	}
-	case 0x7A:
-	{
-		/*
-		LD A, D
+	Description:
+	Put value n into register B
 
-		Description:
-		Put value of D into register A
-		*/
-		CPU_load_register(&A, &D);
-		cycles = 4;
-		break;
-	}
-	case 0x7B:
-	{
-		/*
-		LD A, E
+	Use with:
+	n = immediate 8-bit value
+*/
+static void op_06(struct gb_context *gb)
+{
+	CPU_load_immediate(gb, &gb->BC.b.hi);
+}
 
-		Description:
-		Put value of E into register A
-		*/
-		CPU_load_register(&A, &E);
-		cycles = 4;
-		break;
-	}
-	case 0x7C:
-	{
-		/*
-		LD A, H
+/*
+	LD C, n
 
-		Description:
-		Put value of H into register A
-		*/
-		CPU_load_register(&A, &H);
-		cycles = 4;
-		break;
-	}
-	case 0x7D:
-	{
-		/*
-		LD A, L
+	Description:
+	Put value n into register C
 
-		Description:
-		Put value of L into register A
-		*/
-		CPU_load_register(&A, &L);
-		cycles = 4;
-		break;
-	}
-	case 0x0A:
-	{
-		/*
-		LD A, (BC)
+	Use with:
+	n = immediate 8-bit value
+*/
+static void op_0E(struct gb_context *gb)
+{
+	CPU_load_immediate(gb, &gb->BC.b.lo);
+}
 
-		Description:
-		Put value pointed to by BC into register A
-		*/
-		word address;
+/*
+	LD D, n
 
-		convert_to_pair(&B, &C, &address);
-		/*address = swap_byte_order(&address);*/
+	Description:
+	Put value n into register D
 
-		CPU_load_address(&A, address, 0);
-		cycles = 8;
-		break;
-	}
-	case 0x1A:
-	{
-		/*
-		LD A, (DE)
+	Use with:
+	n = immediate 8-bit value
+*/
+static void op_16(struct gb_context *gb)
+{
+	CPU_load_immediate(gb, &gb->DE.b.hi);
+}
 
-		Description:
-		Put value pointed to by DE into register A
-		*/
-		word address;
+/*
+	LD E, n
 
-		convert_to_pair(&D, &E, &address);
-		/*address = swap_byte_order(&address);*/
+	Description:
+	Put value n into register E
 
-		CPU_load_address(&A, address, 0);
-		cycles = 8;
-		break;
-	}
-	case 0x7E:
-	{
-		/*
-		LD A, (HL)
+	Use with:
+	n = immediate 8-bit value
+*/
+static void op_1E(struct gb_context *gb)
+{
+	CPU_load_immediate(gb, &gb->DE.b.lo);
+}
 
-		Description:
-		Put value pointed to by HL into register A
-		*/
-		word address;
+/*
+	LD H, n
 
-		convert_to_pair(&H, &L, &address);
-		/*address = swap_byte_order(&address);*/
+	Description:
+	Put value n into register H
 
-		CPU_load_address(&A, address, 0);
-		cycles = 8;
-		break;
-	}
-	case 0xFA:
-	{
-		/*
-		LD A, (nn)
+	Use with:
+	n = immediate 8-bit value
+*/
+static void op_26(struct gb_context *gb)
+{
+	CPU_load_immediate(gb, &gb->HL.b.hi);
+}
 
-		Description:
-		Put value pointed to by two byte immediate 
-		address(LSB first) into register A
-		*/
-		word address = memory_readw(PC+1);
+/*
+	LD L, n
 
-		address = swap_byte_order(&address);
+	Description:
+	Put value n into register L
 
-		CPU_load_address(&A, address, 0);
-		
-		PC += 2;
-		cycles = 16;
-		break;
-	}
-	case 0x3E:
-	{
-		/*
-		LD A, #
+	Use with:
+	n = immediate 8-bit value
+*/
+static void op_2E(struct gb_context *gb)
+{
+	CPU_load_immediate(gb, &gb->HL.b.lo);
+}
 
-		Description:
-		Put immediate byte into register A
-		*/
-		byte immediate = memory_readb(PC+1);
+/* 8-BIT LOAD REGISTER/ADDRESS */
 
-		CPU_load_register(&A, &immediate);
+/*
+	LD A, A
 
-		PC++;
-		cycles = 8;
-		break;
-	}
-	case 0x47:
-	{
-		/*
-		LD B, A
+	Description:
+	Put value of A into register A
+*/
+static void op_7F(struct gb_context *gb)
+{
+	CPU_load_register(&gb->AF.b.hi, &gb->AF.b.hi);
+}
 
-		Description:
-		Put value of A into register B
-		*/
-		CPU_load_register(&B, &A);
-		cycles = 4;
-		break;
-	}
-	case 0x40:
-	{
-		/*
-		LD B, B
+/*
+	LD A, B
 
-		Description:
-		Put value of B into register B
-		*/
-		CPU_load_register(&B, &B);
-		cycles = 4;
-		break;
-	}
-	case 0x41:
-	{
-		/*
-		LD B, C
+	Description:
+	Put value of B into register A
+*/
+static void op_78(struct gb_context *gb)
+{
+	CPU_load_register(&gb->AF.b.hi, &gb->BC.b.hi);
+}
 
-		Description:
-		Put value of C into register B
-		*/
-		CPU_load_register(&B, &C);
-		cycles = 4;
-		break;
-	}
-	case 0x42:
-	{
-		/*
-		LD B, D
+/*
+	LD A, C
 
-		Description:
-		Put value of D into register B
-		*/
-		CPU_load_register(&B, &D);
-		cycles = 4;
-		break;
-	}
-	case 0x43:
-	{
-		/*
-		LD B, E
+	Description:
+	Put value of C into register A
+*/
+static void op_79(struct gb_context *gb)
+{
+	CPU_load_register(&gb->AF.b.hi, &gb->BC.b.lo);
+}
 
-		Description:
-		Put value of E into register B
-		*/
-		CPU_load_register(&B, &E);
-		cycles = 4;
-		break;
-	}
-	case 0x44:
-	{
-		/*
-		LD B, H
+/*
+	LD A, D
 
-		Description:
-		Put value of H into register B
-		*/
-		CPU_load_register(&B, &H);
-		cycles = 4;
-		break;
-	}
-	case 0x45:
-	{
-		/*
-		LD B, L
+	Description:
+	Put value of D into register A
+*/
+static void op_7A(struct gb_context *gb)
+{
+	CPU_load_register(&gb->AF.b.hi, &gb->DE.b.hi);
+}
 
-		Description:
-		Put value of L into register B
-		*/
-		CPU_load_register(&B, &L);
-		cycles = 4;
-		break;
-	}
-	case 0x46:
-	{
-		/*
-		LD B, (HL)
+/*
+	LD A, E
 
-		Description:
-		Put value pointed to by HL into register B
-		*/
-		word address;
+	Description:
+	Put value of E into register A
+*/
+static void op_7B(struct gb_context *gb)
+{
+	CPU_load_register(&gb->AF.b.hi, &gb->DE.b.lo);
+}
 
-		convert_to_pair(&H, &L, &address);
-		/*address = swap_byte_order(&address);*/
+/*
+	LD A, H
 
-		CPU_load_address(&B, address, 0);
-		cycles = 8;
-		break;
-	}
-	case 0x4F:
-	{
-		/*
-		LD C, A
+	Description:
+	Put value of H into register A
+*/
+static void op_7C(struct gb_context *gb)
+{
+	CPU_load_register(&gb->AF.b.hi, &gb->HL.b.hi);
+}
 
-		Description:
-		Put value of A into register C
-		*/
-		CPU_load_register(&C, &A);
-		cycles = 4;
-		break;
-	}
-	case 0x48:
-	{
-		/*
-		LD C, B
+/*
+	LD A, L
 
-		Description:
-		Put value of B into register C
-		*/
-		CPU_load_register(&C, &B);
-		cycles = 4;
-		break;
-	}
-	case 0x49:
-	{
-		/*
-		LD C, C
+	Description:
+	Put value of L into register A
+*/
+static void op_7D(struct gb_context *gb)
+{
+	CPU_load_register(&gb->AF.b.hi, &gb->HL.b.lo);
+}
 
-		Description:
-		Put value of C into register C
-		*/
-		CPU_load_register(&C, &C);
-		cycles = 4;
-		break;
-	}
-	case 0x4A:
-	{
-		/*
-		LD C, D
+/*
+	LD A, (BC)
 
-		Description:
-		Put value of D into register C
-		*/
-		CPU_load_register(&C, &D);
-		cycles = 4;
-		break;
-	}
-	case 0x4B:
-	{
-		/*
-		LD C, E
+	Description:
+	Put value pointed to by BC into register A
+*/
+static void op_0A(struct gb_context *gb)
+{
+	word address;
 
-		Description:
-		Put value of E into register C
-		*/
-		CPU_load_register(&C, &E);
-		cycles = 4;
-		break;
-	}
-	case 0x4C:
-	{
-		/*
-		LD C, H
+	address = gb->BC.w;
 
-		Description:
-		Put value of H into register C
-		*/
-		CPU_load_register(&C, &H);
-		cycles = 4;
-		break;
-	}
-	case 0x4D:
-	{
-		/*
-		LD C, L
+	CPU_load_address(gb, &gb->AF.b.hi, address, 0);
+}
 
-		Description:
-		Put value of L into register C
-		*/
-		CPU_load_register(&C, &L);
-		cycles = 4;
-		break;
-	}
-	case 0x4E:
-	{
-		/*
-		LD C, (HL)
+/*
+	LD A, (DE)
 
-		Description:
-		Put value pointed to by HL into register C
-		*/
-		word address;
+	Description:
+	Put value pointed to by DE into register A
+*/
+static void op_1A(struct gb_context *gb)
+{
+	word address;
 
-		convert_to_pair(&H, &L, &address);
-		/*address = swap_byte_order(&address);*/
+	address = gb->DE.w;
 
-		CPU_load_address(&C, address, 0);
-		cycles = 8;
-		break;
-	}
-	case 0x57:
-	{
-		/*
-		LD D, A
+	CPU_load_address(gb, &gb->AF.b.hi, address, 0);
+}
 
-		Description:
-		Put value of A into register D
-		*/
-		CPU_load_register(&D, &A);
-		cycles = 4;
-		break;
-	}
-	case 0x50:
-	{
-		/*
-		LD D, B
+/*
+	LD A, (HL)
 
-		Description:
-		Put value of B into register D
-		*/
-		CPU_load_register(&D, &B);
-		cycles = 4;
-		break;
-	}
-	case 0x51:
-	{
-		/*
-		LD D, C
+	Description:
+	Put value pointed to by HL into register A
+*/
+static void op_7E(struct gb_context *gb)
+{
+	word address;
 
-		Description:
-		Put value of C into register D
-		*/
-		CPU_load_register(&D, &C);
-		cycles = 4;
-		break;
-	}
-	case 0x52:
-	{
-		/*
-		LD D, D
+	address = gb->HL.w;
 
-		Description:
-		Put value of D into register D
-		*/
-		CPU_load_register(&D, &D);
-		cycles = 4;
-		break;
-	}
-	case 0x53:
-	{
-		/*
-		LD D, E
+	CPU_load_address(gb, &gb->AF.b.hi, address, 0);
+}
 
-		Description:
-		Put value of E into register D
-		*/
-		CPU_load_register(&D, &E);
-		cycles = 4;
-		break;
-	}
-	case 0x54:
-	{
-		/*
-		LD D, H
+/*
+	LD A, (nn)
 
-		Description:
-		Put value of H into register D
-		*/
-		CPU_load_register(&D, &H);
-		cycles = 4;
-		break;
-	}
-	case 0x55:
-	{
-		/*
-		LD D, L
+	Description:
+	Put value pointed to by two byte immediate
+	address(LSB first) into register A
+*/
+static void op_FA(struct gb_context *gb)
+{
+	CPU_load_address(gb, &gb->AF.b.hi, gb->operand16, 0);
+}
 
-		Description:
-		Put value of L into register D
-		*/
-		CPU_load_register(&D, &L);
-		cycles = 4;
-		break;
-	}
-	case 0x56:
-	{
-		/*
-		LD D, (HL)
+/*
+	LD A, #
 
-		Description:
-		Put value pointed to by HL into register D
-		*/
-		word address;
+	Description:
+	Put immediate byte into register A
+*/
+static void op_3E(struct gb_context *gb)
+{
+	CPU_load_immediate(gb, &gb->AF.b.hi);
+}
 
-		convert_to_pair(&H, &L, &address);
-		/*address = swap_byte_order(&address);*/
+/*
+	LD B, A
 
-		CPU_load_address(&D, address, 0);
-		cycles = 8;
-		break;
-	}
-	case 0x5F:
-	{
-		/*
-		LD E, A
+	Description:
+	Put value of A into register B
+*/
+static void op_47(struct gb_context *gb)
+{
+	CPU_load_register(&gb->BC.b.hi, &gb->AF.b.hi);
+}
 
-		Description:
-		Put value of A into register E
-		*/
-		CPU_load_register(&E, &A);
-		cycles = 4;
-		break;
-	}
-	case 0x58:
-	{
-		/*
-		LD E, B
+/*
+	LD B, B
 
-		Description:
-		Put value of B into register E
-		*/
-		CPU_load_register(&E, &B);
-		cycles = 4;
-		break;
-	}
-	case 0x59:
-	{
-		/*
-		LD E, C
+	Description:
+	Put value of B into register B
+*/
+static void op_40(struct gb_context *gb)
+{
+	CPU_load_register(&gb->BC.b.hi, &gb->BC.b.hi);
+}
 
-		Description:
-		Put value of C into register E
-		*/
-		CPU_load_register(&E, &C);
-		cycles = 4;
-		break;
-	}
-	case 0x5A:
-	{
-		/*
-		LD E, D
+/*
+	LD B, C
 
-		Description:
-		Put value of D into register E
-		*/
-		CPU_load_register(&E, &D);
-		cycles = 4;
-		break;
-	}
-	case 0x5B:
-	{
-		/*
-		LD E, E
+	Description:
+	Put value of C into register B
+*/
+static void op_41(struct gb_context *gb)
+{
+	CPU_load_register(&gb->BC.b.hi, &gb->BC.b.lo);
+}
 
-		Description:
-		Put value of E into register E
-		*/
-		CPU_load_register(&E, &E);
-		cycles = 4;
-		break;
-	}
-	case 0x5C:
-	{
-		/*
-		LD E, H
+/*
+	LD B, D
 
-		Description:
-		Put value of H into register E
-		*/
-		CPU_load_register(&E, &H);
-		cycles = 4;
-		break;
-	}
-	case 0x5D:
-	{
-		/*
-		LD E, L
+	Description:
+	Put value of D into register B
+*/
+static void op_42(struct gb_context *gb)
+{
+	CPU_load_register(&gb->BC.b.hi, &gb->DE.b.hi);
+}
 
-		Description:
-		Put value of L into register E
-		*/
-		CPU_load_register(&E, &L);
-		cycles = 4;
-		break;
-	}
-	case 0x5E:
-	{
-		/*
-		LD E, (HL)
+/*
+	LD B, E
 
-		Description:
-		Put value pointed to by HL into register E
-		*/
-		word address;
+	Description:
+	Put value of E into register B
+*/
+static void op_43(struct gb_context *gb)
+{
+	CPU_load_register(&gb->BC.b.hi, &gb->DE.b.lo);
+}
 
-		convert_to_pair(&H, &L, &address);
-		/*address = swap_byte_order(&address);*/
+/*
+	LD B, H
 
-		CPU_load_address(&E, address, 0);
-		cycles = 8;
-		break;
-	}
-	case 0x67:
-	{
-		/*
-		LD H, A
+	Description:
+	Put value of H into register B
+*/
+static void op_44(struct gb_context *gb)
+{
+	CPU_load_register(&gb->BC.b.hi, &gb->HL.b.hi);
+}
 
-		Description:
-		Put value of A into register H
-		*/
-		CPU_load_register(&H, &A);
-		cycles = 4;
-		break;
-	}
-	case 0x60:
-	{
-		/*
-		LD H, B
+/*
+	LD B, L
 
-		Description:
-		Put value of B into register H
-		*/
-		CPU_load_register(&H, &B);
-		cycles = 4;
-		break;
-	}
-	case 0x61:
-	{
-		/*
-		LD H, C
+	Description:
+	Put value of L into register B
+*/
+static void op_45(struct gb_context *gb)
+{
+	CPU_load_register(&gb->BC.b.hi, &gb->HL.b.lo);
+}
 
-		Description:
-		Put value of C into register H
-		*/
-		CPU_load_register(&H, &C);
-		cycles = 4;
-		break;
-	}
-	case 0x62:
-	{
-		/*
-		LD H, D
+/*
+	LD B, (HL)
 
-		Description:
-		Put value of D into register H
-		*/
-		CPU_load_register(&H, &D);
-		cycles = 4;
-		break;
-	}
-	case 0x63:
-	{
-		/*
-		LD H, E
+	Description:
+	Put value pointed to by HL into register B
+*/
+static void op_46(struct gb_context *gb)
+{
+	word address;
 
-		Description:
-		Put value of E into register H
-		*/
-		CPU_load_register(&H, &E);
-		cycles = 4;
-		break;
-	}
-	case 0x64:
-	{
-		/*
-		LD H, H
+	address = gb->HL.w;
 
-		Description:
-		Put value of H into register H
-		*/
-		CPU_load_register(&H, &H);
-		cycles = 4;
-		break;
-	}
-	case 0x65:
-	{
-		/*
-		LD H, L
+	CPU_load_address(gb, &gb->BC.b.hi, address, 0);
+}
 
-		Description:
-		Put value of L into register H
-		*/
-		CPU_load_register(&H, &L);
-		cycles = 4;
-		break;
-	}
-	case 0x66:
-	{
-		/*
-		LD H, (HL)
+/*
+	LD C, A
 
-		Description:
-		Put value pointed to by HL into register H
-		*/
-		word address;
+	Description:
+	Put value of A into register C
+*/
+static void op_4F(struct gb_context *gb)
+{
+	CPU_load_register(&gb->BC.b.lo, &gb->AF.b.hi);
+}
 
-		convert_to_pair(&H, &L, &address);
-		/*address = swap_byte_order(&address);*/
+/*
+	LD C, B
 
-		CPU_load_address(&H, address, 0);
-		cycles = 8;
-		break;
-	}
-	case 0x6F:
-	{
-		/*
-		LD L, A
+	Description:
+	Put value of B into register C
+*/
+static void op_48(struct gb_context *gb)
+{
+	CPU_load_register(&gb->BC.b.lo, &gb->BC.b.hi);
+}
 
-		Description:
-		Put value of A into register L
-		*/
-		CPU_load_register(&L, &A);
-		cycles = 4;
-		break;
-	}
-	case 0x68:
-	{
-		/*
-		LD L, B
+/*
+	LD C, C
 
-		Description:
-		Put value of B into register L
-		*/
-		CPU_load_register(&L, &B);
-		cycles = 4;
-		break;
-	}
-	case 0x69:
-	{
-		/*
-		LD L, C
+	Description:
+	Put value of C into register C
+*/
+static void op_49(struct gb_context *gb)
+{
+	CPU_load_register(&gb->BC.b.lo, &gb->BC.b.lo);
+}
 
-		Description:
-		Put value of C into register L
-		*/
-		CPU_load_register(&L, &C);
-		cycles = 4;
-		break;
-	}
-	case 0x6A:
-	{
-		/*
-		LD L, D
+/*
+	LD C, D
 
-		Description:
-		Put value of D into register L
-		*/
-		CPU_load_register(&L, &D);
-		cycles = 4;
-		break;
-	}
-	case 0x6B:
-	{
-		/*
-		LD L, E
+	Description:
+	Put value of D into register C
+*/
+static void op_4A(struct gb_context *gb)
+{
+	CPU_load_register(&gb->BC.b.lo, &gb->DE.b.hi);
+}
 
-		Description:
-		Put value of E into register L
-		*/
-		CPU_load_register(&L, &E);
-		cycles = 4;
-		break;
-	}
-	case 0x6C:
-	{
-		/*
-		LD L, H
+/*
+	LD C, E
 
-		Description:
-		Put value of H into register L
-		*/
-		CPU_load_register(&L, &H);
-		cycles = 4;
-		break;
-	}
-	case 0x6D:
-	{
-		/*
-		LD L, L
+	Description:
+	Put value of E into register C
+*/
+static void op_4B(struct gb_context *gb)
+{
+	CPU_load_register(&gb->BC.b.lo, &gb->DE.b.lo);
+}
 
-		Description:
-		Put value of L into register L
-		*/
-		CPU_load_register(&L, &L);
-		cycles = 4;
-		break;
-	}
-	case 0x6E:
-	{
-		/*
-		LD L, (HL)
+/*
+	LD C, H
 
-		Description:
-		Put value pointed to by HL into register L
-		*/
-		word address;
+	Description:
+	Put value of H into register C
+*/
+static void op_4C(struct gb_context *gb)
+{
+	CPU_load_register(&gb->BC.b.lo, &gb->HL.b.hi);
+}
 
-		convert_to_pair(&H, &L, &address);
-		/*address = swap_byte_order(&address);*/
+/*
+	LD C, L
 
-		CPU_load_address(&L, address, 0);
-		cycles = 8;
-		break;
-	}
-	case 0x70:
-	{
-		/*
-		LD (HL), B
+	Description:
+	Put value of L into register C
+*/
+static void op_4D(struct gb_context *gb)
+{
+	CPU_load_register(&gb->BC.b.lo, &gb->HL.b.lo);
+}
 
-		Description:
-		Put value of B into the location pointed to by HL
-		*/
-		word address;
+/*
+	LD C, (HL)
 
-		/*TODO remove all swap byte orders in loads? */
-		convert_to_pair(&H, &L, &address);
-		/*address = swap_byte_order(&address);*/
+	Description:
+	Put value pointed to by HL into register C
+*/
+static void op_4E(struct gb_context *gb)
+{
+	word address;
 
-		CPU_load_address(&B, address, 1);
-		cycles = 8;
-		break;
-	}
-	case 0x71:
-	{
-		/*
-		LD (HL), C
+	address = gb->HL.w;
 
-		Description:
-		Put value of C into the location pointed to by HL
-		*/
-		word address;
+	CPU_load_address(gb, &gb->BC.b.lo, address, 0);
+}
 
-		convert_to_pair(&H, &L, &address);
-		/*address = swap_byte_order(&address);*/
+/*
+	LD D, A
 
-		CPU_load_address(&C, address, 1);
-		cycles = 8;
-		break;
-	}
-	case 0x72:
-	{
-		/*
-		LD (HL), D
+	Description:
+	Put value of A into register D
+*/
+static void op_57(struct gb_context *gb)
+{
+	CPU_load_register(&gb->DE.b.hi, &gb->AF.b.hi);
+}
 
-		Description:
-		Put value of D into the location pointed to by HL
-		*/
-		word address;
+/*
+	LD D, B
 
-		convert_to_pair(&H, &L, &address);
-		/*address = swap_byte_order(&address);*/
+	Description:
+	Put value of B into register D
+*/
+static void op_50(struct gb_context *gb)
+{
+	CPU_load_register(&gb->DE.b.hi, &gb->BC.b.hi);
+}
 
-		CPU_load_address(&D, address, 1);
-		cycles = 8;
-		break;
-	}
-	case 0x73:
-	{
-		/*
-		LD (HL), E
+/*
+	LD D, C
 
-		Description:
-		Put value of E into the location pointed to by HL
-		*/
-		word address;
+	Description:
+	Put value of C into register D
+*/
+static void op_51(struct gb_context *gb)
+{
+	CPU_load_register(&gb->DE.b.hi, &gb->BC.b.lo);
+}
 
-		convert_to_pair(&H, &L, &address);
-		/*address = swap_byte_order(&address);*/
+/*
+	LD D, D
 
-		CPU_load_address(&E, address, 1);
-		cycles = 8;
-		break;
-	}
-	case 0x74:
-	{
-		/*
-		LD (HL), H
+	Description:
+	Put value of D into register D
+*/
+static void op_52(struct gb_context *gb)
+{
+	CPU_load_register(&gb->DE.b.hi, &gb->DE.b.hi);
+}
 
-		Description:
-		Put value of H into the location pointed to by HL
-		*/
-		word address;
+/*
+	LD D, E
 
-		convert_to_pair(&H, &L, &address);
-		/*address = swap_byte_order(&address);*/
+	Description:
+	Put value of E into register D
+*/
+static void op_53(struct gb_context *gb)
+{
+	CPU_load_register(&gb->DE.b.hi, &gb->DE.b.lo);
+}
 
-		CPU_load_address(&H, address, 1);
-		cycles = 8;
-		break;
-	}
-	case 0x75:
-	{
-		/*
-		LD (HL), L
+/*
+	LD D, H
 
-		Description:
-		Put value of L into the location pointed to by HL
-		*/
-		word address;
+	Description:
+	Put value of H into register D
+*/
+static void op_54(struct gb_context *gb)
+{
+	CPU_load_register(&gb->DE.b.hi, &gb->HL.b.hi);
+}
 
-		convert_to_pair(&H, &L, &address);
-		/*address = swap_byte_order(&address);*/
+/*
+	LD D, L
 
-		CPU_load_address(&L, address, 1);
-		cycles = 8;
-		break;
-	}
-	case 0x36:
-	{
-		/*
-		LD (HL), n
+	Description:
+	Put value of L into register D
+*/
+static void op_55(struct gb_context *gb)
+{
+	CPU_load_register(&gb->DE.b.hi, &gb->HL.b.lo);
+}
 
-		Description:
-		Put value of n into the location pointed to by HL
+/*
+	LD D, (HL)
 
-		Use with:
-		n - one byte immediate value
-		*/
-		byte immediate;
-		word address;
+	Description:
+	Put value pointed to by HL into register D
+*/
+static void op_56(struct gb_context *gb)
+{
+	word address;
 
-		immediate = memory_readb(PC + 1);
+	address = gb->HL.w;
 
-		convert_to_pair(&H, &L, &address);
-		/*address = swap_byte_order(&address);*/
+	CPU_load_address(gb, &gb->DE.b.hi, address, 0);
+}
 
-		CPU_load_address(&B, address, 1);
-		cycles = 12;
+/*
+	LD E, A
 
-		/* Increment once more, the jump function does the other */
-		PC++;
+	Description:
+	Put value of A into register E
+*/
+static void op_5F(struct gb_context *gb)
+{
+	CPU_load_register(&gb->DE.b.lo, &gb->AF.b.hi);
+}
 
-		break;
-	}
-	case 0x02:
-	{
-		/*
-		LD (BC), A
+/*
+	LD E, B
 
-		Description:
-		Load the value of A into the location pointed to by BC
-		*/
-		word address;
+	Description:
+	Put value of B into register E
+*/
+static void op_58(struct gb_context *gb)
+{
+	CPU_load_register(&gb->DE.b.lo, &gb->BC.b.hi);
+}
 
-		convert_to_pair(&B, &C, &address);
-		/*address = swap_byte_order(&address);*/
+/*
+	LD E, C
 
-		CPU_load_address(&A, address, 1);
-		cycles = 8;
-		break;
-	}
-	case 0x12:
-	{
-		/*
-		LD (DE), A
+	Description:
+	Put value of C into register E
+*/
+static void op_59(struct gb_context *gb)
+{
+	CPU_load_register(&gb->DE.b.lo, &gb->BC.b.lo);
+}
 
-		Description:
-		Load the value of A into the location pointed to by DE
-		*/
-		word address;
+/*
+	LD E, D
+
+	Description:
+	Put value of D into register E
+*/
+static void op_5A(struct gb_context *gb)
+{
+	CPU_load_register(&gb->DE.b.lo, &gb->DE.b.hi);
+}
 
-		convert_to_pair(&D, &E, &address);
-		/*address = swap_byte_order(&address);*/
+/*
+	LD E, E
 
-		CPU_load_address(&A, address, 1);
-		cycles = 8;
-		break;
-	}
-	case 0x77:
-	{
-		/*
-		LD (HL), A
+	Description:
+	Put value of E into register E
+*/
+static void op_5B(struct gb_context *gb)
+{
+	CPU_load_register(&gb->DE.b.lo, &gb->DE.b.lo);
+}
 
-		Description:
-		Load the value of A into the location pointed to by HL
-		*/
-		word address;
+/*
+	LD E, H
 
-		convert_to_pair(&H, &L, &address);
-		/*address = swap_byte_order(&address);*/
+	Description:
+	Put value of H into register E
+*/
+static void op_5C(struct gb_context *gb)
+{
+	CPU_load_register(&gb->DE.b.lo, &gb->HL.b.hi);
+}
 
-		CPU_load_address(&A, address, 1);
-		cycles = 8;
-		break;
-	}
-	case 0xEA:
-	{
-		/*
-		LD (nn), A
+/*
+	LD E, L
 
-		Description:
-		Load the value of A into the location pointed to by nn
+	Description:
+	Put value of L into register E
+*/
+static void op_5D(struct gb_context *gb)
+{
+	CPU_load_register(&gb->DE.b.lo, &gb->HL.b.lo);
+}
 
-		Use with:
-		nn = two byte immediate value. (LS byte first.)
-		*/
-		word address;
+/*
+	LD E, (HL)
 
-		address = convert_to16m(PC+1, PC+2);
+	Description:
+	Put value pointed to by HL into register E
+*/
+static void op_5E(struct gb_context *gb)
+{
+	word address;
 
-		CPU_load_address(&A, address, 1);
+	address = gb->HL.w;
 
-		PC += 2;
-		cycles = 16;
-		break;
-	}
-	case 0xF2:
-	{
-		/*
-		LD A, (C) /
-		LD A, (0xFF00 + C)
+	CPU_load_address(gb, &gb->DE.b.lo, address, 0);
+}
 
-		Description:
-		Load the value at address FF00 + C into register A
-		*/
-		CPU_load_address(&A, (0xFF00+C), 0);
-		cycles = 8;
-		break;
-	}
-	case 0xE2:
-	{
-		/*
-		LD (C), A /
-		LD (0xFF00 + C), A
+/*
+	LD H, A
 
-		Description:
-		Load A into the value at address FF00 + C
-		*/
-		CPU_load_address(&A, (0xFF00+C), 1);
-		cycles = 8;
-		break;
-	}
-	case 0x3A:
-	{
-		/*
-		LDD A, (HL)
+	Description:
+	Put value of A into register H
+*/
+static void op_67(struct gb_context *gb)
+{
+	CPU_load_register(&gb->HL.b.hi, &gb->AF.b.hi);
+}
 
-		Description:
-		Put value at address HL into A; decrement HL
-		*/
-		word address;
+/*
+	LD H, B
 
-		convert_to_pair(&H, &L, &address);
-		/*address = swap_byte_order(&address);*/
-		CPU_load_address(&A, address, 0);
-		
-		address--;
+	Description:
+	Put value of B into register H
+*/
+static void op_60(struct gb_context *gb)
+{
+	CPU_load_register(&gb->HL.b.hi, &gb->BC.b.hi);
+}
 
-		/* Update decremented HL's registers */
-		convert_to_bytes(&H, &L, &address);
+/*
+	LD H, C
 
-		cycles = 8;
-		break;
-	}
-	case 0x32:
-	{
-		/*
-		LDD (HL), A
+	Description:
+	Put value of C into register H
+*/
+static void op_61(struct gb_context *gb)
+{
+	CPU_load_register(&gb->HL.b.hi, &gb->BC.b.lo);
+}
 
-		Description:
-		Put value of A into data at address HL; decrement HL
-		*/
-		word address;
+/*
+	LD H, D
 
-		convert_to_pair(&H, &L, &address);
-		/*address = swap_byte_order(&address);*/
-		CPU_load_address(&A, address, 1);
-		
-		address--;
+	Description:
+	Put value of D into register H
+*/
+static void op_62(struct gb_context *gb)
+{
+	CPU_load_register(&gb->HL.b.hi, &gb->DE.b.hi);
+}
 
-		/* Update decremented HL's registers */
-		convert_to_bytes(&H, &L, &address);
+/*
+	LD H, E
 
-		cycles = 8;
-		break;
-	}
-	case 0x2A:
-	{
-		/*
-		LDI A, (HL)
+	Description:
+	Put value of E into register H
+*/
+static void op_63(struct gb_context *gb)
+{
+	CPU_load_register(&gb->HL.b.hi, &gb->DE.b.lo);
+}
 
-		Description:
-		Put value at address HL into A; increment HL
-		*/
-		word address;
+/*
+	LD H, H
 
-		convert_to_pair(&H, &L, &address);
+	Description:
+	Put value of H into register H
+*/
+static void op_64(struct gb_context *gb)
+{
+	CPU_load_register(&gb->HL.b.hi, &gb->HL.b.hi);
+}
 
-		printf("DBG 2A; Address from HL: %X\n", address);
+/*
+	LD H, L
 
-		/* TODO why is swap_byte_order using pointer and return?*/
-		/*address = swap_byte_order(&address);*/
-		printf("DBG 2A; Address swap: %X\n", address);
-		/* TODO switch cpu_load_address to use pointers */
-		CPU_load_address(&A, address, 0);
-		
-		/* Revert address back to low-endian for non-addressing work */
-		/*address = swap_byte_order(&address);*/
-		address++;
+	Description:
+	Put value of L into register H
+*/
+static void op_65(struct gb_context *gb)
+{
+	CPU_load_register(&gb->HL.b.hi, &gb->HL.b.lo);
+}
 
-		/* Update H and L with the incremented pair */
-		convert_to_bytes(&H, &L, &address);
+/*
+	LD H, (HL)
 
-		cycles = 8;
-		break;
-	}
-	case 0x22:
-	{
-		/*
-		LDI (HL), A
+	Description:
+	Put value pointed to by HL into register H
+*/
+static void op_66(struct gb_context *gb)
+{
+	word address;
 
-		Description:
-		Put value of A into data at address HL; increment HL
-		*/
-		word address;
+	address = gb->HL.w;
 
-		convert_to_pair(&H, &L, &address);
-		address = swap_byte_order(&address);
-		CPU_load_address(&A, address, 1);
+	CPU_load_address(gb, &gb->HL.b.hi, address, 0);
+}
 
-		/* Revert address back to low-endian for non-addressing work */
-		address = swap_byte_order(&address);
-		address++;
+/*
+	LD L, A
 
-		/* Update H and L with the incremented pair */
-		convert_to_bytes(&H, &L, &address);
+	Description:
+	Put value of A into register L
+*/
+static void op_6F(struct gb_context *gb)
+{
+	CPU_load_register(&gb->HL.b.lo, &gb->AF.b.hi);
+}
 
-		cycles = 8;
-		break;
-	}
-	case 0xE0:
-	{
-		/*
-		LDH (0xFF00+n), A
+/*
+	LD L, B
 
-		Description:
-		Load A into the address of 0xFF00 + n
+	Description:
+	Put value of B into register L
+*/
+static void op_68(struct gb_context *gb)
+{
+	CPU_load_register(&gb->HL.b.lo, &gb->BC.b.hi);
+}
 
-		Use With:
-		n = one byte immediate value
-		*/
-		word address = 0xFF00;
+/*
+	LD L, C
 
-		address += memory_readb(PC + 1);
-		CPU_load_address(&A, address, 1);
-		PC++;
+	Description:
+	Put value of C into register L
+*/
+static void op_69(struct gb_context *gb)
+{
+	CPU_load_register(&gb->HL.b.lo, &gb->BC.b.lo);
+}
 
-		cycles = 12;
-		break;
-	}
-	case 0xF0:
-	{
-		/*
-		LDH A, (0xFF00+n)
+/*
+	LD L, D
 
-		Description:
-		Load data at address (0xFF00 + n) into A
+	Description:
+	Put value of D into register L
+*/
+static void op_6A(struct gb_context *gb)
+{
+	CPU_load_register(&gb->HL.b.lo, &gb->DE.b.hi);
+}
 
-		Use With:
-		n = one byte immediate value
-		*/
-		word address = 0xFF00;
+/*
+	LD L, E
 
-		address += memory_readb(PC + 1);
-		CPU_load_address(&A, address, 0);
-		PC++;
+	Description:
+	Put value of E into register L
+*/
+static void op_6B(struct gb_context *gb)
+{
+	CPU_load_register(&gb->HL.b.lo, &gb->DE.b.lo);
+}
 
-		cycles = 12;
-		break;
-	}
+/*
+	LD L, H
 
-		/* ++++ 16-BIT LOADS ++++ */
+	Description:
+	Put value of H into register L
+*/
+static void op_6C(struct gb_context *gb)
+{
+	CPU_load_register(&gb->HL.b.lo, &gb->HL.b.hi);
+}
 
-	case 0x01:
-	{
-		/*
-		LD n, nn
+/*
+	LD L, L
 
-		Description:
-		Put immediate 16-bit value into n
+	Description:
+	Put value of L into register L
+*/
+static void op_6D(struct gb_context *gb)
+{
+	CPU_load_register(&gb->HL.b.lo, &gb->HL.b.lo);
+}
 
-		Use With:
-		n = BC
-		*/
-		CPU_load_immediate16(&B, &C);
+/*
+	LD L, (HL)
 
-		cycles = 12;
-		break;
-	}
-	case 0x11:
-	{
-		/*
-		LD n, nn
+	Description:
+	Put value pointed to by HL into register L
+*/
+static void op_6E(struct gb_context *gb)
+{
+	word address;
 
-		Description:
-		Put immediate 16-bit value into n
+	address = gb->HL.w;
 
-		Use With:
-		n = DE
-		*/
-		CPU_load_immediate16(&D, &E);
+	CPU_load_address(gb, &gb->HL.b.lo, address, 0);
+}
 
-		cycles = 12;
-		break;
-	}
-	case 0x21:
-	{
-		/*
-		LD n, nn
+/*
+	LD (HL), B
 
-		Description:
-		Put immediate 16-bit value into n
+	Description:
+	Put value of B into the location pointed to by HL
+*/
+static void op_70(struct gb_context *gb)
+{
+	word address;
 
-		Use With:
-		n = HL
-		*/
-		CPU_load_immediate16(&H, &L);
+	/*TODO remove all swap byte orders in loads? */
+	address = gb->HL.w;
 
-		cycles = 12;
-		break;
-	}
-	case 0x31:
-	{
-		/*
-		LD n, nn
+	CPU_load_address(gb, &gb->BC.b.hi, address, 1);
+}
 
-		Description:
-		Put immediate 16-bit value into n
+/*
+	LD (HL), C
 
-		Use With:
-		n = SP
-		*/
-		/* old: TODO delete? */
-		/*byte a, b;
+	Description:
+	Put value of C into the location pointed to by HL
+*/
+static void op_71(struct gb_context *gb)
+{
+	word address;
 
-		a = memory_readb(PC+1);
-		b = memory_readb(PC+2);
+	address = gb->HL.w;
 
-		CPU_load_sp_16(&a, &b);*/
-		byte low, high;
-		word address;
+	CPU_load_address(gb, &gb->BC.b.lo, address, 1);
+}
 
-		/* Read immediate bytes and convert to a word */
-		low = memory_readb(PC+1);
-		high = memory_readb(PC+2);
-		convert_to_pair(&high, &low, &address);
+/*
+	LD (HL), D
 
-		/* Assign SP to the new address */
-		SP = address;
+	Description:
+	Put value of D into the location pointed to by HL
+*/
+static void op_72(struct gb_context *gb)
+{
+	word address;
 
-		PC += 3;
+	address = gb->HL.w;
 
-		cycles = 12;
-		break;
-	}
-	case 0xF9:
-	{
-		/*
-		LD SP, HL
+	CPU_load_address(gb, &gb->DE.b.hi, address, 1);
+}
 
-		Description:
-		Load HL onto the stack
-		*/
-		CPU_load_sp_16(&H, &L);
+/*
+	LD (HL), E
 
-		PC++;
+	Description:
+	Put value of E into the location pointed to by HL
+*/
+static void op_73(struct gb_context *gb)
+{
+	word address;
 
-		cycles = 8;
-		break;
-	}
-	case 0xF8:
-	{
-		/*
-		LDHL SP, n
+	address = gb->HL.w;
 
-		Description:
-		Put SP + n effective address into HL
+	CPU_load_address(gb, &gb->DE.b.lo, address, 1);
+}
 
-		Use with:
-		n = one byte signed immediate value
+/*
+	LD (HL), H
 
-		Flags:
-		Z - Reset
-		N - Reset
-		H - Set if necessary
-		C - Set if necessary
-		*/
-		byte n;
-		/* Make a backup copy of SP */
-		word original = SP;
+	Description:
+	Put value of H into the location pointed to by HL
+*/
+static void op_74(struct gb_context *gb)
+{
+	word address;
 
-		/* Get immediate value */
-		n = memory_readb(PC+1);
+	address = gb->HL.w;
 
-		/* Add n to SP */
-		CPU_add_sp_n(n);
+	CPU_load_address(gb, &gb->HL.b.hi, address, 1);
+}
 
-		/* Update HL with result in SP */
-		convert_to_bytes(&H, &L, &SP);
+/*
+	LD (HL), L
 
-		/*
-			Reinstate SP since we just want the
-			result in HL and not in SP
-		*/
-		SP = original;
+	Description:
+	Put value of L into the location pointed to by HL
+*/
+static void op_75(struct gb_context *gb)
+{
+	word address;
 
-		PC += 2;
+	address = gb->HL.w;
 
-		cycles = 12;
-		break;
-	}
-	case 0x08:
-	{
-		/*
-		LD (nn), SP
+	CPU_load_address(gb, &gb->HL.b.lo, address, 1);
+}
 
-		Description:
-		Put Stack Pointer(tm) at address n
+/*
+	LD (HL), n
 
-		Use with:
-		nn = two byte immediate address
-		*/
-		SP = memory_readw(PC+1);
+	Description:
+	Put value of n into the location pointed to by HL
 
-		PC += 3;
+	Use with:
+	n - one byte immediate value
+*/
+static void op_36(struct gb_context *gb)
+{
+	word address;
 
-		cycles = 20;
-		break;
-	}
-	case 0xF5:
-	{
-		/*
-		PUSH nn
+	address = gb->HL.w;
 
-		Description:
-		Push register pair AF onto stack
-		*/
+	CPU_load_address(gb, &gb->operand8, address, 1);
+}
 
-		/* Compile F struct into a byte for use */
-		compiler_F(0);
+/*
+	LD (BC), A
 
-		/* Push A and F register onto the stack */
-		CPU_load_sp_16(&A, &F.F);
+	Description:
+	Load the value of A into the location pointed to by BC
+*/
+static void op_02(struct gb_context *gb)
+{
+	word address;
 
-		cycles = 16;
-		PC++;
-		break;
-	}
-	case 0xC5:
-	{
-		/*
-		PUSH nn
+	address = gb->BC.w;
 
-		Description:
-		Push register pair BC onto stack
-		*/
+	CPU_load_address(gb, &gb->AF.b.hi, address, 1);
+}
 
-		/* Push B and C register onto the stack */
-		CPU_load_sp_16(&B, &C);
+/*
+	LD (DE), A
 
-		cycles = 16;
-		PC++;
-		break;
-	}
-	case 0xD5:
-	{
-		/*
-		PUSH nn
+	Description:
+	Load the value of A into the location pointed to by DE
+*/
+static void op_12(struct gb_context *gb)
+{
+	word address;
 
-		Description:
-		Push register pair DE onto stack
-		*/
+	address = gb->DE.w;
 
-		/* Push D and E register onto the stack */
-		CPU_load_sp_16(&D, &E);
+	CPU_load_address(gb, &gb->AF.b.hi, address, 1);
+}
 
-		cycles = 16;
-		PC++;
-		break;
-	}
-	case 0xE5:
-	{
-		/*
-		PUSH nn
+/*
+	LD (HL), A
 
-		Description:
-		Push register pair HL onto stack
-		*/
+	Description:
+	Load the value of A into the location pointed to by HL
+*/
+static void op_77(struct gb_context *gb)
+{
+	word address;
 
-		/* Push H and L register onto the stack */
-		CPU_load_sp_16(&H, &L);
+	address = gb->HL.w;
 
-		cycles = 16;
-		PC++;
-		break;
-	}
-	case 0xF1:
-	{
-		/*
-		POP nn
+	CPU_load_address(gb, &gb->AF.b.hi, address, 1);
+}
 
-		Description:
-		Pop two bytes off of stack into pair AF
-		*/
+/*
+	LD (nn), A
 
-		/*
-			Pop AF data from the stack, since these
-			were pushed onto the stack in order, they
-			must be retrieved backwards
-		*/
-		CPU_load_16_sp(&F.F, &A);
+	Description:
+	Load the value of A into the location pointed to by nn
+
+	Use with:
+	nn = two byte immediate value. (LS byte first.)
+*/
+static void op_EA(struct gb_context *gb)
+{
+	CPU_load_address(gb, &gb->AF.b.hi, gb->operand16, 1);
+}
 
-		/* Rebuild F flag variables from the assembled byte */
-		compiler_F(1);
+/*
+	LD A, (C) /
+	LD A, (0xFF00 + C)
 
-		PC++;
+	Description:
+	Load the value at address FF00 + C into register A
+*/
+static void op_F2(struct gb_context *gb)
+{
+	CPU_load_address(gb, &gb->AF.b.hi, (0xFF00+gb->BC.b.lo), 0);
+}
 
-		cycles = 12;
-		break;
-	}
-	case 0xC1:
-	{
-		/*
-		POP nn
+/*
+	LD (C), A /
+	LD (0xFF00 + C), A
 
-		Description:
-		Pop two bytes off of stack into pair BC
-		*/
+	Description:
+	Load A into the value at address FF00 + C
+*/
+static void op_E2(struct gb_context *gb)
+{
+	CPU_load_address(gb, &gb->AF.b.hi, (0xFF00+gb->BC.b.lo), 1);
+}
 
-		/*
-			Pop BC data from the stack, since these
-			were pushed onto the stack in order, they
-			must be retrieved backwards
-		*/
-		CPU_load_16_sp(&C, &B);
+/*
+	LDD A, (HL)
 
-		PC++;
+	Description:
+	Put value at address HL into A; decrement HL
+*/
+static void op_3A(struct gb_context *gb)
+{
+	word address;
 
-		cycles = 12;
-		break;
-	}
-	case 0xD1:
-	{
-		/*
-		POP nn
+	address = gb->HL.w;
+	CPU_load_address(gb, &gb->AF.b.hi, address, 0);
 
-		Description:
-		Pop two bytes off of stack into pair DE
-		*/
+	address--;
 
-		/*
-			Pop DE data from the stack, since these
-			were pushed onto the stack in order, they
-			must be retrieved backwards
-		*/
-		CPU_load_16_sp(&E, &D);
+	/* Update decremented HL's registers */
+	gb->HL.w = address;
+}
 
-		PC++;
+/*
+	LDD (HL), A
 
-		cycles = 12;
-		break;
-	}
-	case 0xE1:
-	{
-		/*
-		POP nn
+	Description:
+	Put value of A into data at address HL; decrement HL
+*/
+static void op_32(struct gb_context *gb)
+{
+	word address;
 
-		Description:
-		Pop two bytes off of stack into pair HL
-		*/
+	address = gb->HL.w;
+	CPU_load_address(gb, &gb->AF.b.hi, address, 1);
 
-		/*
-			Pop HL data from the stack, since these
-			were pushed onto the stack in order, they
-			must be retrieved backwards
-		*/
-		CPU_load_16_sp(&L, &H);
+	address--;
 
-		PC++;
+	/* Update decremented HL's registers */
+	gb->HL.w = address;
+}
 
-		cycles = 12;
-		break;
-	}
+/*
+	LDI A, (HL)
 
+	Description:
+	Put value at address HL into A; increment HL
+*/
+static void op_2A(struct gb_context *gb)
+{
+	word address;
 
-		/* ++++++ 8-BIT ALU ++++++ */
+	address = gb->HL.w;
 
-	case 0x87:
-	{
-		/*
-		ADD A, A
+	TRACE1(TRACE_LDI_HL, address);
 
-		Description:
-		Add A to A and leave result in A(insert meme)
+	/* TODO switch cpu_load_address to use pointers */
+	CPU_load_address(gb, &gb->AF.b.hi, address, 0);
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Set if carry from bit 3
-		C - Set if carry from bit 7
-		*/
-		CPU_add_8(&A, 0);
+	address++;
 
-		PC++;
+	/* Update H and L with the incremented pair */
+	gb->HL.w = address;
+}
 
-		cycles = 4;
-		break;
-	}
-	case 0x80:
-	{
-		/*
-		ADD A, B
+/*
+	LDI (HL), A
 
-		Description:
-		Add B to A and leave result in A
+	Description:
+	Put value of A into data at address HL; increment HL
+*/
+static void op_22(struct gb_context *gb)
+{
+	word address;
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Set if carry from bit 3
-		C - Set if carry from bit 7
-		*/
-		CPU_add_8(&B, 0);
+	address = gb->HL.w;
+	CPU_load_address(gb, &gb->AF.b.hi, address, 1);
 
-		PC++;
+	address++;
 
-		cycles = 4;
-		break;
-	}
-	case 0x81:
-	{
-		/*
-		ADD A, C
+	/* Update H and L with the incremented pair */
+	gb->HL.w = address;
+}
 
-		Description:
-		Add C to A and leave result in A
+/*
+	LDH (0xFF00+n), A
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Set if carry from bit 3
-		C - Set if carry from bit 7
-		*/
-		CPU_add_8(&C, 0);
+	Description:
+	Load A into the address of 0xFF00 + n
 
-		PC++;
+	Use With:
+	n = one byte immediate value
+*/
+static void op_E0(struct gb_context *gb)
+{
+	word address = 0xFF00;
 
-		cycles = 4;
-		break;
-	}
-	case 0x82:
-	{
-		/*
-		ADD A, D
+	address += gb->operand8;
+	CPU_load_address(gb, &gb->AF.b.hi, address, 1);
+}
 
-		Description:
-		Add D to A and leave result in A
+/*
+	LDH A, (0xFF00+n)
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Set if carry from bit 3
-		C - Set if carry from bit 7
-		*/
-		CPU_add_8(&D, 0);
+	Description:
+	Load data at address (0xFF00 + n) into A
 
-		PC++;
+	Use With:
+	n = one byte immediate value
+*/
+static void op_F0(struct gb_context *gb)
+{
+	word address = 0xFF00;
 
-		cycles = 4;
-		break;
-	}
-	case 0x83:
-	{
-		/*
-		ADD A, E
+	address += gb->operand8;
+	CPU_load_address(gb, &gb->AF.b.hi, address, 0);
+}
 
-		Description:
-		Add E to A and leave result in A
+/* ++++ 16-BIT LOADS ++++ */
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Set if carry from bit 3
-		C - Set if carry from bit 7
-		*/
-		CPU_add_8(&E, 0);
+/*
+	LD n, nn
 
-		PC++;
+	Description:
+	Put immediate 16-bit value into n
 
-		cycles = 4;
-		break;
-	}
-	case 0x84:
-	{
-		/*
-		ADD A, H
+	Use With:
+	n = BC
+*/
+static void op_01(struct gb_context *gb)
+{
+	CPU_load_immediate16(gb, &gb->BC.w);
+}
 
-		Description:
-		Add H to A and leave result in A
+/*
+	LD n, nn
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Set if carry from bit 3
-		C - Set if carry from bit 7
-		*/
-		CPU_add_8(&H, 0);
+	Description:
+	Put immediate 16-bit value into n
 
-		PC++;
+	Use With:
+	n = DE
+*/
+static void op_11(struct gb_context *gb)
+{
+	CPU_load_immediate16(gb, &gb->DE.w);
+}
 
-		cycles = 4;
-		break;
-	}
-	case 0x85:
-	{
-		/*
-		ADD A, L
+/*
+	LD n, nn
 
-		Description:
-		Add L to A and leave result in A
+	Description:
+	Put immediate 16-bit value into n
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Set if carry from bit 3
-		C - Set if carry from bit 7
-		*/
-		CPU_add_8(&L, 0);
+	Use With:
+	n = HL
+*/
+static void op_21(struct gb_context *gb)
+{
+	CPU_load_immediate16(gb, &gb->HL.w);
+}
 
-		PC++;
+/*
+	LD n, nn
 
-		cycles = 4;
-		break;
-	}
-	case 0x86:
-	{
-		/*
-		ADD A, (HL)
+	Description:
+	Put immediate 16-bit value into n
 
-		Description:
-		Add value pointed to by HL to A and leave result in A
+	Use With:
+	n = SP
+*/
+static void op_31(struct gb_context *gb)
+{
+	/* Assign SP to the immediate address */
+	gb->SP = gb->operand16;
+}
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Set if carry from bit 3
-		C - Set if carry from bit 7
-		*/
-		byte toAdd;
-		word address;
+/*
+	LD SP, HL
 
-		convert_to_pair(&H, &L, &address);
-		toAdd = memory_readb(address);
+	Description:
+	Load HL onto the stack
+*/
+static void op_F9(struct gb_context *gb)
+{
+	CPU_load_sp_16(gb, gb->HL.w);
+}
 
-		CPU_add_8(&toAdd, 0);
+/*
+	LDHL SP, n
 
-		PC++;
+	Description:
+	Put SP + n effective address into HL
 
-		cycles = 8;
-		break;
-	}
-	case 0xC6:
-	{
-		/*
-		ADD A, #
+	Use with:
+	n = one byte signed immediate value
 
-		Description:
-		Add immediate value to A and leave result in A
+	Flags:
+	Z - Reset
+	N - Reset
+	H - Set if necessary
+	C - Set if necessary
+*/
+static void op_F8(struct gb_context *gb)
+{
+	/* Make a backup copy of SP */
+	word original = gb->SP;
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Set if carry from bit 3
-		C - Set if carry from bit 7
-		*/
-		byte immediate = memory_readb(PC+1);
+	/* Add n to SP */
+	CPU_add_sp_n(gb, gb->operand8);
 
-		CPU_add_8(&immediate, 0);
+	/* Update HL with result in SP */
+	gb->HL.w = gb->SP;
 
-		PC += 2;
+	/*
+		Reinstate SP since we just want the
+		result in HL and not in SP
+	*/
+	gb->SP = original;
+}
 
-		cycles = 8;
-		break;
-	}
-	case 0x8F:
-	{
-		/*
-		ADC A, A
+/*
+	LD (nn), SP
 
-		Description:
-		Add A + Carry flag to A and leave result in A(insert meme)
+	Description:
+	Put Stack Pointer(tm) at address n
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Set if carry from bit 3
-		C - Set if carry from bit 7
-		*/
-		CPU_add_8(&A, 1);
+	Use with:
+	nn = two byte immediate address
+*/
+static void op_08(struct gb_context *gb)
+{
+	/* Write SP to nn, LSB first */
+	memory_writeb(gb, gb->operand16, gb->SP & 0xFF);
+	memory_writeb(gb, gb->operand16 + 1, gb->SP >> 8);
+}
 
-		PC++;
+/*
+	PUSH nn
 
-		cycles = 4;
-		break;
-	}
-	case 0x88:
-	{
-		/*
-		ADC A, B
+	Description:
+	Push register pair AF onto stack
+*/
+static void op_F5(struct gb_context *gb)
+{
+	/* Compile F struct into a byte for use */
+	compiler_F(gb, 0);
 
-		Description:
-		Add B + Carry flag to A and leave result in A
+	/* Push A and F register onto the stack */
+	CPU_load_sp_16(gb, gb->AF.w);
+}
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Set if carry from bit 3
-		C - Set if carry from bit 7
-		*/
-		CPU_add_8(&B, 1);
+/*
+	PUSH nn
 
-		PC++;
+	Description:
+	Push register pair BC onto stack
+*/
+static void op_C5(struct gb_context *gb)
+{
+	/* Push B and C register onto the stack */
+	CPU_load_sp_16(gb, gb->BC.w);
+}
 
-		cycles = 4;
-		break;
-	}
-	case 0x89:
-	{
-		/*
-		ADC A, C
+/*
+	PUSH nn
 
-		Description:
-		Add C + Carry flag to A and leave result in A
+	Description:
+	Push register pair DE onto stack
+*/
+static void op_D5(struct gb_context *gb)
+{
+	/* Push D and E register onto the stack */
+	CPU_load_sp_16(gb, gb->DE.w);
+}
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Set if carry from bit 3
-		C - Set if carry from bit 7
-		*/
-		CPU_add_8(&C, 1);
+/*
+	PUSH nn
 
-		PC++;
+	Description:
+	Push register pair HL onto stack
+*/
+static void op_E5(struct gb_context *gb)
+{
+	/* Push H and L register onto the stack */
+	CPU_load_sp_16(gb, gb->HL.w);
+}
 
-		cycles = 4;
-		break;
-	}
-	case 0x8A:
-	{
-		/*
-		ADC A, D
+/*
+	POP nn
 
-		Description:
-		Add D + Carry flag to A and leave result in A
+	Description:
+	Pop two bytes off of stack into pair AF
+*/
+static void op_F1(struct gb_context *gb)
+{
+	/*
+		Pop AF data from the stack, since these
+		were pushed onto the stack in order, they
+		must be retrieved backwards
+	*/
+	CPU_load_16_sp(gb, &gb->AF.w);
+
+	/* Rebuild F flag variables from the assembled byte */
+	compiler_F(gb, 1);
+}
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Set if carry from bit 3
-		C - Set if carry from bit 7
-		*/
-		CPU_add_8(&D, 1);
+/*
+	POP nn
 
-		PC++;
+	Description:
+	Pop two bytes off of stack into pair BC
+*/
+static void op_C1(struct gb_context *gb)
+{
+	/*
+		Pop BC data from the stack, since these
+		were pushed onto the stack in order, they
+		must be retrieved backwards
+	*/
+	CPU_load_16_sp(gb, &gb->BC.w);
+}
 
-		cycles = 4;
-		break;
-	}
-	case 0x8B:
-	{
-		/*
-		ADC A, E
+/*
+	POP nn
 
-		Description:
-		Add E + Carry flag to A and leave result in A
+	Description:
+	Pop two bytes off of stack into pair DE
+*/
+static void op_D1(struct gb_context *gb)
+{
+	/*
+		Pop DE data from the stack, since these
+		were pushed onto the stack in order, they
+		must be retrieved backwards
+	*/
+	CPU_load_16_sp(gb, &gb->DE.w);
+}
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Set if carry from bit 3
-		C - Set if carry from bit 7
-		*/
-		CPU_add_8(&E, 1);
+/*
+	POP nn
 
-		PC++;
+	Description:
+	Pop two bytes off of stack into pair HL
+*/
+static void op_E1(struct gb_context *gb)
+{
+	/*
+		Pop HL data from the stack, since these
+		were pushed onto the stack in order, they
+		must be retrieved backwards
+	*/
+	CPU_load_16_sp(gb, &gb->HL.w);
+}
 
-		cycles = 4;
-		break;
-	}
-	case 0x8C:
-	{
-		/*
-		ADC A, H
+/* ++++++ 8-BIT ALU ++++++ */
 
-		Description:
-		Add H + Carry flag to A and leave result in A
+/*
+	ADD A, A
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Set if carry from bit 3
-		C - Set if carry from bit 7
-		*/
-		CPU_add_8(&H, 1);
+	Description:
+	Add A to A and leave result in A(insert meme)
 
-		PC++;
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Set if carry from bit 3
+	C - Set if carry from bit 7
+*/
+static void op_87(struct gb_context *gb)
+{
+	CPU_add_8(gb, &gb->AF.b.hi, 0);
+}
 
-		cycles = 4;
-		break;
-	}
-	case 0x8D:
-	{
-		/*
-		ADC A, L
+/*
+	ADD A, B
 
-		Description:
-		Add L + Carry flag to A and leave result in A
+	Description:
+	Add B to A and leave result in A
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Set if carry from bit 3
-		C - Set if carry from bit 7
-		*/
-		CPU_add_8(&L, 1);
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Set if carry from bit 3
+	C - Set if carry from bit 7
+*/
+static void op_80(struct gb_context *gb)
+{
+	CPU_add_8(gb, &gb->BC.b.hi, 0);
+}
 
-		PC++;
+/*
+	ADD A, C
 
-		cycles = 4;
-		break;
-	}
-	case 0x8E:
-	{
-		/*
-		ADC A, (HL)
+	Description:
+	Add C to A and leave result in A
 
-		Description:
-		Add value pointed to by HL + Carry flag to A and leave
-		result in A
-
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Set if carry from bit 3
-		C - Set if carry from bit 7
-		*/
-		byte toAdd;
-		word address;
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Set if carry from bit 3
+	C - Set if carry from bit 7
+*/
+static void op_81(struct gb_context *gb)
+{
+	CPU_add_8(gb, &gb->BC.b.lo, 0);
+}
 
-		convert_to_pair(&H, &L, &address);
-		toAdd = memory_readb(address);
+/*
+	ADD A, D
 
-		CPU_add_8(&toAdd, 1);
+	Description:
+	Add D to A and leave result in A
 
-		PC++;
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Set if carry from bit 3
+	C - Set if carry from bit 7
+*/
+static void op_82(struct gb_context *gb)
+{
+	CPU_add_8(gb, &gb->DE.b.hi, 0);
+}
 
-		cycles = 8;
-		break;
-	}
-	case 0xCE:
-	{
-		/*
-		ADC A, #
+/*
+	ADD A, E
 
-		Description:
-		Add immediate value + Carry flag to A and leave result in A
+	Description:
+	Add E to A and leave result in A
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Set if carry from bit 3
-		C - Set if carry from bit 7
-		*/
-		byte immediate = memory_readb(PC+1);
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Set if carry from bit 3
+	C - Set if carry from bit 7
+*/
+static void op_83(struct gb_context *gb)
+{
+	CPU_add_8(gb, &gb->DE.b.lo, 0);
+}
 
-		CPU_add_8(&immediate, 1);
+/*
+	ADD A, H
 
-		PC += 2;
+	Description:
+	Add H to A and leave result in A
 
-		cycles = 8;
-		break;
-	}
-	case 0x97:
-	{
-		/*
-		SUB A, A
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Set if carry from bit 3
+	C - Set if carry from bit 7
+*/
+static void op_84(struct gb_context *gb)
+{
+	CPU_add_8(gb, &gb->HL.b.hi, 0);
+}
 
-		Description:
-		Subtract A from A and leave result in A
+/*
+	ADD A, L
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Set
-		H - Set if no borrow from bit 4
-		C - Set if no borrow
-		*/
-		CPU_subtract_8(&A, 0);
+	Description:
+	Add L to A and leave result in A
 
-		PC++;
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Set if carry from bit 3
+	C - Set if carry from bit 7
+*/
+static void op_85(struct gb_context *gb)
+{
+	CPU_add_8(gb, &gb->HL.b.lo, 0);
+}
 
-		cycles = 4;
-		break;
-	}
-	case 0x90:
-	{
-		/*
-		SUB A, B
+/*
+	ADD A, (HL)
 
-		Description:
-		Subtract B from A and leave result in A
+	Description:
+	Add value pointed to by HL to A and leave result in A
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Set
-		H - Set if no borrow from bit 4
-		C - Set if no borrow
-		*/
-		CPU_subtract_8(&B, 0);
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Set if carry from bit 3
+	C - Set if carry from bit 7
+*/
+static void op_86(struct gb_context *gb)
+{
+	byte toAdd;
+	word address;
 
-		PC++;
+	address = gb->HL.w;
+	toAdd = memory_readb(gb, address);
 
-		cycles = 4;
-		break;
-	}
-	case 0x91:
-	{
-		/*
-		SUB A, C
+	CPU_add_8(gb, &toAdd, 0);
+}
 
-		Description:
-		Subtract C from A and leave result in A
+/*
+	ADD A, #
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Set
-		H - Set if no borrow from bit 4
-		C - Set if no borrow
-		*/
-		CPU_subtract_8(&C, 0);
+	Description:
+	Add immediate value to A and leave result in A
 
-		PC++;
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Set if carry from bit 3
+	C - Set if carry from bit 7
+*/
+static void op_C6(struct gb_context *gb)
+{
+	byte immediate = gb->operand8;
 
-		cycles = 4;
-		break;
-	}
-	case 0x92:
-	{
-		/*
-		SUB A, D
+	CPU_add_8(gb, &immediate, 0);
+}
 
-		Description:
-		Subtract D from A and leave result in A
+/*
+	ADC A, A
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Set
-		H - Set if no borrow from bit 4
-		C - Set if no borrow
-		*/
-		CPU_subtract_8(&D, 0);
+	Description:
+	Add A + Carry flag to A and leave result in A(insert meme)
 
-		PC++;
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Set if carry from bit 3
+	C - Set if carry from bit 7
+*/
+static void op_8F(struct gb_context *gb)
+{
+	CPU_add_8(gb, &gb->AF.b.hi, 1);
+}
 
-		cycles = 4;
-		break;
-	}
-	case 0x93:
-	{
-		/*
-		SUB A, E
+/*
+	ADC A, B
 
-		Description:
-		Subtract E from A and leave result in A
+	Description:
+	Add B + Carry flag to A and leave result in A
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Set
-		H - Set if no borrow from bit 4
-		C - Set if no borrow
-		*/
-		CPU_subtract_8(&E, 0);
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Set if carry from bit 3
+	C - Set if carry from bit 7
+*/
+static void op_88(struct gb_context *gb)
+{
+	CPU_add_8(gb, &gb->BC.b.hi, 1);
+}
 
-		PC++;
+/*
+	ADC A, C
 
-		cycles = 4;
-		break;
-	}
-	case 0x94:
-	{
-		/*
-		SUB A, H
+	Description:
+	Add C + Carry flag to A and leave result in A
 
-		Description:
-		Subtract H from A and leave result in A
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Set if carry from bit 3
+	C - Set if carry from bit 7
+*/
+static void op_89(struct gb_context *gb)
+{
+	CPU_add_8(gb, &gb->BC.b.lo, 1);
+}
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Set
-		H - Set if no borrow from bit 4
-		C - Set if no borrow
-		*/
-		CPU_subtract_8(&H, 0);
+/*
+	ADC A, D
 
-		PC++;
+	Description:
+	Add D + Carry flag to A and leave result in A
 
-		cycles = 4;
-		break;
-	}
-	case 0x95:
-	{
-		/*
-		SUB A, L
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Set if carry from bit 3
+	C - Set if carry from bit 7
+*/
+static void op_8A(struct gb_context *gb)
+{
+	CPU_add_8(gb, &gb->DE.b.hi, 1);
+}
 
-		Description:
-		Subtract L from A and leave result in A
+/*
+	ADC A, E
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Set
-		H - Set if no borrow from bit 4
-		C - Set if no borrow
-		*/
-		CPU_subtract_8(&L, 0);
+	Description:
+	Add E + Carry flag to A and leave result in A
 
-		PC++;
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Set if carry from bit 3
+	C - Set if carry from bit 7
+*/
+static void op_8B(struct gb_context *gb)
+{
+	CPU_add_8(gb, &gb->DE.b.lo, 1);
+}
 
-		cycles = 4;
-		break;
-	}
-	case 0x96:
-	{
-		/*
-		SUB A, (HL)
+/*
+	ADC A, H
 
-		Description:
-		Subtract the value pointed to by HL from A and leave
-		result in A
-
-		Flags affected:
-		Z - Set if result is zero
-		N - Set
-		H - Set if no borrow from bit 4
-		C - Set if no borrow
-		*/
-		byte toSub;
-		word address;
+	Description:
+	Add H + Carry flag to A and leave result in A
 
-		convert_to_pair(&H, &L, &address);
-		toSub = memory_readb(address);
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Set if carry from bit 3
+	C - Set if carry from bit 7
+*/
+static void op_8C(struct gb_context *gb)
+{
+	CPU_add_8(gb, &gb->HL.b.hi, 1);
+}
 
-		CPU_subtract_8(&toSub, 0);
+/*
+	ADC A, L
 
-		PC++;
+	Description:
+	Add L + Carry flag to A and leave result in A
 
-		cycles = 8;
-		break;
-	}
-	case 0xD6:
-	{
-		/*
-		SUB A, #
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Set if carry from bit 3
+	C - Set if carry from bit 7
+*/
+static void op_8D(struct gb_context *gb)
+{
+	CPU_add_8(gb, &gb->HL.b.lo, 1);
+}
 
-		Description:
-		Subtract immediate value from A and leave result in A
+/*
+	ADC A, (HL)
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Set
-		H - Set if no borrow from bit 4
-		C - Set if no borrow
-		*/
-		byte immediate = memory_readb(PC+1);
+	Description:
+	Add value pointed to by HL + Carry flag to A and leave
+	result in A
 
-		CPU_subtract_8(&immediate, 0);
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Set if carry from bit 3
+	C - Set if carry from bit 7
+*/
+static void op_8E(struct gb_context *gb)
+{
+	byte toAdd;
+	word address;
 
-		PC += 2;
+	address = gb->HL.w;
+	toAdd = memory_readb(gb, address);
 
-		cycles = 8;
-		break;
-	}
-	case 0x9F:
-	{
-		/*
-		SBC A, A
+	CPU_add_8(gb, &toAdd, 1);
+}
 
-		Description:
-		Subtract A + Carry flag from A and leave result in A
+/*
+	ADC A, #
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Set
-		H - Set if no borrow from bit 4
-		C - Set if no borrow
-		*/
-		CPU_subtract_8(&A, 1);
+	Description:
+	Add immediate value + Carry flag to A and leave result in A
 
-		PC++;
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Set if carry from bit 3
+	C - Set if carry from bit 7
+*/
+static void op_CE(struct gb_context *gb)
+{
+	byte immediate = gb->operand8;
 
-		cycles = 4;
-		break;
-	}
-	case 0x98:
-	{
-		/*
-		SBC A, B
+	CPU_add_8(gb, &immediate, 1);
+}
 
-		Description:
-		Subtract B + Carry flag from A and leave result in A
+/*
+	SUB A, A
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Set
-		H - Set if no borrow from bit 4
-		C - Set if no borrow
-		*/
-		CPU_subtract_8(&B, 1);
+	Description:
+	Subtract A from A and leave result in A
 
-		PC++;
+	Flags affected:
+	Z - Set if result is zero
+	N - Set
+	H - Set if no borrow from bit 4
+	C - Set if no borrow
+*/
+static void op_97(struct gb_context *gb)
+{
+	CPU_subtract_8(gb, &gb->AF.b.hi, 0);
+}
 
-		cycles = 4;
-		break;
-	}
-	case 0x99:
-	{
-		/*
-		SBC A, C
+/*
+	SUB A, B
 
-		Description:
-		Subtract C + Carry flag from A and leave result in A
+	Description:
+	Subtract B from A and leave result in A
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Set
-		H - Set if no borrow from bit 4
-		C - Set if no borrow
-		*/
-		CPU_subtract_8(&C, 1);
+	Flags affected:
+	Z - Set if result is zero
+	N - Set
+	H - Set if no borrow from bit 4
+	C - Set if no borrow
+*/
+static void op_90(struct gb_context *gb)
+{
+	CPU_subtract_8(gb, &gb->BC.b.hi, 0);
+}
 
-		PC++;
+/*
+	SUB A, C
 
-		cycles = 4;
-		break;
-	}
-	case 0x9A:
-	{
-		/*
-		SBC A, D
+	Description:
+	Subtract C from A and leave result in A
 
-		Description:
-		Subtract D + Carry flag from A and leave result in A
+	Flags affected:
+	Z - Set if result is zero
+	N - Set
+	H - Set if no borrow from bit 4
+	C - Set if no borrow
+*/
+static void op_91(struct gb_context *gb)
+{
+	CPU_subtract_8(gb, &gb->BC.b.lo, 0);
+}
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Set
-		H - Set if no borrow from bit 4
-		C - Set if no borrow
-		*/
-		CPU_subtract_8(&D, 1);
+/*
+	SUB A, D
 
-		PC++;
+	Description:
+	Subtract D from A and leave result in A
 
-		cycles = 4;
-		break;
-	}
-	case 0x9B:
-	{
-		/*
-		SBC A, E
+	Flags affected:
+	Z - Set if result is zero
+	N - Set
+	H - Set if no borrow from bit 4
+	C - Set if no borrow
+*/
+static void op_92(struct gb_context *gb)
+{
+	CPU_subtract_8(gb, &gb->DE.b.hi, 0);
+}
 
-		Description:
-		Subtract E + Carry flag from A and leave result in A
+/*
+	SUB A, E
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Set
-		H - Set if no borrow from bit 4
-		C - Set if no borrow
-		*/
-		CPU_subtract_8(&E, 1);
+	Description:
+	Subtract E from A and leave result in A
 
-		PC++;
+	Flags affected:
+	Z - Set if result is zero
+	N - Set
+	H - Set if no borrow from bit 4
+	C - Set if no borrow
+*/
+static void op_93(struct gb_context *gb)
+{
+	CPU_subtract_8(gb, &gb->DE.b.lo, 0);
+}
 
-		cycles = 4;
-		break;
-	}
-	case 0x9C:
-	{
-		/*
-		SBC A, H
+/*
+	SUB A, H
 
-		Description:
-		Subtract H + Carry flag from A and leave result in A
+	Description:
+	Subtract H from A and leave result in A
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Set
-		H - Set if no borrow from bit 4
-		C - Set if no borrow
-		*/
-		CPU_subtract_8(&H, 1);
+	Flags affected:
+	Z - Set if result is zero
+	N - Set
+	H - Set if no borrow from bit 4
+	C - Set if no borrow
+*/
+static void op_94(struct gb_context *gb)
+{
+	CPU_subtract_8(gb, &gb->HL.b.hi, 0);
+}
 
-		PC++;
+/*
+	SUB A, L
 
-		cycles = 4;
-		break;
-	}
-	case 0x9D:
-	{
-		/*
-		SBC A, L
+	Description:
+	Subtract L from A and leave result in A
 
-		Description:
-		Subtract L + Carry flag from A and leave result in A
+	Flags affected:
+	Z - Set if result is zero
+	N - Set
+	H - Set if no borrow from bit 4
+	C - Set if no borrow
+*/
+static void op_95(struct gb_context *gb)
+{
+	CPU_subtract_8(gb, &gb->HL.b.lo, 0);
+}
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Set
-		H - Set if no borrow from bit 4
-		C - Set if no borrow
-		*/
-		CPU_subtract_8(&L, 1);
+/*
+	SUB A, (HL)
 
-		PC++;
+	Description:
+	Subtract the value pointed to by HL from A and leave
+	result in A
 
-		cycles = 4;
-		break;
-	}
-	case 0x9E:
-	{
-		/*
-		SBC A, (HL)
+	Flags affected:
+	Z - Set if result is zero
+	N - Set
+	H - Set if no borrow from bit 4
+	C - Set if no borrow
+*/
+static void op_96(struct gb_context *gb)
+{
+	byte toSub;
+	word address;
 
-		Description:
-		Subtract the value pointed to by HL from A and leave
-		result in A
-
-		Flags affected:
-		Z - Set if result is zero
-		N - Set
-		H - Set if no borrow from bit 4
-		C - Set if no borrow
-		*/
-		byte toSub;
-		word address;
+	address = gb->HL.w;
+	toSub = memory_readb(gb, address);
 
-		convert_to_pair(&H, &L, &address);
-		toSub = memory_readb(address);
+	CPU_subtract_8(gb, &toSub, 0);
+}
 
-		CPU_subtract_8(&toSub, 1);
+/*
+	SUB A, #
 
-		PC++;
+	Description:
+	Subtract immediate value from A and leave result in A
 
-		cycles = 8;
-		break;
-	}
-	case 0xDE:
-	{
-		/*
-		SBC A, #
+	Flags affected:
+	Z - Set if result is zero
+	N - Set
+	H - Set if no borrow from bit 4
+	C - Set if no borrow
+*/
+static void op_D6(struct gb_context *gb)
+{
+	byte immediate = gb->operand8;
 
-		Description:
-		Subtract immediate value from A and leave result in A
+	CPU_subtract_8(gb, &immediate, 0);
+}
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Set
-		H - Set if no borrow from bit 4
-		C - Set if no borrow
-		*/
-		byte immediate = memory_readb(PC+1);
+/*
+	SBC A, A
 
-		CPU_subtract_8(&immediate, 1);
+	Description:
+	Subtract A + Carry flag from A and leave result in A
 
-		PC += 2;
+	Flags affected:
+	Z - Set if result is zero
+	N - Set
+	H - Set if no borrow from bit 4
+	C - Set if no borrow
+*/
+static void op_9F(struct gb_context *gb)
+{
+	CPU_subtract_8(gb, &gb->AF.b.hi, 1);
+}
 
-		cycles = 8;
-		break;
-	}
-	case 0xA7:
-	{
-		/*
-		AND A, A
+/*
+	SBC A, B
 
-		Description:
-		Bitwise AND A with A, leave result in A
+	Description:
+	Subtract B + Carry flag from A and leave result in A
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Set
-		C - Reset
-		*/
-		CPU_and_8(&A);
+	Flags affected:
+	Z - Set if result is zero
+	N - Set
+	H - Set if no borrow from bit 4
+	C - Set if no borrow
+*/
+static void op_98(struct gb_context *gb)
+{
+	CPU_subtract_8(gb, &gb->BC.b.hi, 1);
+}
 
-		PC++;
+/*
+	SBC A, C
 
-		cycles = 4;
-		break;
-	}
-	case 0xA0:
-	{
-		/*
-		AND A, B
+	Description:
+	Subtract C + Carry flag from A and leave result in A
 
-		Description:
-		Bitwise AND A with B, leave result in A
+	Flags affected:
+	Z - Set if result is zero
+	N - Set
+	H - Set if no borrow from bit 4
+	C - Set if no borrow
+*/
+static void op_99(struct gb_context *gb)
+{
+	CPU_subtract_8(gb, &gb->BC.b.lo, 1);
+}
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Set
-		C - Reset
-		*/
-		CPU_and_8(&B);
+/*
+	SBC A, D
 
-		PC++;
+	Description:
+	Subtract D + Carry flag from A and leave result in A
 
-		cycles = 4;
-		break;
-	}
-	case 0xA1:
-	{
-		/*
-		AND A, C
+	Flags affected:
+	Z - Set if result is zero
+	N - Set
+	H - Set if no borrow from bit 4
+	C - Set if no borrow
+*/
+static void op_9A(struct gb_context *gb)
+{
+	CPU_subtract_8(gb, &gb->DE.b.hi, 1);
+}
 
-		Description:
-		Bitwise AND A with C, leave result in A
+/*
+	SBC A, E
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Set
-		C - Reset
-		*/
-		CPU_and_8(&C);
+	Description:
+	Subtract E + Carry flag from A and leave result in A
 
-		PC++;
+	Flags affected:
+	Z - Set if result is zero
+	N - Set
+	H - Set if no borrow from bit 4
+	C - Set if no borrow
+*/
+static void op_9B(struct gb_context *gb)
+{
+	CPU_subtract_8(gb, &gb->DE.b.lo, 1);
+}
 
-		cycles = 4;
-		break;
-	}
-	case 0xA2:
-	{
-		/*
-		AND A, D
+/*
+	SBC A, H
 
-		Description:
-		Bitwise AND A with D, leave result in A
+	Description:
+	Subtract H + Carry flag from A and leave result in A
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Set
-		C - Reset
-		*/
-		CPU_and_8(&D);
+	Flags affected:
+	Z - Set if result is zero
+	N - Set
+	H - Set if no borrow from bit 4
+	C - Set if no borrow
+*/
+static void op_9C(struct gb_context *gb)
+{
+	CPU_subtract_8(gb, &gb->HL.b.hi, 1);
+}
 
-		PC++;
+/*
+	SBC A, L
 
-		cycles = 4;
-		break;
-	}
-	case 0xA3:
-	{
-		/*
-		AND A, E
+	Description:
+	Subtract L + Carry flag from A and leave result in A
 
-		Description:
-		Bitwise AND A with E, leave result in A
+	Flags affected:
+	Z - Set if result is zero
+	N - Set
+	H - Set if no borrow from bit 4
+	C - Set if no borrow
+*/
+static void op_9D(struct gb_context *gb)
+{
+	CPU_subtract_8(gb, &gb->HL.b.lo, 1);
+}
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Set
-		C - Reset
-		*/
-		CPU_and_8(&E);
+/*
+	SBC A, (HL)
 
-		PC++;
+	Description:
+	Subtract the value pointed to by HL from A and leave
+	result in A
 
-		cycles = 4;
-		break;
-	}
-	case 0xA4:
-	{
-		/*
-		AND A, H
+	Flags affected:
+	Z - Set if result is zero
+	N - Set
+	H - Set if no borrow from bit 4
+	C - Set if no borrow
+*/
+static void op_9E(struct gb_context *gb)
+{
+	byte toSub;
+	word address;
 
-		Description:
-		Bitwise AND A with H, leave result in A
+	address = gb->HL.w;
+	toSub = memory_readb(gb, address);
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Set
-		C - Reset
-		*/
-		CPU_and_8(&H);
+	CPU_subtract_8(gb, &toSub, 1);
+}
 
-		PC++;
+/*
+	SBC A, #
 
-		cycles = 4;
-		break;
-	}
-	case 0xA5:
-	{
-		/*
-		AND A, L
+	Description:
+	Subtract immediate value from A and leave result in A
 
-		Description:
-		Bitwise AND A with L, leave result in A
+	Flags affected:
+	Z - Set if result is zero
+	N - Set
+	H - Set if no borrow from bit 4
+	C - Set if no borrow
+*/
+static void op_DE(struct gb_context *gb)
+{
+	byte immediate = gb->operand8;
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Set
-		C - Reset
-		*/
-		CPU_and_8(&L);
+	CPU_subtract_8(gb, &immediate, 1);
+}
 
-		PC++;
+/*
+	AND A, A
 
-		cycles = 4;
-		break;
-	}
-	case 0xA6:
-	{
-		/*
-		AND A, (HL)
+	Description:
+	Bitwise AND A with A, leave result in A
 
-		Description:
-		Bitwise AND A with the value pointed to by HL,
-		leave result in A
-
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Set
-		C - Reset
-		*/
-		byte toAnd;
-		word address;
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Set
+	C - Reset
+*/
+static void op_A7(struct gb_context *gb)
+{
+	CPU_and_8(gb, &gb->AF.b.hi);
+}
 
-		convert_to_pair(&H, &L, &address);
-		toAnd = memory_readb(address);
+/*
+	AND A, B
 
-		CPU_and_8(&toAnd);
+	Description:
+	Bitwise AND A with B, leave result in A
 
-		PC++;
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Set
+	C - Reset
+*/
+static void op_A0(struct gb_context *gb)
+{
+	CPU_and_8(gb, &gb->BC.b.hi);
+}
 
-		cycles = 8;
-		break;
-	}
-	case 0xE6:
-	{
-		/*
-		AND A, #
+/*
+	AND A, C
 
-		Description:
-		Bitwise AND A with immediate value, leave result in A
+	Description:
+	Bitwise AND A with C, leave result in A
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Set
-		C - Reset
-		*/
-		byte immediate = memory_readb(PC+1);
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Set
+	C - Reset
+*/
+static void op_A1(struct gb_context *gb)
+{
+	CPU_and_8(gb, &gb->BC.b.lo);
+}
 
-		CPU_and_8(&immediate);
+/*
+	AND A, D
 
-		PC += 2;
+	Description:
+	Bitwise AND A with D, leave result in A
 
-		cycles = 8;
-		break;
-	}
-	case 0xB7:
-	{
-		/*
-		OR A, A
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Set
+	C - Reset
+*/
+static void op_A2(struct gb_context *gb)
+{
+	CPU_and_8(gb, &gb->DE.b.hi);
+}
 
-		Description:
-		Bitwise OR A with A, leave result in A
+/*
+	AND A, E
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Reset
-		C - Reset
-		*/
-		CPU_or_8(&A);
+	Description:
+	Bitwise AND A with E, leave result in A
 
-		PC++;
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Set
+	C - Reset
+*/
+static void op_A3(struct gb_context *gb)
+{
+	CPU_and_8(gb, &gb->DE.b.lo);
+}
 
-		cycles = 4;
-		break;
-	}
-	case 0xB0:
-	{
-		/*
-		OR A, B
+/*
+	AND A, H
 
-		Description:
-		Bitwise OR A with B, leave result in A
+	Description:
+	Bitwise AND A with H, leave result in A
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Reset
-		C - Reset
-		*/
-		CPU_or_8(&B);
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Set
+	C - Reset
+*/
+static void op_A4(struct gb_context *gb)
+{
+	CPU_and_8(gb, &gb->HL.b.hi);
+}
 
-		PC++;
+/*
+	AND A, L
 
-		cycles = 4;
-		break;
-	}
-	case 0xB1:
-	{
-		/*
-		OR A, C
+	Description:
+	Bitwise AND A with L, leave result in A
 
-		Description:
-		Bitwise OR A with C, leave result in A
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Set
+	C - Reset
+*/
+static void op_A5(struct gb_context *gb)
+{
+	CPU_and_8(gb, &gb->HL.b.lo);
+}
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Reset
-		C - Reset
-		*/
-		CPU_or_8(&C);
+/*
+	AND A, (HL)
 
-		PC++;
+	Description:
+	Bitwise AND A with the value pointed to by HL,
+	leave result in A
 
-		cycles = 4;
-		break;
-	}
-	case 0xB2:
-	{
-		/*
-		OR A, D
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Set
+	C - Reset
+*/
+static void op_A6(struct gb_context *gb)
+{
+	byte toAnd;
+	word address;
 
-		Description:
-		Bitwise OR A with D, leave result in A
+	address = gb->HL.w;
+	toAnd = memory_readb(gb, address);
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Reset
-		C - Reset
-		*/
-		CPU_or_8(&D);
+	CPU_and_8(gb, &toAnd);
+}
 
-		PC++;
+/*
+	AND A, #
 
-		cycles = 4;
-		break;
-	}
-	case 0xB3:
-	{
-		/*
-		OR A, E
+	Description:
+	Bitwise AND A with immediate value, leave result in A
 
-		Description:
-		Bitwise OR A with E, leave result in A
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Set
+	C - Reset
+*/
+static void op_E6(struct gb_context *gb)
+{
+	byte immediate = gb->operand8;
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Reset
-		C - Reset
-		*/
-		CPU_or_8(&E);
+	CPU_and_8(gb, &immediate);
+}
 
-		PC++;
+/*
+	OR A, A
 
-		cycles = 4;
-		break;
-	}
-	case 0xB4:
-	{
-		/*
-		OR A, H
+	Description:
+	Bitwise OR A with A, leave result in A
 
-		Description:
-		Bitwise OR A with H, leave result in A
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Reset
+	C - Reset
+*/
+static void op_B7(struct gb_context *gb)
+{
+	CPU_or_8(gb, &gb->AF.b.hi);
+}
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Reset
-		C - Reset
-		*/
-		CPU_or_8(&H);
+/*
+	OR A, B
 
-		PC++;
+	Description:
+	Bitwise OR A with B, leave result in A
 
-		cycles = 4;
-		break;
-	}
-	case 0xB5:
-	{
-		/*
-		OR A, L
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Reset
+	C - Reset
+*/
+static void op_B0(struct gb_context *gb)
+{
+	CPU_or_8(gb, &gb->BC.b.hi);
+}
 
-		Description:
-		Bitwise OR A with L, leave result in A
+/*
+	OR A, C
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Reset
-		C - Reset
-		*/
-		CPU_or_8(&L);
+	Description:
+	Bitwise OR A with C, leave result in A
 
-		PC++;
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Reset
+	C - Reset
+*/
+static void op_B1(struct gb_context *gb)
+{
+	CPU_or_8(gb, &gb->BC.b.lo);
+}
 
-		cycles = 4;
-		break;
-	}
-	case 0xB6:
-	{
-		/*
-		OR A, (HL)
+/*
+	OR A, D
 
-		Description:
-		Bitwise OR A with the value pointed to by HL,
-		leave result in A
-
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Reset
-		C - Reset
-		*/
-		byte toOR;
-		word address;
+	Description:
+	Bitwise OR A with D, leave result in A
 
-		convert_to_pair(&H, &L, &address);
-		toOR = memory_readb(address);
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Reset
+	C - Reset
+*/
+static void op_B2(struct gb_context *gb)
+{
+	CPU_or_8(gb, &gb->DE.b.hi);
+}
 
-		CPU_or_8(&toOR);
+/*
+	OR A, E
 
-		PC++;
+	Description:
+	Bitwise OR A with E, leave result in A
 
-		cycles = 8;
-		break;
-	}
-	case 0xF6:
-	{
-		/*
-		OR A, #
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Reset
+	C - Reset
+*/
+static void op_B3(struct gb_context *gb)
+{
+	CPU_or_8(gb, &gb->DE.b.lo);
+}
 
-		Description:
-		Bitwise OR A with immediate value, leave result in A
+/*
+	OR A, H
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Reset
-		C - Reset
-		*/
-		byte immediate = memory_readb(PC+1);
+	Description:
+	Bitwise OR A with H, leave result in A
 
-		CPU_or_8(&immediate);
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Reset
+	C - Reset
+*/
+static void op_B4(struct gb_context *gb)
+{
+	CPU_or_8(gb, &gb->HL.b.hi);
+}
 
-		PC += 2;
+/*
+	OR A, L
 
-		cycles = 8;
-		break;
-	}
-	case 0xAF:
-	{
-		/*
-		XOR A, A
+	Description:
+	Bitwise OR A with L, leave result in A
 
-		Description:
-		Bitwise XOR A with A, leave result in A
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Reset
+	C - Reset
+*/
+static void op_B5(struct gb_context *gb)
+{
+	CPU_or_8(gb, &gb->HL.b.lo);
+}
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Reset
-		C - Reset
-		*/
-		CPU_xor_8(&A);
+/*
+	OR A, (HL)
 
-		PC++;
+	Description:
+	Bitwise OR A with the value pointed to by HL,
+	leave result in A
 
-		cycles = 4;
-		break;
-	}
-	case 0xA8:
-	{
-		/*
-		XOR A, B
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Reset
+	C - Reset
+*/
+static void op_B6(struct gb_context *gb)
+{
+	byte toOR;
+	word address;
 
-		Description:
-		Bitwise XOR A with B, leave result in A
+	address = gb->HL.w;
+	toOR = memory_readb(gb, address);
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Reset
-		C - Reset
-		*/
-		CPU_xor_8(&B);
+	CPU_or_8(gb, &toOR);
+}
 
-		PC++;
+/*
+	OR A, #
 
-		cycles = 4;
-		break;
-	}
-	case 0xA9:
-	{
-		/*
-		XOR A, C
+	Description:
+	Bitwise OR A with immediate value, leave result in A
 
-		Description:
-		Bitwise XOR A with C, leave result in A
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Reset
+	C - Reset
+*/
+static void op_F6(struct gb_context *gb)
+{
+	byte immediate = gb->operand8;
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Reset
-		C - Reset
-		*/
-		CPU_xor_8(&C);
+	CPU_or_8(gb, &immediate);
+}
 
-		PC++;
+/*
+	XOR A, A
 
-		cycles = 4;
-		break;
-	}
-	case 0xAA:
-	{
-		/*
-		XOR A, D
+	Description:
+	Bitwise XOR A with A, leave result in A
 
-		Description:
-		Bitwise XOR A with D, leave result in A
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Reset
+	C - Reset
+*/
+static void op_AF(struct gb_context *gb)
+{
+	CPU_xor_8(gb, &gb->AF.b.hi);
+}
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Reset
-		C - Reset
-		*/
-		CPU_xor_8(&D);
+/*
+	XOR A, B
 
-		PC++;
+	Description:
+	Bitwise XOR A with B, leave result in A
 
-		cycles = 4;
-		break;
-	}
-	case 0xAB:
-	{
-		/*
-		XOR A, E
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Reset
+	C - Reset
+*/
+static void op_A8(struct gb_context *gb)
+{
+	CPU_xor_8(gb, &gb->BC.b.hi);
+}
 
-		Description:
-		Bitwise XOR A with E, leave result in A
+/*
+	XOR A, C
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Reset
-		C - Reset
-		*/
-		CPU_xor_8(&E);
+	Description:
+	Bitwise XOR A with C, leave result in A
 
-		PC++;
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Reset
+	C - Reset
+*/
+static void op_A9(struct gb_context *gb)
+{
+	CPU_xor_8(gb, &gb->BC.b.lo);
+}
 
-		cycles = 4;
-		break;
-	}
-	case 0xAC:
-	{
-		/*
-		XOR A, H
+/*
+	XOR A, D
 
-		Description:
-		Bitwise XOR A with H, leave result in A
+	Description:
+	Bitwise XOR A with D, leave result in A
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Reset
-		C - Reset
-		*/
-		CPU_xor_8(&H);
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Reset
+	C - Reset
+*/
+static void op_AA(struct gb_context *gb)
+{
+	CPU_xor_8(gb, &gb->DE.b.hi);
+}
 
-		PC++;
+/*
+	XOR A, E
 
-		cycles = 4;
-		break;
-	}
-	case 0xAD:
-	{
-		/*
-		XOR A, L
+	Description:
+	Bitwise XOR A with E, leave result in A
 
-		Description:
-		Bitwise XOR A with L, leave result in A
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Reset
+	C - Reset
+*/
+static void op_AB(struct gb_context *gb)
+{
+	CPU_xor_8(gb, &gb->DE.b.lo);
+}
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Reset
-		C - Reset
-		*/
-		CPU_xor_8(&L);
+/*
+	XOR A, H
 
-		PC++;
+	Description:
+	Bitwise XOR A with H, leave result in A
 
-		cycles = 4;
-		break;
-	}
-	case 0xAE:
-	{
-		/*
-		XOR A, (HL)
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Reset
+	C - Reset
+*/
+static void op_AC(struct gb_context *gb)
+{
+	CPU_xor_8(gb, &gb->HL.b.hi);
+}
 
-		Description:
-		Bitwise XOR A with the value pointed to by HL,
-		leave result in A
-
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Reset
-		C - Reset
-		*/
-		byte toXOR;
-		word address;
+/*
+	XOR A, L
 
-		convert_to_pair(&H, &L, &address);
-		toXOR = memory_readb(address);
+	Description:
+	Bitwise XOR A with L, leave result in A
 
-		CPU_xor_8(&toXOR);
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Reset
+	C - Reset
+*/
+static void op_AD(struct gb_context *gb)
+{
+	CPU_xor_8(gb, &gb->HL.b.lo);
+}
 
-		PC++;
+/*
+	XOR A, (HL)
 
-		cycles = 8;
-		break;
-	}
-	case 0xEE:
-	{
-		/*
-		XOR A, #
+	Description:
+	Bitwise XOR A with the value pointed to by HL,
+	leave result in A
 
-		Description:
-		Bitwise XOR A with immediate value, leave result in A
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Reset
+	C - Reset
+*/
+static void op_AE(struct gb_context *gb)
+{
+	byte toXOR;
+	word address;
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Reset
-		C - Reset
-		*/
-		byte immediate = memory_readb(PC+1);
+	address = gb->HL.w;
+	toXOR = memory_readb(gb, address);
 
-		CPU_xor_8(&immediate);
+	CPU_xor_8(gb, &toXOR);
+}
 
-		PC += 2;
+/*
+	XOR A, #
 
-		cycles = 8;
-		break;
-	}
-	case 0xBF:
-	{
-		/*
-		CP A, A
+	Description:
+	Bitwise XOR A with immediate value, leave result in A
 
-		Description:
-		Compare A with A
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Reset
+	C - Reset
+*/
+static void op_EE(struct gb_context *gb)
+{
+	byte immediate = gb->operand8;
 
-		Flags affected:
-		Z - Set if N is equal to A
-		N - Set
-		H - Set if no borrow from bit 4
-		C - Set if A < N
-		*/
-		CPU_compare_8(&A);
+	CPU_xor_8(gb, &immediate);
+}
 
-		PC++;
+/*
+	CP A, A
 
-		cycles = 4;
-		break;
-	}
-	case 0xB8:
-	{
-		/*
-		CP A, B
+	Description:
+	Compare A with A
 
-		Description:
-		Compare A with B
+	Flags affected:
+	Z - Set if N is equal to A
+	N - Set
+	H - Set if no borrow from bit 4
+	C - Set if A < N
+*/
+static void op_BF(struct gb_context *gb)
+{
+	CPU_compare_8(gb, &gb->AF.b.hi);
+}
 
-		Flags affected:
-		Z - Set if N is equal to A
-		N - Set
-		H - Set if no borrow from bit 4
-		C - Set if A < N
-		*/
-		CPU_compare_8(&B);
+/*
+	CP A, B
 
-		PC++;
+	Description:
+	Compare A with B
 
-		cycles = 4;
-		break;
-	}
-	case 0xB9:
-	{
-		/*
-		CP A, C
+	Flags affected:
+	Z - Set if N is equal to A
+	N - Set
+	H - Set if no borrow from bit 4
+	C - Set if A < N
+*/
+static void op_B8(struct gb_context *gb)
+{
+	CPU_compare_8(gb, &gb->BC.b.hi);
+}
 
-		Description:
-		Compare A with C
+/*
+	CP A, C
 
-		Flags affected:
-		Z - Set if N is equal to A
-		N - Set
-		H - Set if no borrow from bit 4
-		C - Set if A < N
-		*/
-		CPU_compare_8(&C);
+	Description:
+	Compare A with C
 
-		PC++;
+	Flags affected:
+	Z - Set if N is equal to A
+	N - Set
+	H - Set if no borrow from bit 4
+	C - Set if A < N
+*/
+static void op_B9(struct gb_context *gb)
+{
+	CPU_compare_8(gb, &gb->BC.b.lo);
+}
 
-		cycles = 4;
-		break;
-	}
-	case 0xBA:
-	{
-		/*
-		CP A, D
+/*
+	CP A, D
 
-		Description:
-		Compare A with D
+	Description:
+	Compare A with D
 
-		Flags affected:
-		Z - Set if N is equal to A
-		N - Set
-		H - Set if no borrow from bit 4
-		C - Set if A < N
-		*/
-		CPU_compare_8(&D);
+	Flags affected:
+	Z - Set if N is equal to A
+	N - Set
+	H - Set if no borrow from bit 4
+	C - Set if A < N
+*/
+static void op_BA(struct gb_context *gb)
+{
+	CPU_compare_8(gb, &gb->DE.b.hi);
+}
 
-		PC++;
+/*
+	CP A, E
 
-		cycles = 4;
-		break;
-	}
-	case 0xBB:
-	{
-		/*
-		CP A, E
+	Description:
+	Compare A with E
 
-		Description:
-		Compare A with E
+	Flags affected:
+	Z - Set if N is equal to A
+	N - Set
+	H - Set if no borrow from bit 4
+	C - Set if A < N
+*/
+static void op_BB(struct gb_context *gb)
+{
+	CPU_compare_8(gb, &gb->DE.b.lo);
+}
 
-		Flags affected:
-		Z - Set if N is equal to A
-		N - Set
-		H - Set if no borrow from bit 4
-		C - Set if A < N
-		*/
-		CPU_compare_8(&E);
+/*
+	CP A, H
 
-		PC++;
+	Description:
+	Compare A with H
 
-		cycles = 4;
-		break;
-	}
-	case 0xBC:
-	{
-		/*
-		CP A, H
+	Flags affected:
+	Z - Set if N is equal to A
+	N - Set
+	H - Set if no borrow from bit 4
+	C - Set if A < N
+*/
+static void op_BC(struct gb_context *gb)
+{
+	CPU_compare_8(gb, &gb->HL.b.hi);
+}
 
-		Description:
-		Compare A with H
+/*
+	CP A, L
 
-		Flags affected:
-		Z - Set if N is equal to A
-		N - Set
-		H - Set if no borrow from bit 4
-		C - Set if A < N
-		*/
-		CPU_compare_8(&H);
+	Description:
+	Compare A with L
 
-		PC++;
+	Flags affected:
+	Z - Set if N is equal to A
+	N - Set
+	H - Set if no borrow from bit 4
+	C - Set if A < N
+*/
+static void op_BD(struct gb_context *gb)
+{
+	CPU_compare_8(gb, &gb->HL.b.lo);
+}
 
-		cycles = 4;
-		break;
-	}
-	case 0xBD:
-	{
-		/*
-		CP A, L
+/*
+	CP A, (HL)
 
-		Description:
-		Compare A with L
+	Description:
+	Compare A with the value pointed to by HL
 
-		Flags affected:
-		Z - Set if N is equal to A
-		N - Set
-		H - Set if no borrow from bit 4
-		C - Set if A < N
-		*/
-		CPU_compare_8(&L);
+	Flags affected:
+	Z - Set if N is equal to A
+	N - Set
+	H - Set if no borrow from bit 4
+	C - Set if A < N
+*/
+static void op_BE(struct gb_context *gb)
+{
+	byte toCompare;
+	word address;
 
-		PC++;
+	address = gb->HL.w;
+	toCompare = memory_readb(gb, address);
 
-		cycles = 4;
-		break;
-	}
-	case 0xBE:
-	{
-		/*
-		CP A, (HL)
+	CPU_compare_8(gb, &toCompare);
+}
 
-		Description:
-		Compare A with the value pointed to by HL
+/*
+	CP A, #
 
-		Flags affected:
-		Z - Set if N is equal to A
-		N - Set
-		H - Set if no borrow from bit 4
-		C - Set if A < N
-		*/
-		byte toCompare;
-		word address;
+	Description:
+	Compare A with immediate value
 
-		convert_to_pair(&H, &L, &address);
-		toCompare = memory_readb(address);
+	Flags affected:
+	Z - Set if N is equal to A
+	N - Set
+	H - Set if no borrow from bit 4
+	C - Set if A < N
+*/
+static void op_FE(struct gb_context *gb)
+{
+	byte immediate = gb->operand8;
 
-		CPU_compare_8(&toCompare);
+	CPU_compare_8(gb, &immediate);
+}
 
-		PC++;
+/*
+	INC A
 
-		cycles = 8;
-		break;
-	}
-	case 0xFE:
-	{
-		/*
-		CP A, #
+	Description:
+	Increment A
 
-		Description:
-		Compare A with immediate value
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Set if carry from bit 3
+	C - Not affected (reset)
+*/
+static void op_3C(struct gb_context *gb)
+{
+	CPU_incdec_8(gb, &gb->AF.b.hi, 0);
+}
 
-		Flags affected:
-		Z - Set if N is equal to A
-		N - Set
-		H - Set if no borrow from bit 4
-		C - Set if A < N
-		*/
-		byte immediate = memory_readb(PC+1);
+/*
+	INC B
 
-		CPU_compare_8(&immediate);
+	Description:
+	Increment B
 
-		PC += 2;
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Set if carry from bit 3
+	C - Not affected (reset)
+*/
+static void op_04(struct gb_context *gb)
+{
+	CPU_incdec_8(gb, &gb->BC.b.hi, 0);
+}
 
-		cycles = 8;
-		break;
-	}
-	case 0x3C:
-	{
-		/*
-		INC A
+/*
+	INC C
 
-		Description:
-		Increment A
+	Description:
+	Increment C
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Set if carry from bit 3
-		C - Not affected (reset)
-		*/
-		CPU_incdec_8(&A, 0);
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Set if carry from bit 3
+	C - Not affected (reset)
+*/
+static void op_0C(struct gb_context *gb)
+{
+	CPU_incdec_8(gb, &gb->BC.b.lo, 0);
+}
 
-		PC++;
+/*
+	INC D
 
-		cycles = 4;
-		break;
-	}
-	case 0x04:
-	{
-		/*
-		INC B
+	Description:
+	Increment D
 
-		Description:
-		Increment B
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Set if carry from bit 3
+	C - Not affected (reset)
+*/
+static void op_14(struct gb_context *gb)
+{
+	CPU_incdec_8(gb, &gb->DE.b.hi, 0);
+}
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Set if carry from bit 3
-		C - Not affected (reset)
-		*/
-		CPU_incdec_8(&B, 0);
+/*
+	INC E
 
-		PC++;
+	Description:
+	Increment E
 
-		cycles = 4;
-		break;
-	}
-	case 0x0C:
-	{
-		/*
-		INC C
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Set if carry from bit 3
+	C - Not affected (reset)
+*/
+static void op_1C(struct gb_context *gb)
+{
+	CPU_incdec_8(gb, &gb->DE.b.lo, 0);
+}
 
-		Description:
-		Increment C
+/*
+	INC H
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Set if carry from bit 3
-		C - Not affected (reset)
-		*/
-		CPU_incdec_8(&C, 0);
+	Description:
+	Increment H
 
-		PC++;
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Set if carry from bit 3
+	C - Not affected (reset)
+*/
+static void op_24(struct gb_context *gb)
+{
+	CPU_incdec_8(gb, &gb->HL.b.hi, 0);
+}
 
-		cycles = 4;
-		break;
-	}
-	case 0x14:
-	{
-		/*
-		INC D
+/*
+	INC L
 
-		Description:
-		Increment D
+	Description:
+	Increment L
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Set if carry from bit 3
-		C - Not affected (reset)
-		*/
-		CPU_incdec_8(&D, 0);
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Set if carry from bit 3
+	C - Not affected (reset)
+*/
+static void op_2C(struct gb_context *gb)
+{
+	CPU_incdec_8(gb, &gb->HL.b.lo, 0);
+}
 
-		PC++;
+/*
+	INC (HL)
 
-		cycles = 4;
-		break;
-	}
-	case 0x1C:
-	{
-		/*
-		INC E
+	Description:
+	Increment value pointed to by HL
 
-		Description:
-		Increment E
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Set if carry from bit 3
+	C - Not affected (reset)
+*/
+static void op_34(struct gb_context *gb)
+{
+	byte inc;
+	word address;
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Set if carry from bit 3
-		C - Not affected (reset)
-		*/
-		CPU_incdec_8(&E, 0);
+	address = gb->HL.w;
+	inc = memory_readb(gb, address);
 
-		PC++;
+	CPU_incdec_8(gb, &inc, 0);
 
-		cycles = 4;
-		break;
-	}
-	case 0x24:
-	{
-		/*
-		INC H
+	/* Update actual memory with the incremented value */
+	memory_writeb(gb, address, inc);
+}
 
-		Description:
-		Increment H
+/*
+	DEC A
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Set if carry from bit 3
-		C - Not affected (reset)
-		*/
-		CPU_incdec_8(&H, 0);
+	Description:
+	Decrement A
 
-		PC++;
+	Flags affected:
+	Z - Set if result is zero
+	N - Set
+	H - Set if no borrow from bit 4
+	C - Not affected (reset)
+*/
+static void op_3D(struct gb_context *gb)
+{
+	CPU_incdec_8(gb, &gb->AF.b.hi, 1);
+}
 
-		cycles = 4;
-		break;
-	}
-	case 0x2C:
-	{
-		/*
-		INC L
+/*
+	DEC B
 
-		Description:
-		Increment L
+	Description:
+	Decrement B
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Set if carry from bit 3
-		C - Not affected (reset)
-		*/
-		CPU_incdec_8(&L, 0);
+	Flags affected:
+	Z - Set if result is zero
+	N - Set
+	H - Set if no borrow from bit 4
+	C - Not affected (reset)
+*/
+static void op_05(struct gb_context *gb)
+{
+	CPU_incdec_8(gb, &gb->BC.b.hi, 1);
+}
 
-		PC++;
+/*
+	DEC C
 
-		cycles = 4;
-		break;
-	}
-	case 0x34:
-	{
-		/*
-		INC (HL)
+	Description:
+	Decrement C
 
-		Description:
-		Increment value pointed to by HL
+	Flags affected:
+	Z - Set if result is zero
+	N - Set
+	H - Set if no borrow from bit 4
+	C - Not affected (reset)
+*/
+static void op_0D(struct gb_context *gb)
+{
+	CPU_incdec_8(gb, &gb->BC.b.lo, 1);
+}
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Set if carry from bit 3
-		C - Not affected (reset)
-		*/
-		byte inc;
-		word address;
+/*
+	DEC D
 
-		convert_to_pair(&H, &L, &address);
-		inc = memory_readb(address);
+	Description:
+	Decrement D
 
-		CPU_incdec_8(&inc, 0);
+	Flags affected:
+	Z - Set if result is zero
+	N - Set
+	H - Set if no borrow from bit 4
+	C - Not affected (reset)
+*/
+static void op_15(struct gb_context *gb)
+{
+	CPU_incdec_8(gb, &gb->DE.b.hi, 1);
+}
 
-		/* Update actual memory with the incremented value */
-		memory_writeb(address, inc);
+/*
+	DEC E
 
-		PC++;
+	Description:
+	Decrement E
 
-		cycles = 12;
-		break;
-	}
-	case 0x3D:
-	{
-		/*
-		DEC A
+	Flags affected:
+	Z - Set if result is zero
+	N - Set
+	H - Set if no borrow from bit 4
+	C - Not affected (reset)
+*/
+static void op_1D(struct gb_context *gb)
+{
+	CPU_incdec_8(gb, &gb->DE.b.lo, 1);
+}
 
-		Description:
-		Decrement A
+/*
+	DEC H
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Set
-		H - Set if no borrow from bit 4
-		C - Not affected (reset)
-		*/
-		CPU_incdec_8(&A, 1);
+	Description:
+	Decrement H
 
-		PC++;
+	Flags affected:
+	Z - Set if result is zero
+	N - Set
+	H - Set if no borrow from bit 4
+	C - Not affected (reset)
+*/
+static void op_25(struct gb_context *gb)
+{
+	CPU_incdec_8(gb, &gb->HL.b.hi, 1);
+}
 
-		cycles = 4;
-		break;
-	}
-	case 0x05:
-	{
-		/*
-		DEC B
+/*
+	DEC L
 
-		Description:
-		Decrement B
+	Description:
+	Decrement L
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Set
-		H - Set if no borrow from bit 4
-		C - Not affected (reset)
-		*/
-		CPU_incdec_8(&B, 1);
+	Flags affected:
+	Z - Set if result is zero
+	N - Set
+	H - Set if no borrow from bit 4
+	C - Not affected (reset)
+*/
+static void op_2D(struct gb_context *gb)
+{
+	CPU_incdec_8(gb, &gb->HL.b.lo, 1);
+}
 
-		PC++;
+/*
+	DEC (HL)
 
-		cycles = 4;
-		break;
-	}
-	case 0x0D:
-	{
-		/*
-		DEC C
+	Description:
+	Decrement the value pointed to by HL
 
-		Description:
-		Decrement C
+	Flags affected:
+	Z - Set if result is zero
+	N - Set
+	H - Set if no borrow from bit 4
+	C - Not affected (reset)
+*/
+static void op_35(struct gb_context *gb)
+{
+	byte dec;
+	word address;
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Set
-		H - Set if no borrow from bit 4
-		C - Not affected (reset)
-		*/
-		CPU_incdec_8(&C, 1);
+	address = gb->HL.w;
+	dec = memory_readb(gb, address);
 
-		PC++;
+	CPU_incdec_8(gb, &dec, 1);
 
-		cycles = 4;
-		break;
-	}
-	case 0x15:
-	{
-		/*
-		DEC D
+	memory_writeb(gb, address, dec);
+}
 
-		Description:
-		Decrement D
+/* +++++ 16-BIT ARITHMETIC +++++ */
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Set
-		H - Set if no borrow from bit 4
-		C - Not affected (reset)
-		*/
-		CPU_incdec_8(&D, 1);
+/*
+	ADD HL, BC
 
-		PC++;
+	Description:
+	Add BC to HL.
 
-		cycles = 4;
-		break;
-	}
-	case 0x1D:
-	{
-		/*
-		DEC E
+	Flags affected:
+	Z - Not affected
+	N - Reset
+	H - Set if carry from bit 11
+	C - Set if carry from bit 15
+*/
+static void op_09(struct gb_context *gb)
+{
+	CPU_add_16(gb, &gb->HL.w, gb->BC.w);
+}
 
-		Description:
-		Decrement E
+/*
+	ADD HL, DE
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Set
-		H - Set if no borrow from bit 4
-		C - Not affected (reset)
-		*/
-		CPU_incdec_8(&E, 1);
+	Description:
+	Add DE to HL.
 
-		PC++;
+	Flags affected:
+	Z - Not affected
+	N - Reset
+	H - Set if carry from bit 11
+	C - Set if carry from bit 15
+*/
+static void op_19(struct gb_context *gb)
+{
+	CPU_add_16(gb, &gb->HL.w, gb->DE.w);
+}
 
-		cycles = 4;
-		break;
-	}
-	case 0x25:
-	{
-		/*
-		DEC H
+/*
+	ADD HL, HL
 
-		Description:
-		Decrement H
+	Description:
+	Add HL to HL.
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Set
-		H - Set if no borrow from bit 4
-		C - Not affected (reset)
-		*/
-		CPU_incdec_8(&H, 1);
+	Flags affected:
+	Z - Not affected
+	N - Reset
+	H - Set if carry from bit 11
+	C - Set if carry from bit 15
+*/
+static void op_29(struct gb_context *gb)
+{
+	CPU_add_16(gb, &gb->HL.w, gb->HL.w);
+}
 
-		PC++;
+/*
+	ADD HL, SP
 
-		cycles = 4;
-		break;
-	}
-	case 0x2D:
-	{
-		/*
-		DEC L
+	Description:
+	Add SP to HL.
 
-		Description:
-		Decrement L
+	Flags affected:
+	Z - Not affected
+	N - Reset
+	H - Set if carry from bit 11
+	C - Set if carry from bit 15
+*/
+static void op_39(struct gb_context *gb)
+{
+	CPU_add_16(gb, &gb->HL.w, gb->SP);
+}
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Set
-		H - Set if no borrow from bit 4
-		C - Not affected (reset)
-		*/
-		CPU_incdec_8(&L, 1);
+/*
+	ADD SP, n
 
-		PC++;
+	Description:
+	Add immediate byte to Stack Pointer.
 
-		cycles = 4;
-		break;
-	}
-	case 0x35:
-	{
-		/*
-		DEC (HL)
+	Use with:
+	Signed one byte immediate value
 
-		Description:
-		Decrement the value pointed to by HL
+	Flags affected:
+	Z - Reset
+	N - Reset
+	H - Set or reset according to operation
+	C - Set or reset according to operation
+*/
+static void op_E8(struct gb_context *gb)
+{
+	CPU_add_sp_n(gb, gb->operand8);
+}
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Set
-		H - Set if no borrow from bit 4
-		C - Not affected (reset)
-		*/
-		byte dec;
-		word address;
+/*
+	INC BC
 
-		convert_to_pair(&H, &L, &address);
-		dec = memory_readb(address);
+	Description:
+	Increment register BC
 
-		CPU_incdec_8(&dec, 1);
+	Flags affected:
+	None
+*/
+static void op_03(struct gb_context *gb)
+{
+	CPU_incdec_16(&gb->BC.w, 0);
+}
 
-		memory_writeb(address, dec);
+/*
+	INC DE
 
-		PC++;
+	Description:
+	Increment register DE
 
-		cycles = 12;
-		break;
-	}
+	Flags affected:
+	None
+*/
+static void op_13(struct gb_context *gb)
+{
+	CPU_incdec_16(&gb->DE.w, 0);
+}
 
+/*
+	INC HL
 
-		/* +++++ 16-BIT ARITHMETIC +++++ */
-	case 0x09:
-	{
-		/*
-		ADD HL, BC
+	Description:
+	Increment register HL
 
-		Description:
-		Add BC to HL.
+	Flags affected:
+	None
+*/
+static void op_23(struct gb_context *gb)
+{
+	CPU_incdec_16(&gb->HL.w, 0);
+}
 
-		Flags affected:
-		Z - Not affected
-		N - Reset
-		H - Set if carry from bit 11
-		C - Set if carry from bit 15
-		*/
-		CPU_add_16(&H, &L, &B, &C);
-		cycles = 8;
+/*
+	INC SP
 
-		PC++;
-		break;
-	}
-	case 0x19:
-	{
-		/*
-		ADD HL, DE
+	Description:
+	Increment register SP
 
-		Description:
-		Add DE to HL.
+	Flags affected:
+	None
+*/
+static void op_33(struct gb_context *gb)
+{
+	gb->SP++;
+}
 
-		Flags affected:
-		Z - Not affected
-		N - Reset
-		H - Set if carry from bit 11
-		C - Set if carry from bit 15
-		*/
-		CPU_add_16(&H, &L, &D, &E);
-		cycles = 8;
+/*
+	DEC BC
 
-		PC++;
-		break;
-	}
-	case 0x29:
-	{
-		/*
-		ADD HL, HL
+	Description:
+	Decrement register BC
 
-		Description:
-		Add HL to HL.
+	Flags affected:
+	None
+*/
+static void op_0B(struct gb_context *gb)
+{
+	CPU_incdec_16(&gb->BC.w, 1);
+}
 
-		Flags affected:
-		Z - Not affected
-		N - Reset
-		H - Set if carry from bit 11
-		C - Set if carry from bit 15
-		*/
-		CPU_add_16(&H, &L, &H, &L);
-		cycles = 8;
+/*
+	DEC DE
 
-		PC++;
-		break;
-	}
-	case 0x39:
-	{
-		/*
-		ADD HL, SP
+	Description:
+	Decrement register DE
 
-		Description:
-		Add SP to HL.
+	Flags affected:
+	None
+*/
+static void op_1B(struct gb_context *gb)
+{
+	CPU_incdec_16(&gb->DE.w, 1);
+}
 
-		Flags affected:
-		Z - Not affected
-		N - Reset
-		H - Set if carry from bit 11
-		C - Set if carry from bit 15
-		*/
+/*
+	DEC HL
 
-		/* We need to convert SP into bytes for the addition */
-		byte temp1, temp2;
-		convert_to_bytes(&temp1, &temp2, &SP);
+	Description:
+	Decrement register HL
 
-		CPU_add_16(&H, &L, &temp1, &temp2);
-		cycles = 8;
+	Flags affected:
+	None
+*/
+static void op_2B(struct gb_context *gb)
+{
+	CPU_incdec_16(&gb->HL.w, 1);
+}
 
-		PC++;
-		break;
-	}
-	case 0xE8:
-	{
-		/*
-		ADD SP, n
+/*
+	DEC SP
 
-		Description:
-		Add immediate byte to Stack Pointer.
+	Description:
+	Decrement register SP
 
-		Use with:
-		Signed one byte immediate value
+	Flags affected:
+	None
+*/
+static void op_3B(struct gb_context *gb)
+{
+	gb->SP--;
+}
 
-		Flags affected:
-		Z - Reset
-		N - Reset
-		H - Set or reset according to operation
-		C - Set or reset according to operation
-		*/
-		/* Get immediate value */
-		byte temp = memory_readb(PC+1);
+/* +++++ ROTATES AND SHIFTS +++++ */
 
-		CPU_add_sp_n(temp);
-		PC += 2;
-		cycles = 16;
+/*
+	RLCA
 
-		break;
-	}
-	case 0x03:
-	{
-		/*
-		INC BC
+	Description:
+	Rotate A left. Old bit 7 to Carry flag.
 
-		Description:
-		Increment register BC
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Reset
+	C - Contains old bit 7 data
+*/
+static void op_07(struct gb_context *gb)
+{
+	CPU_rotate(gb, &gb->AF.b.hi, 0);
+}
 
-		Flags affected:
-		None
-		*/
-		CPU_incdec_16(&B, &C, 0);
-		PC++;
+/*
+	RLA
 
-		cycles = 8;
-		break;
-	}
-	case 0x13:
-	{
-		/*
-		INC DE
+	Description:
+	Rotate A left through Carry flag.
 
-		Description:
-		Increment register DE
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Reset
+	C - Contains old bit 7 data
+*/
+static void op_17(struct gb_context *gb)
+{
+	CPU_rotate_through(gb, &gb->AF.b.hi, 0);
+}
 
-		Flags affected:
-		None
-		*/
-		CPU_incdec_16(&D, &E, 0);
-		PC++;
+/*
+	RRCA
 
-		cycles = 8;
-		break;
-	}
-	case 0x23:
-	{
-		/*
-		INC HL
+	Description:
+	Rotate A right. Old bit 0 to Carry flag.
 
-		Description:
-		Increment register HL
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Reset
+	C - Contains old bit 7 data
+*/
+static void op_0F(struct gb_context *gb)
+{
+	CPU_rotate(gb, &gb->AF.b.hi, 1);
+}
 
-		Flags affected:
-		None
-		*/
-		CPU_incdec_16(&H, &L, 0);
-		PC++;
+/*
+	RRA
 
-		cycles = 8;
-		break;
-	}
-	case 0x33:
-	{
-		/*
-		INC SP
+	Description:
+	Rotate A right through carry flag
 
-		Description:
-		Increment register SP
+	Flags affected:
+	Z - Set if result is 0
+	N - Reset
+	H - Reset
+	C - Contains old bit 0 data
+*/
+static void op_1F(struct gb_context *gb)
+{
+	CPU_rotate_through(gb, &gb->AF.b.hi, 1);
+}
 
-		Flags affected:
-		None
-		*/
-		SP++;
-		PC++;
+/* ++++++ END ROTATE/SHIFTS ++++++ */
 
-		cycles = 8;
-		break;
-	}
-	case 0x0B:
-	{
-		/*
-		DEC BC
+/* +++++ CALLS/RESTARTS/RETURNS +++++ */
 
-		Description:
-		Decrement register BC
+/*
+	CALL nn
 
-		Flags affected:
-		None
-		*/
-		CPU_incdec_16(&B, &C, 1);
-		PC++;
+	Description:
+	Push address of next instruction onto the stack then
+	jump to address nn
 
-		cycles = 8;
-		break;
-	}
-	case 0x1B:
-	{
-		/*
-		DEC DE
+	Use with:
+	nn = two-byte immediate address (LS byte first)
+*/
+static void op_CD(struct gb_context *gb)
+{
+	CPU_call(gb);
+}
 
-		Description:
-		Decrement register DE
+/*
+	CALL NZ, nn
 
-		Flags affected:
-		None
-		*/
-		CPU_incdec_16(&D, &E, 1);
-		PC++;
+	Description:
+	If Z flag reset, push address of next instruction onto the
+	stack then jump to address nn
 
-		cycles = 8;
-		break;
-	}
-	case 0x2B:
+	Use with:
+	nn = two-byte immediate address (LS byte first)
+*/
+static void op_C4(struct gb_context *gb)
+{
+	if(!CPU_flag_Z(gb))
 	{
-		/*
-		DEC HL
+		CPU_call(gb);
+		gb->cycles += CALL_TAKEN_CYCLES;
+	}
+}
 
-		Description:
-		Decrement register HL
+/*
+	CALL Z, nn
 
-		Flags affected:
-		None
-		*/
-		CPU_incdec_16(&H, &L, 1);
-		PC++;
+	Description:
+	If Z flag is set, push address of next instruction onto the
+	stack then jump to address nn
 
-		cycles = 8;
-		break;
-	}
-	case 0x3B:
+	Use with:
+	nn = two-byte immediate address (LS byte first)
+*/
+static void op_CC(struct gb_context *gb)
+{
+	if(CPU_flag_Z(gb))
 	{
-		/*
-		DEC SP
-
-		Description:
-		Decrement register SP
+		CPU_call(gb);
+		gb->cycles += CALL_TAKEN_CYCLES;
+	}
+}
 
-		Flags affected:
-		None
-		*/
-		SP--;
-		PC++;
+/*
+	CALL NC, nn
 
-		cycles = 8;
-		break;
-	}
+	Description:
+	If C flag reset, push address of next instruction onto the
+	stack then jump to address nn
 
-	
-		/* +++++ ROTATES AND SHIFTS +++++ */
-	case 0x07:
+	Use with:
+	nn = two-byte immediate address (LS byte first)
+*/
+static void op_D4(struct gb_context *gb)
+{
+	if(!CPU_flag_C(gb))
 	{
-		/*
-		RLCA
+		CPU_call(gb);
+		gb->cycles += CALL_TAKEN_CYCLES;
+	}
+}
 
-		Description:
-		Rotate A left. Old bit 7 to Carry flag.
+/*
+	CALL C, nn
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Reset
-		C - Contains old bit 7 data
-		*/
-		CPU_rotate(&A, 0);
+	Description:
+	If C flag is set, push address of next instruction onto the
+	stack then jump to address nn
 
-		PC++;
-		cycles = 4;
-		break;
-	}
-	case 0x17:
+	Use with:
+	nn = two-byte immediate address (LS byte first)
+*/
+static void op_DC(struct gb_context *gb)
+{
+	if(CPU_flag_C(gb))
 	{
-		/*
-		RLA
-
-		Description:
-		Rotate A left through Carry flag.
+		CPU_call(gb);
+		gb->cycles += CALL_TAKEN_CYCLES;
+	}
+}
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Reset
-		C - Contains old bit 7 data
-		*/
-		CPU_rotate_through(&A, 0);
+/*
+	RST 0x00
 
-		PC++;
-		cycles = 4;
-		break;
-	}
-	case 0x0F:
-	{
-		/*
-		RRCA
+	Description:
+	Push present address onto stack;
+	jump to 0x0000
+*/
+static void op_C7(struct gb_context *gb)
+{
+	CPU_restart(gb, 0x00);
+}
 
-		Description:
-		Rotate A right. Old bit 0 to Carry flag.
+/*
+	RST 0x08
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Reset
-		C - Contains old bit 7 data
-		*/
-		CPU_rotate(&A, 1);
+	Description:
+	Push present address onto stack;
+	jump to 0x0008
+*/
+static void op_CF(struct gb_context *gb)
+{
+	CPU_restart(gb, 0x08);
+}
 
-		PC++;
-		cycles = 4;
-		break;
-	}
-	case 0x1F:
-	{
-		/*
-		RRA
+/*
+	RST 0x10
 
-		Description:
-		Rotate A right through carry flag
+	Description:
+	Push present address onto stack;
+	jump to 0x0010
+*/
+static void op_D7(struct gb_context *gb)
+{
+	CPU_restart(gb, 0x10);
+}
 
-		Flags affected:
-		Z - Set if result is 0
-		N - Reset
-		H - Reset
-		C - Contains old bit 0 data
-		*/
-		CPU_rotate_through(&A, 1);
+/*
+	RST 0x18
 
-		PC++;
-		cycles = 4;
-		break;
-	}
-		/* ++++++ END ROTATE/SHIFTS ++++++ */
+	Description:
+	Push present address onto stack;
+	jump to 0x0018
+*/
+static void op_DF(struct gb_context *gb)
+{
+	CPU_restart(gb, 0x18);
+}
 
-		/* +++++ CALLS/RESTARTS/RETURNS +++++ */
-	case 0xCD:
-	{
-		/*
-		CALL nn
+/*
+	RST 0x20
 
-		Description:
-		Push address of next instruction onto the stack then
-		jump to address nn
+	Description:
+	Push present address onto stack;
+	jump to 0x0020
+*/
+static void op_E7(struct gb_context *gb)
+{
+	CPU_restart(gb, 0x20);
+}
 
-		Use with:
-		nn = two-byte immediate address (LS byte first)
-		*/
-		CPU_call();
+/*
+	RST 0x28
 
-		cycles = 12;
-		break;
-	}
-	case 0xC4:
-	{
-		/*
-		CALL NZ, nn
+	Description:
+	Push present address onto stack;
+	jump to 0x0028
+*/
+static void op_EF(struct gb_context *gb)
+{
+	CPU_restart(gb, 0x28);
+}
 
-		Description:
-		If Z flag reset, push address of next instruction onto the
-		stack then jump to address nn
+/*
+	RST 0x30
 
-		Use with:
-		nn = two-byte immediate address (LS byte first)
-		*/
+	Description:
+	Push present address onto stack;
+	jump to 0x0030
+*/
+static void op_F7(struct gb_context *gb)
+{
+	CPU_restart(gb, 0x30);
+}
 
-		if(!F.Z)
-			CPU_call();
-		else
-			PC += 3;
+/*
+	RST 0x38
 
-		cycles = 12;
-		break;
-	}
-	case 0xCC:
-	{
-		/*
-		CALL Z, nn
+	Description:
+	Push present address onto stack;
+	jump to 0x0038
+*/
+static void op_FF(struct gb_context *gb)
+{
+	CPU_restart(gb, 0x38);
+}
 
-		Description:
-		If Z flag is set, push address of next instruction onto the
-		stack then jump to address nn
+/*
+	RET
 
-		Use with:
-		nn = two-byte immediate address (LS byte first)
-		*/
+	Description:
+	Pop two bytes from the stack and jump to it
+*/
+static void op_C9(struct gb_context *gb)
+{
+	CPU_return(gb);
+}
 
-		if(F.Z)
-			CPU_call();
-		else
-			PC += 3;
+/*
+	RET NZ
 
-		cycles = 12;
-		break;
-	}
-	case 0xD4:
+	Description:
+	Return if Zero flag is reset
+*/
+static void op_C0(struct gb_context *gb)
+{
+	if(!CPU_flag_Z(gb))
 	{
-		/*
-		CALL NC, nn
+		CPU_return(gb);
+		gb->cycles += CALL_TAKEN_CYCLES;
+	}
+}
 
-		Description:
-		If C flag reset, push address of next instruction onto the
-		stack then jump to address nn
+/*
+	RET Z
 
-		Use with:
-		nn = two-byte immediate address (LS byte first)
-		*/
+	Description:
+	Return if Zero flag is set
+*/
+static void op_C8(struct gb_context *gb)
+{
+	if(CPU_flag_Z(gb))
+	{
+		CPU_return(gb);
+		gb->cycles += CALL_TAKEN_CYCLES;
+	}
+}
 
-		if(!F.C)
-			CPU_call();
-		else
-			PC += 3;
+/*
+	RET NC
 
-		cycles = 12;
-		break;
-	}
-	case 0xDC:
+	Description:
+	Return if Carry flag is reset
+*/
+static void op_D0(struct gb_context *gb)
+{
+	if(!CPU_flag_C(gb))
 	{
-		/*
-		CALL C, nn
+		CPU_return(gb);
+		gb->cycles += CALL_TAKEN_CYCLES;
+	}
+}
 
-		Description:
-		If C flag is set, push address of next instruction onto the
-		stack then jump to address nn
+/*
+	RET C
 
-		Use with:
-		nn = two-byte immediate address (LS byte first)
-		*/
+	Description:
+	Return if Carry flag is set
+*/
+static void op_D8(struct gb_context *gb)
+{
+	if(CPU_flag_C(gb))
+	{
+		CPU_return(gb);
+		gb->cycles += CALL_TAKEN_CYCLES;
+	}
+}
 
-		if(F.C)
-			CPU_call();
-		else
-			PC += 3;
+/*
+	RETI
 
-		cycles = 12;
-		break;
-	}
-	case 0xC7:
-	{
-		/*
-		RST 0x00
+	Description:
+	Same as normal return, but also enable intercepts
+*/
+static void op_D9(struct gb_context *gb)
+{
+	CPU_return(gb);
 
-		Description:
-		Push present address onto stack;
-		jump to 0x0000
-		*/
-		CPU_restart(0x00);
+	TRACE1(TRACE_RETI, gb->PC);
 
-		cycles = 32;
-		break;
-	}
-	case 0xCF:
-	{
-		/*
-		RST 0x08
+	/* Looks like RETI enabled interrupts immediately */
+	/*ie = 1;*/
 
-		Description:
-		Push present address onto stack;
-		jump to 0x0008
-		*/
-		CPU_restart(0x08);
+	gb->interrupt_direction = 1;
+	CPU_interrupt_switch(gb);
+}
 
-		cycles = 32;
-		break;
-	}
-	case 0xD7:
-	{
-		/*
-		RST 0x10
+/* +++++ END CALLS/RESTARTS/RETURNS +++++ */
 
-		Description:
-		Push present address onto stack;
-		jump to 0x0010
-		*/
-		CPU_restart(0x10);
+/* ++++++ JUMPS ++++++ */
 
-		cycles = 32;
-		break;
-	}
-	case 0xDF:
-	{
-		/*
-		RST 0x18
+/*
+	JP nn
 
-		Description:
-		Push present address onto stack;
-		jump to 0x0018
-		*/
-		CPU_restart(0x18);
+	Description:
+	Jump to address nn.
 
-		cycles = 32;
-		break;
-	}
-	case 0xE7:
-	{
-		/*
-		RST 0x20
+	Use with:
+	nn = two byte immediate value. (LS byte first.)
+*/
+static void op_C3(struct gb_context *gb)
+{
+	CPU_jump(gb, 0, gb->operand16, 0);
+}
 
-		Description:
-		Push present address onto stack;
-		jump to 0x0020
-		*/
-		CPU_restart(0x20);
+/*
+	JP cc(NZ), nn
 
-		cycles = 32;
-		break;
-	}
-	case 0xEF:
-	{
-		/*
-		RST 0x28
+	Description:
+	Jump to address nn if Z flag is reset
 
-		Description:
-		Push present address onto stack;
-		jump to 0x0028
-		*/
-		CPU_restart(0x28);
+	Use with:
+	nn = two byte immediate value. (LS byte first.)
+*/
+static void op_C2(struct gb_context *gb)
+{
+	/* If condition is false, PC already points past the jump */
+	if(CPU_jump(gb, CPU_flag_Z(gb), gb->operand16, 0))
+		gb->cycles += JUMP_TAKEN_CYCLES;
+}
 
-		cycles = 32;
-		break;
-	}
-	case 0xF7:
-	{
-		/*
-		RST 0x30
+/*
+	JP cc(Z), nn
 
-		Description:
-		Push present address onto stack;
-		jump to 0x0030
-		*/
-		CPU_restart(0x30);
+	Description:
+	Jump to address nn if Z flag is set
 
-		cycles = 32;
-		break;
-	}
-	case 0xFF:
-	{
-		/*
-		RST 0x38
+	Use with:
+	nn = two byte immediate value. (LS byte first.)
+*/
+static void op_CA(struct gb_context *gb)
+{
+	/* If condition is false, PC already points past the jump */
+	if(CPU_jump(gb, CPU_flag_Z(gb), gb->operand16, 1))
+		gb->cycles += JUMP_TAKEN_CYCLES;
+}
 
-		Description:
-		Push present address onto stack;
-		jump to 0x0038
-		*/
-		CPU_restart(0x38);
+/*
+	JP cc(NC), nn
 
-		cycles = 32;
-		break;
-	}
-	case 0xC9:
-	{
-		/*
-		RET
+	Description:
+	Jump to address nn if C flag is reset
 
-		Description:
-		Pop two bytes from the stack and jump to it
-		*/
-		CPU_return();
+	Use with:
+	nn = two byte immediate value. (LS byte first.)
+*/
+static void op_D2(struct gb_context *gb)
+{
+	/* If condition is false, PC already points past the jump */
+	if(CPU_jump(gb, CPU_flag_C(gb), gb->operand16, 0))
+		gb->cycles += JUMP_TAKEN_CYCLES;
+}
 
-		cycles = 8;
-		break;
-	}
-	case 0xC0:
-	{
-		/*
-		RET NZ
+/*
+	JP cc(C), nn
 
-		Description:
-		Return if Zero flag is reset
-		*/
+	Description:
+	Jump to address nn if C flag is set
 
-		if(!F.Z)
-			CPU_return();
-		else
-			PC++;
+	Use with:
+	nn = two byte immediate value. (LS byte first.)
+*/
+static void op_DA(struct gb_context *gb)
+{
+	/* If condition is false, PC already points past the jump */
+	if(CPU_jump(gb, CPU_flag_C(gb), gb->operand16, 1))
+		gb->cycles += JUMP_TAKEN_CYCLES;
+}
 
-		cycles = 8;
-		break;
-	}
-	case 0xC8:
-	{
-		/*
-		RET Z
+/*
+	JP (HL)
 
-		Description:
-		Return if Zero flag is set
-		*/
+	Description:
+	Jump to the address contained in the HL register
+*/
+static void op_E9(struct gb_context *gb)
+{
+	word address;
 
-		if(F.Z)
-			CPU_return();
-		else
-			PC++;
+	address = gb->HL.w;
 
-		cycles = 8;
-		break;
-	}
-	case 0xD0:
-	{
-		/*
-		RET NC
+	CPU_jump(gb, 0, address, 0);
+}
 
-		Description:
-		Return if Carry flag is reset
-		*/
+/*
+	JR n
 
-		if(!F.C)
-			CPU_return();
-		else
-			PC++;
+	Description:
+	Add n to the current address and jump to it
 
-		cycles = 8;
-		break;
-	}
-	case 0xD8:
-	{
-		/*
-		RET C
+	Use with:
+	n = one byte signed immediate value
+*/
+static void op_18(struct gb_context *gb)
+{
+	s_byte nextb = gb->operand8;
 
-		Description:
-		Return if Carry flag is set
-		*/
+	CPU_jump(gb, 0, (gb->PC + nextb), 0);
+}
 
-		if(F.C)
-			CPU_return();
-		else
-			PC++;
+/*
+	JR cc(NZ), n
 
-		cycles = 8;
-		break;
-	}
-	case 0xD9:
-	{
-		/*
-		RETI
+	Description:
+	If Z flag is reset, add n to current address and jump to it
 
-		Description:
-		Same as normal return, but also enable intercepts
-		*/
-		CPU_return();
+	Use with:
+	n = one byte signed immediate value
+*/
+static void op_20(struct gb_context *gb)
+{
+	s_byte nextb = gb->operand8;
 
-		/*delet me*/
-		printf("RETI D9 PC: %X\n", PC);
+	TRACE5(TRACE_JR, gb->PC, CPU_flag_Z(gb), gb->PC, nextb,
+		(word)(gb->PC + nextb));
+	/* If condition is false, PC already points past the jump */
+	if(CPU_jump(gb, CPU_flag_Z(gb), (gb->PC + nextb), 0))
+		gb->cycles += JUMP_TAKEN_CYCLES;
+}
 
-		/* Looks like RETI enabled interrupts immediately */
-		/*ie = 1;*/
+/*
+	JR cc(Z), n
 
-		interrupt_direction = 1;
-		interrupt_step = 2;
+	Description:
+	If Z flag is set, add n to current address and jump to it
 
-		cycles = 8;
-		break;
-	}
-		/* +++++ END CALLS/RESTARTS/RETURNS +++++ */
+	Use with:
+	n = one byte signed immediate value
+*/
+static void op_28(struct gb_context *gb)
+{
+	s_byte nextb = gb->operand8;
 
-		/* ++++++ JUMPS ++++++ */
-	case 0xC3:
-	{
-		/*
-		JP nn
+	/* If condition is false, PC already points past the jump */
+	if(CPU_jump(gb, CPU_flag_Z(gb), (gb->PC + nextb), 1))
+		gb->cycles += JUMP_TAKEN_CYCLES;
+}
 
-		Description:
-		Jump to address nn.
+/*
+	JR cc(NC), n
 
-		Use with:
-		nn = two byte immediate value. (LS byte first.)
-		*/
-		word address = convert_to16m(PC+1, PC+2);
+	Description:
+	If C flag is reset, add n to current address and jump to it
 
-		CPU_jump(0, address, 0);
-		cycles = 12;
-		break;
-	}
-	case 0xC2:
-	{
-		/*
-		JP cc(NZ), nn
+	Use with:
+	n = one byte signed immediate value
+*/
+static void op_30(struct gb_context *gb)
+{
+	s_byte nextb = gb->operand8;
 
-		Description:
-		Jump to address nn if Z flag is reset
+	/* If condition is false, PC already points past the jump */
+	if(CPU_jump(gb, CPU_flag_C(gb), (gb->PC + nextb), 0))
+		gb->cycles += JUMP_TAKEN_CYCLES;
+}
 
-		Use with:
-		nn = two byte immediate value. (LS byte first.)
-		*/
-		word address;
+/*
+	JR cc(C), n
 
-		address = convert_to16m(PC+1, PC+2);
+	Description:
+	If C flag is set, add n to current address and jump to it
 
-		/* If condition is false, increase PC, else, jump */
-		if(!CPU_jump(F.Z, address, 0))
-			PC += 3;
+	Use with:
+	n = one byte signed immediate value
+*/
+static void op_38(struct gb_context *gb)
+{
+	s_byte nextb = gb->operand8;
 
-		cycles = 12;
+	/* If condition is false, PC already points past the jump */
+	if(CPU_jump(gb, CPU_flag_C(gb), (gb->PC + nextb), 1))
+		gb->cycles += JUMP_TAKEN_CYCLES;
+}
 
-		break;
-	}
-	case 0xCA:
-	{
-		/*
-		JP cc(Z), nn
+/* END JUMPS */
 
-		Description:
-		Jump to address nn if Z flag is set
+/* MISC */
 
-		Use with:
-		nn = two byte immediate value. (LS byte first.)
-		*/
-		word address;
+/*
+	STOP
 
-		address = convert_to16m(PC+1, PC+2);
+	Description:
+	Halt CPU and LCD until button press
+*/
+static void op_10(struct gb_context *gb)
+{
+	/* TODO */
+}
 
-		/* If condition is false, increase PC, else, jump */
-		if(!CPU_jump(F.Z, address, 1))
-			PC += 3;
+/*
+	DI
 
-		cycles = 12;
+	Description:
+	Disable interupts after the next instruction
+*/
+static void op_F3(struct gb_context *gb)
+{
+	CPU_interrupt_switch(gb);
+
+	/*
+		Set interrupt direction to specify that
+		interrupts should be disabled after step
+		is zeroed
+	*/
+	gb->interrupt_direction = 0;
+}
 
-		break;
-	}
-	case 0xD2:
-	{
-		/*
-		JP cc(NC), nn
+/*
+	EI
 
-		Description:
-		Jump to address nn if C flag is reset
+	Description:
+	Enable interupts after the next instruction
+*/
+static void op_FB(struct gb_context *gb)
+{
+	CPU_interrupt_switch(gb);
+
+	/*
+		Set interrupt direction to specify that
+		interrupts should be disabled after step
+		is zeroed
+	*/
+	gb->interrupt_direction = 1;
+}
 
-		Use with:
-		nn = two byte immediate value. (LS byte first.)
-		*/
-		word address;
+/*
+	CPL
 
-		address = convert_to16m(PC+1, PC+2);
+	Description:
+	Complement A register
 
-		/* If condition is false, increase PC, else, jump */
-		if(!CPU_jump(F.C, address, 0))
-			PC += 3;
+	Flags affected:
+	Z - Not affected
+	N - Set
+	H - Set
+	C - Not affected
+*/
+static void op_2F(struct gb_context *gb)
+{
+	CPU_complement(&gb->AF.b.hi);
 
-		cycles = 12;
-		break;
-	}
-	case 0xDA:
-	{
-		/*
-		JP cc(C), nn
+	/* Z and C are kept, so bring them up to date first */
+	CPU_flags(gb);
+	gb->F.N = 1;
+	gb->F.H = 1;
+}
 
-		Description:
-		Jump to address nn if C flag is set
+/*
+	CCF
 
-		Use with:
-		nn = two byte immediate value. (LS byte first.)
-		*/
-		word address;
+	Description:
+	Complement Carry Flag
 
-		address = convert_to16m(PC+1, PC+2);
+	If Carry flag set, reset
+	If reset, set
 
-		/* If condition is false, increase PC, else, jump */
-		if(!CPU_jump(F.C, address, 1))
-			PC += 3;
+	Flags affected:
+	Z - Not affected
+	N - Reset
+	H - Reset
+	C - Complemented
+*/
+static void op_3F(struct gb_context *gb)
+{
+	CPU_flags(gb);
+	gb->F.N = 0;
+	gb->F.H = 0;
+
+	if(gb->F.C)
+		gb->F.C = 0;
+	else
+		gb->F.C = 1;
+}
 
-		cycles = 12;
-		break;
-	}
-	case 0xE9:
-	{
-		/*
-		JP (HL)
 
-		Description:
-		Jump to the address contained in the HL register
-		*/
-		word address;
+/*
+	The opcode table, indexed by the opcode byte. Opcodes without
+	a handler are not implemented yet.
 
-		convert_to_pair(&H, &L, &address);
-		/*address = swap_byte_order(&address);*/
+	Each entry: handler, instruction length in bytes, cycles
+*/
+const struct opcode CPU_opcodes[256] = {
+	{op_00, 1, 4},	/* 0x00 */
+	{op_01, 3, 12},	/* 0x01 */
+	{op_02, 1, 8},	/* 0x02 */
+	{op_03, 1, 8},	/* 0x03 */
+	{op_04, 1, 4},	/* 0x04 */
+	{op_05, 1, 4},	/* 0x05 */
+	{op_06, 2, 8},	/* 0x06 */
+	{op_07, 1, 4},	/* 0x07 */
+	{op_08, 3, 20},	/* 0x08 */
+	{op_09, 1, 8},	/* 0x09 */
+	{op_0A, 1, 8},	/* 0x0A */
+	{op_0B, 1, 8},	/* 0x0B */
+	{op_0C, 1, 4},	/* 0x0C */
+	{op_0D, 1, 4},	/* 0x0D */
+	{op_0E, 2, 8},	/* 0x0E */
+	{op_0F, 1, 4},	/* 0x0F */
+	{op_10, 2, 4},	/* 0x10 */
+	{op_11, 3, 12},	/* 0x11 */
+	{op_12, 1, 8},	/* 0x12 */
+	{op_13, 1, 8},	/* 0x13 */
+	{op_14, 1, 4},	/* 0x14 */
+	{op_15, 1, 4},	/* 0x15 */
+	{op_16, 2, 8},	/* 0x16 */
+	{op_17, 1, 4},	/* 0x17 */
+	{op_18, 2, 8},	/* 0x18 */
+	{op_19, 1, 8},	/* 0x19 */
+	{op_1A, 1, 8},	/* 0x1A */
+	{op_1B, 1, 8},	/* 0x1B */
+	{op_1C, 1, 4},	/* 0x1C */
+	{op_1D, 1, 4},	/* 0x1D */
+	{op_1E, 2, 8},	/* 0x1E */
+	{op_1F, 1, 4},	/* 0x1F */
+	{op_20, 2, 8},	/* 0x20 */
+	{op_21, 3, 12},	/* 0x21 */
+	{op_22, 1, 8},	/* 0x22 */
+	{op_23, 1, 8},	/* 0x23 */
+	{op_24, 1, 4},	/* 0x24 */
+	{op_25, 1, 4},	/* 0x25 */
+	{op_26, 2, 8},	/* 0x26 */
+	{NULL, 1, 0},		/* 0x27 */
+	{op_28, 2, 8},	/* 0x28 */
+	{op_29, 1, 8},	/* 0x29 */
+	{op_2A, 1, 8},	/* 0x2A */
+	{op_2B, 1, 8},	/* 0x2B */
+	{op_2C, 1, 4},	/* 0x2C */
+	{op_2D, 1, 4},	/* 0x2D */
+	{op_2E, 2, 8},	/* 0x2E */
+	{op_2F, 1, 4},	/* 0x2F */
+	{op_30, 2, 8},	/* 0x30 */
+	{op_31, 3, 12},	/* 0x31 */
+	{op_32, 1, 8},	/* 0x32 */
+	{op_33, 1, 8},	/* 0x33 */
+	{op_34, 1, 12},	/* 0x34 */
+	{op_35, 1, 12},	/* 0x35 */
+	{op_36, 2, 12},	/* 0x36 */
+	{NULL, 1, 0},		/* 0x37 */
+	{op_38, 2, 8},	/* 0x38 */
+	{op_39, 1, 8},	/* 0x39 */
+	{op_3A, 1, 8},	/* 0x3A */
+	{op_3B, 1, 8},	/* 0x3B */
+	{op_3C, 1, 4},	/* 0x3C */
+	{op_3D, 1, 4},	/* 0x3D */
+	{op_3E, 2, 8},	/* 0x3E */
+	{op_3F, 1, 4},	/* 0x3F */
+	{op_40, 1, 4},	/* 0x40 */
+	{op_41, 1, 4},	/* 0x41 */
+	{op_42, 1, 4},	/* 0x42 */
+	{op_43, 1, 4},	/* 0x43 */
+	{op_44, 1, 4},	/* 0x44 */
+	{op_45, 1, 4},	/* 0x45 */
+	{op_46, 1, 8},	/* 0x46 */
+	{op_47, 1, 4},	/* 0x47 */
+	{op_48, 1, 4},	/* 0x48 */
+	{op_49, 1, 4},	/* 0x49 */
+	{op_4A, 1, 4},	/* 0x4A */
+	{op_4B, 1, 4},	/* 0x4B */
+	{op_4C, 1, 4},	/* 0x4C */
+	{op_4D, 1, 4},	/* 0x4D */
+	{op_4E, 1, 8},	/* 0x4E */
+	{op_4F, 1, 4},	/* 0x4F */
+	{op_50, 1, 4},	/* 0x50 */
+	{op_51, 1, 4},	/* 0x51 */
+	{op_52, 1, 4},	/* 0x52 */
+	{op_53, 1, 4},	/* 0x53 */
+	{op_54, 1, 4},	/* 0x54 */
+	{op_55, 1, 4},	/* 0x55 */
+	{op_56, 1, 8},	/* 0x56 */
+	{op_57, 1, 4},	/* 0x57 */
+	{op_58, 1, 4},	/* 0x58 */
+	{op_59, 1, 4},	/* 0x59 */
+	{op_5A, 1, 4},	/* 0x5A */
+	{op_5B, 1, 4},	/* 0x5B */
+	{op_5C, 1, 4},	/* 0x5C */
+	{op_5D, 1, 4},	/* 0x5D */
+	{op_5E, 1, 8},	/* 0x5E */
+	{op_5F, 1, 4},	/* 0x5F */
+	{op_60, 1, 4},	/* 0x60 */
+	{op_61, 1, 4},	/* 0x61 */
+	{op_62, 1, 4},	/* 0x62 */
+	{op_63, 1, 4},	/* 0x63 */
+	{op_64, 1, 4},	/* 0x64 */
+	{op_65, 1, 4},	/* 0x65 */
+	{op_66, 1, 8},	/* 0x66 */
+	{op_67, 1, 4},	/* 0x67 */
+	{op_68, 1, 4},	/* 0x68 */
+	{op_69, 1, 4},	/* 0x69 */
+	{op_6A, 1, 4},	/* 0x6A */
+	{op_6B, 1, 4},	/* 0x6B */
+	{op_6C, 1, 4},	/* 0x6C */
+	{op_6D, 1, 4},	/* 0x6D */
+	{op_6E, 1, 8},	/* 0x6E */
+	{op_6F, 1, 4},	/* 0x6F */
+	{op_70, 1, 8},	/* 0x70 */
+	{op_71, 1, 8},	/* 0x71 */
+	{op_72, 1, 8},	/* 0x72 */
+	{op_73, 1, 8},	/* 0x73 */
+	{op_74, 1, 8},	/* 0x74 */
+	{op_75, 1, 8},	/* 0x75 */
+	{NULL, 1, 0},		/* 0x76 */
+	{op_77, 1, 8},	/* 0x77 */
+	{op_78, 1, 4},	/* 0x78 */
+	{op_79, 1, 4},	/* 0x79 */
+	{op_7A, 1, 4},	/* 0x7A */
+	{op_7B, 1, 4},	/* 0x7B */
+	{op_7C, 1, 4},	/* 0x7C */
+	{op_7D, 1, 4},	/* 0x7D */
+	{op_7E, 1, 8},	/* 0x7E */
+	{op_7F, 1, 4},	/* 0x7F */
+	{op_80, 1, 4},	/* 0x80 */
+	{op_81, 1, 4},	/* 0x81 */
+	{op_82, 1, 4},	/* 0x82 */
+	{op_83, 1, 4},	/* 0x83 */
+	{op_84, 1, 4},	/* 0x84 */
+	{op_85, 1, 4},	/* 0x85 */
+	{op_86, 1, 8},	/* 0x86 */
+	{op_87, 1, 4},	/* 0x87 */
+	{op_88, 1, 4},	/* 0x88 */
+	{op_89, 1, 4},	/* 0x89 */
+	{op_8A, 1, 4},	/* 0x8A */
+	{op_8B, 1, 4},	/* 0x8B */
+	{op_8C, 1, 4},	/* 0x8C */
+	{op_8D, 1, 4},	/* 0x8D */
+	{op_8E, 1, 8},	/* 0x8E */
+	{op_8F, 1, 4},	/* 0x8F */
+	{op_90, 1, 4},	/* 0x90 */
+	{op_91, 1, 4},	/* 0x91 */
+	{op_92, 1, 4},	/* 0x92 */
+	{op_93, 1, 4},	/* 0x93 */
+	{op_94, 1, 4},	/* 0x94 */
+	{op_95, 1, 4},	/* 0x95 */
+	{op_96, 1, 8},	/* 0x96 */
+	{op_97, 1, 4},	/* 0x97 */
+	{op_98, 1, 4},	/* 0x98 */
+	{op_99, 1, 4},	/* 0x99 */
+	{op_9A, 1, 4},	/* 0x9A */
+	{op_9B, 1, 4},	/* 0x9B */
+	{op_9C, 1, 4},	/* 0x9C */
+	{op_9D, 1, 4},	/* 0x9D */
+	{op_9E, 1, 8},	/* 0x9E */
+	{op_9F, 1, 4},	/* 0x9F */
+	{op_A0, 1, 4},	/* 0xA0 */
+	{op_A1, 1, 4},	/* 0xA1 */
+	{op_A2, 1, 4},	/* 0xA2 */
+	{op_A3, 1, 4},	/* 0xA3 */
+	{op_A4, 1, 4},	/* 0xA4 */
+	{op_A5, 1, 4},	/* 0xA5 */
+	{op_A6, 1, 8},	/* 0xA6 */
+	{op_A7, 1, 4},	/* 0xA7 */
+	{op_A8, 1, 4},	/* 0xA8 */
+	{op_A9, 1, 4},	/* 0xA9 */
+	{op_AA, 1, 4},	/* 0xAA */
+	{op_AB, 1, 4},	/* 0xAB */
+	{op_AC, 1, 4},	/* 0xAC */
+	{op_AD, 1, 4},	/* 0xAD */
+	{op_AE, 1, 8},	/* 0xAE */
+	{op_AF, 1, 4},	/* 0xAF */
+	{op_B0, 1, 4},	/* 0xB0 */
+	{op_B1, 1, 4},	/* 0xB1 */
+	{op_B2, 1, 4},	/* 0xB2 */
+	{op_B3, 1, 4},	/* 0xB3 */
+	{op_B4, 1, 4},	/* 0xB4 */
+	{op_B5, 1, 4},	/* 0xB5 */
+	{op_B6, 1, 8},	/* 0xB6 */
+	{op_B7, 1, 4},	/* 0xB7 */
+	{op_B8, 1, 4},	/* 0xB8 */
+	{op_B9, 1, 4},	/* 0xB9 */
+	{op_BA, 1, 4},	/* 0xBA */
+	{op_BB, 1, 4},	/* 0xBB */
+	{op_BC, 1, 4},	/* 0xBC */
+	{op_BD, 1, 4},	/* 0xBD */
+	{op_BE, 1, 8},	/* 0xBE */
+	{op_BF, 1, 4},	/* 0xBF */
+	{op_C0, 1, 8},	/* 0xC0 */
+	{op_C1, 1, 12},	/* 0xC1 */
+	{op_C2, 3, 12},	/* 0xC2 */
+	{op_C3, 3, 12},	/* 0xC3 */
+	{op_C4, 3, 12},	/* 0xC4 */
+	{op_C5, 1, 16},	/* 0xC5 */
+	{op_C6, 2, 8},	/* 0xC6 */
+	{op_C7, 1, 32},	/* 0xC7 */
+	{op_C8, 1, 8},	/* 0xC8 */
+	{op_C9, 1, 8},	/* 0xC9 */
+	{op_CA, 3, 12},	/* 0xCA */
+	{NULL, 1, 0},		/* 0xCB */
+	{op_CC, 3, 12},	/* 0xCC */
+	{op_CD, 3, 12},	/* 0xCD */
+	{op_CE, 2, 8},	/* 0xCE */
+	{op_CF, 1, 32},	/* 0xCF */
+	{op_D0, 1, 8},	/* 0xD0 */
+	{op_D1, 1, 12},	/* 0xD1 */
+	{op_D2, 3, 12},	/* 0xD2 */
+	{NULL, 1, 0},		/* 0xD3 */
+	{op_D4, 3, 12},	/* 0xD4 */
+	{op_D5, 1, 16},	/* 0xD5 */
+	{op_D6, 2, 8},	/* 0xD6 */
+	{op_D7, 1, 32},	/* 0xD7 */
+	{op_D8, 1, 8},	/* 0xD8 */
+	{op_D9, 1, 8},	/* 0xD9 */
+	{op_DA, 3, 12},	/* 0xDA */
+	{NULL, 1, 0},		/* 0xDB */
+	{op_DC, 3, 12},	/* 0xDC */
+	{NULL, 1, 0},		/* 0xDD */
+	{op_DE, 2, 8},	/* 0xDE */
+	{op_DF, 1, 32},	/* 0xDF */
+	{op_E0, 2, 12},	/* 0xE0 */
+	{op_E1, 1, 12},	/* 0xE1 */
+	{op_E2, 1, 8},	/* 0xE2 */
+	{NULL, 1, 0},		/* 0xE3 */
+	{NULL, 1, 0},		/* 0xE4 */
+	{op_E5, 1, 16},	/* 0xE5 */
+	{op_E6, 2, 8},	/* 0xE6 */
+	{op_E7, 1, 32},	/* 0xE7 */
+	{op_E8, 2, 16},	/* 0xE8 */
+	{op_E9, 1, 4},	/* 0xE9 */
+	{op_EA, 3, 16},	/* 0xEA */
+	{NULL, 1, 0},		/* 0xEB */
+	{NULL, 1, 0},		/* 0xEC */
+	{NULL, 1, 0},		/* 0xED */
+	{op_EE, 2, 8},	/* 0xEE */
+	{op_EF, 1, 32},	/* 0xEF */
+	{op_F0, 2, 12},	/* 0xF0 */
+	{op_F1, 1, 12},	/* 0xF1 */
+	{op_F2, 1, 8},	/* 0xF2 */
+	{op_F3, 1, 4},	/* 0xF3 */
+	{NULL, 1, 0},		/* 0xF4 */
+	{op_F5, 1, 16},	/* 0xF5 */
+	{op_F6, 2, 8},	/* 0xF6 */
+	{op_F7, 1, 32},	/* 0xF7 */
+	{op_F8, 2, 12},	/* 0xF8 */
+	{op_F9, 1, 8},	/* 0xF9 */
+	{op_FA, 3, 16},	/* 0xFA */
+	{op_FB, 1, 4},	/* 0xFB */
+	{NULL, 1, 0},		/* 0xFC */
+	{NULL, 1, 0},		/* 0xFD */
+	{op_FE, 2, 8},	/* 0xFE */
+	{op_FF, 1, 32},	/* 0xFF */
+};
 
-		CPU_jump(0, address, 0);
-		cycles = 4;
-		break;
-	}
-	case 0x18:
-	{
-		/*
-		JR n
+/*
+	Execute a single base instruction
 
-		Description:
-		Add n to the current address and jump to it
+	The operands of the instruction are read into operand8/operand16
+	and PC is moved past the instruction before the handler runs, so
+	handlers which jump just overwrite PC and relative jumps are taken
+	from the address of the next instruction.
 
-		Use with:
-		n = one byte signed immediate value
-		*/
-		s_byte nextb = memory_readb(PC + 1);
+	Returns 0 on success, -1 if the opcode isn't handled.
+*/
+int CPU(struct gb_context *gb, word op)
+{
+	const struct opcode *entry;
 
-		CPU_jump(0, (PC + nextb), 0);
-		cycles = 8;
-		break;
-	}
-	case 0x20:
-	{
-		/*
-		JR cc(NZ), n
+	/*
+		CB -
 
 		Description:
-		If Z flag is reset, add n to current address and jump to it
-
-		Use with:
-		n = one byte signed immediate value
-		*/
-		s_byte nextb = memory_readb(PC + 1);
-		/* updated TODO jumps seem funky, they should PC+=2 no matter what? 
-			TODO updated similar one byte immediate jumps to do this
-			refer back to this before shipping*/
+		The Gameboy has an extended instruction set prefixed
+		by CB. Here we will increment PC and call CPU_EXTENDED
+		to handle the additional jump table
+	*/
+	if(op == 0xCB)
+	{
+		gb->PC++;
 
-		printf("DBG JRCC PC: %X; Z: %X\n", PC, F.Z);
-		printf("DBG JRCC PC+nb: %X+%X(%i): %X\n", PC, nextb, nextb, PC+nextb);
-		/* If condition is false, increase PC, else, jump */
-		CPU_jump(F.Z, (PC + nextb), 0);
+		return CPU_EXTENDED(gb, memory_readb(gb, gb->PC));
+	}
 
+	entry = &CPU_opcodes[op];
 
-		/* TODO this is how these jumps were before minus the else part */
-		/*if(!CPU_jump(F.Z, (PC + nextb), 0))
-			PC += 2;*/
-		/*else
-		{
-			printf("DBG JRCC ELSE PC+=2: %X\n", PC+2);*/
-			/* THIS IS A HACK, FIGURE OUT WTF IS GOING ON TODO */
-			/*PC += 2;
-		}*/
-
-		PC += 2;
-		cycles = 8;
-		break;
-	}
-	case 0x28:
+	if(entry->execute == NULL)
 	{
-		/*
-		JR cc(Z), n
+		printf("OP not handled: 0x%.2X\n", op);
+		return -1;
+	}
 
-		Description:
-		If Z flag is set, add n to current address and jump to it
+	/* Fetch the immediate operands, if the instruction has any */
+	if(entry->length > 1)
+		gb->operand8 = memory_readb(gb, gb->PC + 1);
+	if(entry->length > 2)
+		gb->operand16 = convert_to16m(gb, gb->PC + 1, gb->PC + 2);
 
-		Use with:
-		n = one byte signed immediate value
-		*/
-		s_byte nextb = memory_readb(PC + 1);
-
-		/* If condition is false, increase PC, else, jump */
-		CPU_jump(F.Z, (PC + nextb), 1);
-		
-		PC += 2;
-		cycles = 8;
-		break;
-	}
-	case 0x30:
-	{
-		/*
-		JR cc(NC), n
+	gb->PC += entry->length;
+	gb->cycles = entry->cycles;
 
-		Description:
-		If C flag is reset, add n to current address and jump to it
+	entry->execute(gb);
 
-		Use with:
-		n = one byte signed immediate value
-		*/
-		s_byte nextb = memory_readb(PC + 1);
-
-		/* If condition is false, increase PC, else, jump */
-		CPU_jump(F.C, (PC + nextb), 0);
-		
-		PC += 2;
-		cycles = 8;
-		break;
-	}
-	case 0x38:
-	{
-		/*
-		JR cc(C), n
+	return 0;
+}
 
-		Description:
-		If C flag is set, add n to current address and jump to it
+#if defined(CPU_BLOCK_CACHE) || defined(CPU_JIT)
 
-		Use with:
-		n = one byte signed immediate value
-		*/
-		s_byte nextb = memory_readb(PC + 1);
-
-		/* If condition is false, increase PC, else, jump */
-		CPU_jump(F.C, (PC + nextb), 1);
-		
-		PC += 2;
-		cycles = 8;
-		break;
-	}
-		/* END JUMPS */
+/*
+	Block cache dispatch
 
-		/* MISC */
-	case 0x10:
-	{
-		/*
-		STOP
+	Built with -DCPU_BLOCK_CACHE. Instructions are run out of the
+	pre-decoded blocks in cpu_cache.c, so the operands, lengths and
+	cycles come straight from the block instead of being fetched
+	and looked up again on every pass through a loop.
 
-		Description:
-		Halt CPU and LCD until button press
-		*/
+	Built with -DCPU_JIT, blocks that keep getting run are also
+	handed to the recompiler in cpu_jit.c and their native code is
+	run instead. The interpreter still runs everything the JIT
+	can't translate.
+*/
+#if defined(CPU_JIT)
+const char CPU_dispatch_mode[] = "jit";
+#else
+const char CPU_dispatch_mode[] = "block cache";
+#endif
 
-		/* TODO */
+/*
+	Run instructions until one isn't handled, or until the frame
+	limit sets gb->stop
 
-		PC += 2;
-		cycles = 4;
-		break;
-	}
-	case 0xF3:
+	Returns the number of instructions executed.
+*/
+long CPU_run(struct gb_context *gb)
+{
+	struct cached_block *block;
+	struct cached_instruction *instruction, *last;
+	word next;
+	long count = 0;
+
+	while(!gb->stop)
 	{
-		/*
-		DI
+		block = CACHE_get_block(gb, gb->PC);
 
-		Description:
-		Disable interupts after the next instruction
-		*/
+		/* Nothing cacheable here, let CPU() deal with it */
+		if(block == NULL)
+		{
+			if(CPU(gb, memory_readb(gb, gb->PC)) < 0)
+				return count;
 
-		CPU_interrupt_switch();
+			CPU_tick(gb);
+			count++;
+			continue;
+		}
 
-		/*
-			Set interrupt direction to specify that
-			interrupts should be disabled after step
-			is zeroed
-		*/
-		interrupt_direction = 0;
+#if defined(CPU_JIT)
+		if(block->native == NULL && ++block->runs == JIT_THRESHOLD)
+			JIT_compile(gb, block);
 
-		break;
-	}
-	case 0xFB:
-	{
-		/*
-		EI
+		/* Compiling may have flushed the cache, block included */
+		if(!block->valid)
+			continue;
 
-		Description:
-		Enable interupts after the next instruction
-		*/
+		/* Native code syncs PC and cycles once, on exit */
+		if(block->native != NULL)
+		{
+			JIT_run(gb, block);
 
-		CPU_interrupt_switch();
+			CPU_tick(gb);
+			count += block->native_count;
+			continue;
+		}
+#endif
 
+		instruction = block->instructions;
+		last = instruction + block->count;
 
 		/*
-			Set interrupt direction to specify that
-			interrupts should be disabled after step
-			is zeroed
+			Leave the block early if an instruction or interrupt
+			moved PC somewhere else, if the block's code was
+			written over while it ran, once OAM DMA locks the
+			memory map, or at the frame limit
 		*/
-		interrupt_direction = 1;
+		do
+		{
+			gb->operand8 = instruction->operand8;
+			gb->operand16 = instruction->operand16;
+			next = gb->PC + instruction->length;
+			gb->PC = next;
+			gb->cycles = instruction->cycles;
 
-		break;
+			instruction->execute(gb);
+
+			CPU_tick(gb);
+			count++;
+			instruction++;
+		} while(instruction < last && gb->PC == next && block->valid &&
+			!gb->dma_active && !gb->stop);
 	}
-	case 0x2F:
-	{
-		/*
-		CPL
 
-		Description:
-		Complement A register
+	return count;
+}
 
-		Flags affected:
-		Z - Not affected
-		N - Set
-		H - Set
-		C - Not affected
-		*/
-		CPU_complement(&A);
+#elif defined(CPU_THREADED) && defined(__GNUC__)
 
-		F.N = 1;
-		F.H = 1;
+/*
+	Threaded dispatch
+
+	Built with -DCPU_THREADED on GCC (or anything else that knows
+	about labels as values). Every opcode gets its own copy of the
+	dispatch code below and jumps straight to the label of the next
+	opcode, instead of every instruction going through the one
+	indirect call in CPU(). Since each copy has its own indirect
+	jump, the host's branch predictor gets to learn which opcode
+	tends to follow which.
+
+	The table lookups use constant opcodes, so the compiler folds
+	the operand fetch, length and cycles into each copy, and drops
+	the check for a missing handler from the ones that have one.
+*/
+const char CPU_dispatch_mode[] = "threaded";
+
+/* Run the instruction for opcode n, then thread to the next one */
+#define THREAD(n) \
+	thread_##n: \
+	if(CPU_opcodes[0x##n].execute == NULL) \
+		goto thread_unhandled; \
+	if(CPU_opcodes[0x##n].length > 1) \
+		gb->operand8 = memory_readb(gb, gb->PC + 1); \
+	if(CPU_opcodes[0x##n].length > 2) \
+		gb->operand16 = convert_to16m(gb, gb->PC + 1, gb->PC + 2); \
+	gb->PC += CPU_opcodes[0x##n].length; \
+	gb->cycles = CPU_opcodes[0x##n].cycles; \
+	CPU_opcodes[0x##n].execute(gb); \
+	CPU_tick(gb); \
+	count++; \
+	if(gb->stop) \
+		return count; \
+	goto *threads[memory_readb(gb, gb->PC)];
+
+#define THREAD_ROW(h) \
+	THREAD(h##0) THREAD(h##1) THREAD(h##2) THREAD(h##3) \
+	THREAD(h##4) THREAD(h##5) THREAD(h##6) THREAD(h##7) \
+	THREAD(h##8) THREAD(h##9) THREAD(h##A) THREAD(h##B) \
+	THREAD(h##C) THREAD(h##D) THREAD(h##E) THREAD(h##F)
+
+#define THREAD_LABEL(n) &&thread_##n,
+
+#define THREAD_LABEL_ROW(h) \
+	THREAD_LABEL(h##0) THREAD_LABEL(h##1) THREAD_LABEL(h##2) \
+	THREAD_LABEL(h##3) THREAD_LABEL(h##4) THREAD_LABEL(h##5) \
+	THREAD_LABEL(h##6) THREAD_LABEL(h##7) THREAD_LABEL(h##8) \
+	THREAD_LABEL(h##9) THREAD_LABEL(h##A) THREAD_LABEL(h##B) \
+	THREAD_LABEL(h##C) THREAD_LABEL(h##D) THREAD_LABEL(h##E) \
+	THREAD_LABEL(h##F)
 
-		PC++;
-		cycles = 4;
-		break;
-	}
-	case 0x3F:
-	{
-		/*
-		CCF
+/*
+	Labels as values and computed gotos are what this is all about,
+	so -pedantic needn't warn about every one of them
+*/
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
 
-		Description:
-		Complement Carry Flag
+/*
+	Run instructions until one isn't handled, or until the frame
+	limit sets gb->stop
 
-		If Carry flag set, reset
-		If reset, set
+	Returns the number of instructions executed.
+*/
+long CPU_run(struct gb_context *gb)
+{
+	/*
+		The label of every opcode, filled in by the compiler so
+		that machines on different threads never race to set it
+		up. CB's label is the one dispatching through CPU_EXTENDED.
+	*/
+	static const void *const threads[256] = {
+		THREAD_LABEL_ROW(0) THREAD_LABEL_ROW(1) THREAD_LABEL_ROW(2)
+		THREAD_LABEL_ROW(3) THREAD_LABEL_ROW(4) THREAD_LABEL_ROW(5)
+		THREAD_LABEL_ROW(6) THREAD_LABEL_ROW(7) THREAD_LABEL_ROW(8)
+		THREAD_LABEL_ROW(9) THREAD_LABEL_ROW(A) THREAD_LABEL_ROW(B)
+		THREAD_LABEL_ROW(C) THREAD_LABEL_ROW(D) THREAD_LABEL_ROW(E)
+		THREAD_LABEL_ROW(F)
+	};
+	long count = 0;
+
+	goto *threads[memory_readb(gb, gb->PC)];
+
+	THREAD_ROW(0) THREAD_ROW(1) THREAD_ROW(2) THREAD_ROW(3)
+	THREAD_ROW(4) THREAD_ROW(5) THREAD_ROW(6) THREAD_ROW(7)
+	THREAD_ROW(8) THREAD_ROW(9) THREAD_ROW(A) THREAD_ROW(B)
+
+	THREAD(C0) THREAD(C1) THREAD(C2) THREAD(C3)
+	THREAD(C4) THREAD(C5) THREAD(C6) THREAD(C7)
+	THREAD(C8) THREAD(C9) THREAD(CA) THREAD(CC)
+	THREAD(CD) THREAD(CE) THREAD(CF)
+
+	THREAD_ROW(D) THREAD_ROW(E) THREAD_ROW(F)
+
+thread_CB:
+	gb->PC++;
+
+	if(CPU_EXTENDED(gb, memory_readb(gb, gb->PC)) < 0)
+		return count;
+
+	CPU_tick(gb);
+	count++;
+	if(gb->stop)
+		return count;
+	goto *threads[memory_readb(gb, gb->PC)];
+
+thread_unhandled:
+	/* Let CPU() report the opcode */
+	CPU(gb, memory_readb(gb, gb->PC));
+
+	return count;
+}
 
-		Flags affected:
-		Z - Not affected
-		N - Reset
-		H - Reset
-		C - Complemented
-		*/
-		F.N = 0;
-		F.H = 0;
+#pragma GCC diagnostic pop
 
-		if(F.C)
-			F.C = 0;
-		else
-			F.C = 1;
+#else
 
-		PC++;
-		cycles = 4;
-		break;
-	}
+/*
+	Portable dispatch, every instruction goes through CPU() and
+	its table lookup.
+*/
+const char CPU_dispatch_mode[] = "table";
 
-	default:
+/*
+	Run instructions until one isn't handled, or until the frame
+	limit sets gb->stop
+
+	Returns the number of instructions executed.
+*/
+long CPU_run(struct gb_context *gb)
+{
+	long count = 0;
+
+	while(!gb->stop && CPU(gb, memory_readb(gb, gb->PC)) == 0)
 	{
-		printf("OP not handled: 0x%.2X\n", op);
-		result--;
-		break;
+		CPU_tick(gb);
+		count++;
 	}
 
-	} /* Lost? This is where the switch ends. */
-
-	return result;
+	return count;
 }
+
+#endif
@@ -21,314 +21,537 @@
 
 /* Jump table for the extended CPU instructions */
 #include <stdio.h>
+#include "gb.h"
 #include "cpu.h"
 #include "memory.h"
 
-/* Emulation for the extended CPU instructions */
-int CPU_EXTENDED(word OP)
+/* ++++++ MISC +++++ */
+
+/*
+	SWAP A
+
+	Description:
+	Swap the lower and upper nibbles of A
+
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Reset
+	C - Reset
+*/
+static void cb_37(struct gb_context *gb)
 {
-	switch(OP)
-	{
+	CPU_swap(gb, &gb->AF.b.hi);
+}
 
-	/* ++++++ MISC +++++ */
+/*
+	SWAP B
 
-	case 0x37:
-	{
-		/*
-		SWAP A
-
-		Description:
-		Swap the lower and upper nibbles of A
-
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Reset
-		C - Reset
-		*/
-		CPU_swap(&A);
-
-		PC += 2;
-		cycles = 8;
-		break;
-	}
-	case 0x30:
-	{
-		/*
-		SWAP B
-
-		Description:
-		Swap the lower and upper nibbles of B
-
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Reset
-		C - Reset
-		*/
-		CPU_swap(&B);
-
-		PC += 2;
-		cycles = 8;
-		break;
-	}
-	case 0x31:
-	{
-		/*
-		SWAP C
-
-		Description:
-		Swap the lower and upper nibbles of C
-
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Reset
-		C - Reset
-		*/
-		CPU_swap(&C);
-
-		PC += 2;
-		cycles = 8;
-		break;
-	}
-	case 0x32:
-	{
-		/*
-		SWAP D
-
-		Description:
-		Swap the lower and upper nibbles of D
-
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Reset
-		C - Reset
-		*/
-		CPU_swap(&D);
-
-		PC += 2;
-		cycles = 8;
-		break;
-	}
-	case 0x33:
-	{
-		/*
-		SWAP E
-
-		Description:
-		Swap the lower and upper nibbles of E
-
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Reset
-		C - Reset
-		*/
-		CPU_swap(&E);
-
-		PC += 2;
-		cycles = 8;
-		break;
-	}
-	case 0x34:
-	{
-		/*
-		SWAP H
-
-		Description:
-		Swap the lower and upper nibbles of H
-
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Reset
-		C - Reset
-		*/
-		CPU_swap(&H);
-
-		PC += 2;
-		cycles = 8;
-		break;
-	}
-	case 0x35:
-	{
-		/*
-		SWAP L
-
-		Description:
-		Swap the lower and upper nibbles of L
-
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Reset
-		C - Reset
-		*/
-		CPU_swap(&L);
-
-		PC += 2;
-		cycles = 8;
-		break;
-	}
-	case 0x36:
-	{
-		/*
-		SWAP (HL)
+	Description:
+	Swap the lower and upper nibbles of B
 
-		Description:
-		Swap the lower and upper nibbles of the location
-		pointed to by HL
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Reset
+	C - Reset
+*/
+static void cb_30(struct gb_context *gb)
+{
+	CPU_swap(gb, &gb->BC.b.hi);
+}
 
-		Flags affected:
-		Z - Set if result is zero
-		N - Reset
-		H - Reset
-		C - Reset
-		*/
-		word address;
-		byte temp;
+/*
+	SWAP C
 
-		/* Convert HL to an address */
-		convert_to_pair(&H, &L, &address);
+	Description:
+	Swap the lower and upper nibbles of C
 
-		/* Get byte pointed to by HL */
-		temp = memory_readb(address);
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Reset
+	C - Reset
+*/
+static void cb_31(struct gb_context *gb)
+{
+	CPU_swap(gb, &gb->BC.b.lo);
+}
 
-		CPU_swap(&temp);
+/*
+	SWAP D
 
-		/* Write swaped byte back to memory */
-		memory_writeb(address, temp);
+	Description:
+	Swap the lower and upper nibbles of D
 
-		PC += 2;
-		cycles = 8;
-		break;
-	}
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Reset
+	C - Reset
+*/
+static void cb_32(struct gb_context *gb)
+{
+	CPU_swap(gb, &gb->DE.b.hi);
+}
 
-	/* ++++++++ BIT MANIPULATION ++++++++ */
+/*
+	SWAP E
 
-	case 0x87:
-	{
-		/*
-		RES 0, A
+	Description:
+	Swap the lower and upper nibbles of E
 
-		Description:
-		Reset bit 0 in register A
-		*/
-		CPU_res(0, &A);
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Reset
+	C - Reset
+*/
+static void cb_33(struct gb_context *gb)
+{
+	CPU_swap(gb, &gb->DE.b.lo);
+}
 
-		PC++;
-		cycles = 8;
-		break;
-	}
-	case 0x8F:
-	{
-		/*
-		RES 1, A
+/*
+	SWAP H
 
-		Description:
-		Reset bit 1 in register A
-		*/
-		CPU_res(1, &A);
+	Description:
+	Swap the lower and upper nibbles of H
 
-		PC++;
-		cycles = 8;
-		break;
-	}
-	case 0x97:
-	{
-		/*
-		RES 2, A
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Reset
+	C - Reset
+*/
+static void cb_34(struct gb_context *gb)
+{
+	CPU_swap(gb, &gb->HL.b.hi);
+}
 
-		Description:
-		Reset bit 2 in register A
-		*/
-		CPU_res(2, &A);
+/*
+	SWAP L
 
-		PC++;
-		cycles = 8;
-		break;
-	}
-	case 0x9F:
-	{
-		/*
-		RES 3, A
+	Description:
+	Swap the lower and upper nibbles of L
 
-		Description:
-		Reset bit 3 in register A
-		*/
-		CPU_res(3, &A);
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Reset
+	C - Reset
+*/
+static void cb_35(struct gb_context *gb)
+{
+	CPU_swap(gb, &gb->HL.b.lo);
+}
 
-		PC++;
-		cycles = 8;
-		break;
-	}
-	case 0xA7:
-	{
-		/*
-		RES 4, A
+/*
+	SWAP (HL)
 
-		Description:
-		Reset bit 4 in register A
-		*/
-		CPU_res(4, &A);
+	Description:
+	Swap the lower and upper nibbles of the location
+	pointed to by HL
 
-		PC++;
-		cycles = 8;
-		break;
-	}
-	case 0xAF:
-	{
-		/*
-		RES 5, A
+	Flags affected:
+	Z - Set if result is zero
+	N - Reset
+	H - Reset
+	C - Reset
+*/
+static void cb_36(struct gb_context *gb)
+{
+	word address;
+	byte temp;
 
-		Description:
-		Reset bit 5 in register A
-		*/
-		CPU_res(5, &A);
+	/* Convert HL to an address */
+	address = gb->HL.w;
 
-		PC++;
-		cycles = 8;
-		break;
-	}
-	case 0xB7:
-	{
-		/*
-		RES 6, A
+	/* Get byte pointed to by HL */
+	temp = memory_readb(gb, address);
 
-		Description:
-		Reset bit 6 in register A
-		*/
-		CPU_res(6, &A);
+	CPU_swap(gb, &temp);
 
-		PC++;
-		cycles = 8;
-		break;
-	}
-	case 0xBF:
-	{
-		/*
-		RES 7, A
+	/* Write swaped byte back to memory */
+	memory_writeb(gb, address, temp);
+}
 
-		Description:
-		Reset bit 7 in register A
-		*/
-		CPU_res(7, &A);
+/* ++++++++ BIT MANIPULATION ++++++++ */
 
-		PC++;
-		cycles = 8;
-		break;
-	}
+/*
+	RES 0, A
+
+	Description:
+	Reset bit 0 in register A
+*/
+static void cb_87(struct gb_context *gb)
+{
+	CPU_res(0, &gb->AF.b.hi);
+}
+
+/*
+	RES 1, A
+
+	Description:
+	Reset bit 1 in register A
+*/
+static void cb_8F(struct gb_context *gb)
+{
+	CPU_res(1, &gb->AF.b.hi);
+}
+
+/*
+	RES 2, A
+
+	Description:
+	Reset bit 2 in register A
+*/
+static void cb_97(struct gb_context *gb)
+{
+	CPU_res(2, &gb->AF.b.hi);
+}
+
+/*
+	RES 3, A
+
+	Description:
+	Reset bit 3 in register A
+*/
+static void cb_9F(struct gb_context *gb)
+{
+	CPU_res(3, &gb->AF.b.hi);
+}
+
+/*
+	RES 4, A
+
+	Description:
+	Reset bit 4 in register A
+*/
+static void cb_A7(struct gb_context *gb)
+{
+	CPU_res(4, &gb->AF.b.hi);
+}
+
+/*
+	RES 5, A
+
+	Description:
+	Reset bit 5 in register A
+*/
+static void cb_AF(struct gb_context *gb)
+{
+	CPU_res(5, &gb->AF.b.hi);
+}
+
+/*
+	RES 6, A
+
+	Description:
+	Reset bit 6 in register A
+*/
+static void cb_B7(struct gb_context *gb)
+{
+	CPU_res(6, &gb->AF.b.hi);
+}
+
+/*
+	RES 7, A
 
-	default:
+	Description:
+	Reset bit 7 in register A
+*/
+static void cb_BF(struct gb_context *gb)
+{
+	CPU_res(7, &gb->AF.b.hi);
+}
+
+
+/*
+	The extended opcode table, indexed by the byte following the
+	CB prefix. The length only counts that byte, CPU() has already
+	moved PC past the prefix.
+
+	Each entry: handler, instruction length in bytes, cycles
+*/
+const struct opcode CPU_extended_opcodes[256] = {
+	{NULL, 1, 0},		/* CB 0x00 */
+	{NULL, 1, 0},		/* CB 0x01 */
+	{NULL, 1, 0},		/* CB 0x02 */
+	{NULL, 1, 0},		/* CB 0x03 */
+	{NULL, 1, 0},		/* CB 0x04 */
+	{NULL, 1, 0},		/* CB 0x05 */
+	{NULL, 1, 0},		/* CB 0x06 */
+	{NULL, 1, 0},		/* CB 0x07 */
+	{NULL, 1, 0},		/* CB 0x08 */
+	{NULL, 1, 0},		/* CB 0x09 */
+	{NULL, 1, 0},		/* CB 0x0A */
+	{NULL, 1, 0},		/* CB 0x0B */
+	{NULL, 1, 0},		/* CB 0x0C */
+	{NULL, 1, 0},		/* CB 0x0D */
+	{NULL, 1, 0},		/* CB 0x0E */
+	{NULL, 1, 0},		/* CB 0x0F */
+	{NULL, 1, 0},		/* CB 0x10 */
+	{NULL, 1, 0},		/* CB 0x11 */
+	{NULL, 1, 0},		/* CB 0x12 */
+	{NULL, 1, 0},		/* CB 0x13 */
+	{NULL, 1, 0},		/* CB 0x14 */
+	{NULL, 1, 0},		/* CB 0x15 */
+	{NULL, 1, 0},		/* CB 0x16 */
+	{NULL, 1, 0},		/* CB 0x17 */
+	{NULL, 1, 0},		/* CB 0x18 */
+	{NULL, 1, 0},		/* CB 0x19 */
+	{NULL, 1, 0},		/* CB 0x1A */
+	{NULL, 1, 0},		/* CB 0x1B */
+	{NULL, 1, 0},		/* CB 0x1C */
+	{NULL, 1, 0},		/* CB 0x1D */
+	{NULL, 1, 0},		/* CB 0x1E */
+	{NULL, 1, 0},		/* CB 0x1F */
+	{NULL, 1, 0},		/* CB 0x20 */
+	{NULL, 1, 0},		/* CB 0x21 */
+	{NULL, 1, 0},		/* CB 0x22 */
+	{NULL, 1, 0},		/* CB 0x23 */
+	{NULL, 1, 0},		/* CB 0x24 */
+	{NULL, 1, 0},		/* CB 0x25 */
+	{NULL, 1, 0},		/* CB 0x26 */
+	{NULL, 1, 0},		/* CB 0x27 */
+	{NULL, 1, 0},		/* CB 0x28 */
+	{NULL, 1, 0},		/* CB 0x29 */
+	{NULL, 1, 0},		/* CB 0x2A */
+	{NULL, 1, 0},		/* CB 0x2B */
+	{NULL, 1, 0},		/* CB 0x2C */
+	{NULL, 1, 0},		/* CB 0x2D */
+	{NULL, 1, 0},		/* CB 0x2E */
+	{NULL, 1, 0},		/* CB 0x2F */
+	{cb_30, 1, 8},	/* CB 0x30 */
+	{cb_31, 1, 8},	/* CB 0x31 */
+	{cb_32, 1, 8},	/* CB 0x32 */
+	{cb_33, 1, 8},	/* CB 0x33 */
+	{cb_34, 1, 8},	/* CB 0x34 */
+	{cb_35, 1, 8},	/* CB 0x35 */
+	{cb_36, 1, 8},	/* CB 0x36 */
+	{cb_37, 1, 8},	/* CB 0x37 */
+	{NULL, 1, 0},		/* CB 0x38 */
+	{NULL, 1, 0},		/* CB 0x39 */
+	{NULL, 1, 0},		/* CB 0x3A */
+	{NULL, 1, 0},		/* CB 0x3B */
+	{NULL, 1, 0},		/* CB 0x3C */
+	{NULL, 1, 0},		/* CB 0x3D */
+	{NULL, 1, 0},		/* CB 0x3E */
+	{NULL, 1, 0},		/* CB 0x3F */
+	{NULL, 1, 0},		/* CB 0x40 */
+	{NULL, 1, 0},		/* CB 0x41 */
+	{NULL, 1, 0},		/* CB 0x42 */
+	{NULL, 1, 0},		/* CB 0x43 */
+	{NULL, 1, 0},		/* CB 0x44 */
+	{NULL, 1, 0},		/* CB 0x45 */
+	{NULL, 1, 0},		/* CB 0x46 */
+	{NULL, 1, 0},		/* CB 0x47 */
+	{NULL, 1, 0},		/* CB 0x48 */
+	{NULL, 1, 0},		/* CB 0x49 */
+	{NULL, 1, 0},		/* CB 0x4A */
+	{NULL, 1, 0},		/* CB 0x4B */
+	{NULL, 1, 0},		/* CB 0x4C */
+	{NULL, 1, 0},		/* CB 0x4D */
+	{NULL, 1, 0},		/* CB 0x4E */
+	{NULL, 1, 0},		/* CB 0x4F */
+	{NULL, 1, 0},		/* CB 0x50 */
+	{NULL, 1, 0},		/* CB 0x51 */
+	{NULL, 1, 0},		/* CB 0x52 */
+	{NULL, 1, 0},		/* CB 0x53 */
+	{NULL, 1, 0},		/* CB 0x54 */
+	{NULL, 1, 0},		/* CB 0x55 */
+	{NULL, 1, 0},		/* CB 0x56 */
+	{NULL, 1, 0},		/* CB 0x57 */
+	{NULL, 1, 0},		/* CB 0x58 */
+	{NULL, 1, 0},		/* CB 0x59 */
+	{NULL, 1, 0},		/* CB 0x5A */
+	{NULL, 1, 0},		/* CB 0x5B */
+	{NULL, 1, 0},		/* CB 0x5C */
+	{NULL, 1, 0},		/* CB 0x5D */
+	{NULL, 1, 0},		/* CB 0x5E */
+	{NULL, 1, 0},		/* CB 0x5F */
+	{NULL, 1, 0},		/* CB 0x60 */
+	{NULL, 1, 0},		/* CB 0x61 */
+	{NULL, 1, 0},		/* CB 0x62 */
+	{NULL, 1, 0},		/* CB 0x63 */
+	{NULL, 1, 0},		/* CB 0x64 */
+	{NULL, 1, 0},		/* CB 0x65 */
+	{NULL, 1, 0},		/* CB 0x66 */
+	{NULL, 1, 0},		/* CB 0x67 */
+	{NULL, 1, 0},		/* CB 0x68 */
+	{NULL, 1, 0},		/* CB 0x69 */
+	{NULL, 1, 0},		/* CB 0x6A */
+	{NULL, 1, 0},		/* CB 0x6B */
+	{NULL, 1, 0},		/* CB 0x6C */
+	{NULL, 1, 0},		/* CB 0x6D */
+	{NULL, 1, 0},		/* CB 0x6E */
+	{NULL, 1, 0},		/* CB 0x6F */
+	{NULL, 1, 0},		/* CB 0x70 */
+	{NULL, 1, 0},		/* CB 0x71 */
+	{NULL, 1, 0},		/* CB 0x72 */
+	{NULL, 1, 0},		/* CB 0x73 */
+	{NULL, 1, 0},		/* CB 0x74 */
+	{NULL, 1, 0},		/* CB 0x75 */
+	{NULL, 1, 0},		/* CB 0x76 */
+	{NULL, 1, 0},		/* CB 0x77 */
+	{NULL, 1, 0},		/* CB 0x78 */
+	{NULL, 1, 0},		/* CB 0x79 */
+	{NULL, 1, 0},		/* CB 0x7A */
+	{NULL, 1, 0},		/* CB 0x7B */
+	{NULL, 1, 0},		/* CB 0x7C */
+	{NULL, 1, 0},		/* CB 0x7D */
+	{NULL, 1, 0},		/* CB 0x7E */
+	{NULL, 1, 0},		/* CB 0x7F */
+	{NULL, 1, 0},		/* CB 0x80 */
+	{NULL, 1, 0},		/* CB 0x81 */
+	{NULL, 1, 0},		/* CB 0x82 */
+	{NULL, 1, 0},		/* CB 0x83 */
+	{NULL, 1, 0},		/* CB 0x84 */
+	{NULL, 1, 0},		/* CB 0x85 */
+	{NULL, 1, 0},		/* CB 0x86 */
+	{cb_87, 1, 8},	/* CB 0x87 */
+	{NULL, 1, 0},		/* CB 0x88 */
+	{NULL, 1, 0},		/* CB 0x89 */
+	{NULL, 1, 0},		/* CB 0x8A */
+	{NULL, 1, 0},		/* CB 0x8B */
+	{NULL, 1, 0},		/* CB 0x8C */
+	{NULL, 1, 0},		/* CB 0x8D */
+	{NULL, 1, 0},		/* CB 0x8E */
+	{cb_8F, 1, 8},	/* CB 0x8F */
+	{NULL, 1, 0},		/* CB 0x90 */
+	{NULL, 1, 0},		/* CB 0x91 */
+	{NULL, 1, 0},		/* CB 0x92 */
+	{NULL, 1, 0},		/* CB 0x93 */
+	{NULL, 1, 0},		/* CB 0x94 */
+	{NULL, 1, 0},		/* CB 0x95 */
+	{NULL, 1, 0},		/* CB 0x96 */
+	{cb_97, 1, 8},	/* CB 0x97 */
+	{NULL, 1, 0},		/* CB 0x98 */
+	{NULL, 1, 0},		/* CB 0x99 */
+	{NULL, 1, 0},		/* CB 0x9A */
+	{NULL, 1, 0},		/* CB 0x9B */
+	{NULL, 1, 0},		/* CB 0x9C */
+	{NULL, 1, 0},		/* CB 0x9D */
+	{NULL, 1, 0},		/* CB 0x9E */
+	{cb_9F, 1, 8},	/* CB 0x9F */
+	{NULL, 1, 0},		/* CB 0xA0 */
+	{NULL, 1, 0},		/* CB 0xA1 */
+	{NULL, 1, 0},		/* CB 0xA2 */
+	{NULL, 1, 0},		/* CB 0xA3 */
+	{NULL, 1, 0},		/* CB 0xA4 */
+	{NULL, 1, 0},		/* CB 0xA5 */
+	{NULL, 1, 0},		/* CB 0xA6 */
+	{cb_A7, 1, 8},	/* CB 0xA7 */
+	{NULL, 1, 0},		/* CB 0xA8 */
+	{NULL, 1, 0},		/* CB 0xA9 */
+	{NULL, 1, 0},		/* CB 0xAA */
+	{NULL, 1, 0},		/* CB 0xAB */
+	{NULL, 1, 0},		/* CB 0xAC */
+	{NULL, 1, 0},		/* CB 0xAD */
+	{NULL, 1, 0},		/* CB 0xAE */
+	{cb_AF, 1, 8},	/* CB 0xAF */
+	{NULL, 1, 0},		/* CB 0xB0 */
+	{NULL, 1, 0},		/* CB 0xB1 */
+	{NULL, 1, 0},		/* CB 0xB2 */
+	{NULL, 1, 0},		/* CB 0xB3 */
+	{NULL, 1, 0},		/* CB 0xB4 */
+	{NULL, 1, 0},		/* CB 0xB5 */
+	{NULL, 1, 0},		/* CB 0xB6 */
+	{cb_B7, 1, 8},	/* CB 0xB7 */
+	{NULL, 1, 0},		/* CB 0xB8 */
+	{NULL, 1, 0},		/* CB 0xB9 */
+	{NULL, 1, 0},		/* CB 0xBA */
+	{NULL, 1, 0},		/* CB 0xBB */
+	{NULL, 1, 0},		/* CB 0xBC */
+	{NULL, 1, 0},		/* CB 0xBD */
+	{NULL, 1, 0},		/* CB 0xBE */
+	{cb_BF, 1, 8},	/* CB 0xBF */
+	{NULL, 1, 0},		/* CB 0xC0 */
+	{NULL, 1, 0},		/* CB 0xC1 */
+	{NULL, 1, 0},		/* CB 0xC2 */
+	{NULL, 1, 0},		/* CB 0xC3 */
+	{NULL, 1, 0},		/* CB 0xC4 */
+	{NULL, 1, 0},		/* CB 0xC5 */
+	{NULL, 1, 0},		/* CB 0xC6 */
+	{NULL, 1, 0},		/* CB 0xC7 */
+	{NULL, 1, 0},		/* CB 0xC8 */
+	{NULL, 1, 0},		/* CB 0xC9 */
+	{NULL, 1, 0},		/* CB 0xCA */
+	{NULL, 1, 0},		/* CB 0xCB */
+	{NULL, 1, 0},		/* CB 0xCC */
+	{NULL, 1, 0},		/* CB 0xCD */
+	{NULL, 1, 0},		/* CB 0xCE */
+	{NULL, 1, 0},		/* CB 0xCF */
+	{NULL, 1, 0},		/* CB 0xD0 */
+	{NULL, 1, 0},		/* CB 0xD1 */
+	{NULL, 1, 0},		/* CB 0xD2 */
+	{NULL, 1, 0},		/* CB 0xD3 */
+	{NULL, 1, 0},		/* CB 0xD4 */
+	{NULL, 1, 0},		/* CB 0xD5 */
+	{NULL, 1, 0},		/* CB 0xD6 */
+	{NULL, 1, 0},		/* CB 0xD7 */
+	{NULL, 1, 0},		/* CB 0xD8 */
+	{NULL, 1, 0},		/* CB 0xD9 */
+	{NULL, 1, 0},		/* CB 0xDA */
+	{NULL, 1, 0},		/* CB 0xDB */
+	{NULL, 1, 0},		/* CB 0xDC */
+	{NULL, 1, 0},		/* CB 0xDD */
+	{NULL, 1, 0},		/* CB 0xDE */
+	{NULL, 1, 0},		/* CB 0xDF */
+	{NULL, 1, 0},		/* CB 0xE0 */
+	{NULL, 1, 0},		/* CB 0xE1 */
+	{NULL, 1, 0},		/* CB 0xE2 */
+	{NULL, 1, 0},		/* CB 0xE3 */
+	{NULL, 1, 0},		/* CB 0xE4 */
+	{NULL, 1, 0},		/* CB 0xE5 */
+	{NULL, 1, 0},		/* CB 0xE6 */
+	{NULL, 1, 0},		/* CB 0xE7 */
+	{NULL, 1, 0},		/* CB 0xE8 */
+	{NULL, 1, 0},		/* CB 0xE9 */
+	{NULL, 1, 0},		/* CB 0xEA */
+	{NULL, 1, 0},		/* CB 0xEB */
+	{NULL, 1, 0},		/* CB 0xEC */
+	{NULL, 1, 0},		/* CB 0xED */
+	{NULL, 1, 0},		/* CB 0xEE */
+	{NULL, 1, 0},		/* CB 0xEF */
+	{NULL, 1, 0},		/* CB 0xF0 */
+	{NULL, 1, 0},		/* CB 0xF1 */
+	{NULL, 1, 0},		/* CB 0xF2 */
+	{NULL, 1, 0},		/* CB 0xF3 */
+	{NULL, 1, 0},		/* CB 0xF4 */
+	{NULL, 1, 0},		/* CB 0xF5 */
+	{NULL, 1, 0},		/* CB 0xF6 */
+	{NULL, 1, 0},		/* CB 0xF7 */
+	{NULL, 1, 0},		/* CB 0xF8 */
+	{NULL, 1, 0},		/* CB 0xF9 */
+	{NULL, 1, 0},		/* CB 0xFA */
+	{NULL, 1, 0},		/* CB 0xFB */
+	{NULL, 1, 0},		/* CB 0xFC */
+	{NULL, 1, 0},		/* CB 0xFD */
+	{NULL, 1, 0},		/* CB 0xFE */
+	{NULL, 1, 0},		/* CB 0xFF */
+};
+
+/*
+	Execute a single CB prefixed instruction
+
+	Returns 0 on success, -1 if the opcode isn't handled.
+*/
+int CPU_EXTENDED(struct gb_context *gb, word OP)
+{
+	const struct opcode *entry = &CPU_extended_opcodes[OP];
+
+	if(entry->execute == NULL)
 	{
 		printf("OP not handled: CB %X\n", OP);
 		return -1;
-		break;
 	}
 
-	} /* End switch */
+	gb->PC += entry->length;
+	gb->cycles = entry->cycles;
+
+	entry->execute(gb);
 
 	return 0;
 }
@@ -0,0 +1,873 @@
+/*
+	Copyright 2012, 2013 Charles O.
+	Email: charles.0x4f@gmail.com
+	Github: https://github.com/charles-0x4f/
+
+	This file is part of TermGB.
+
+	TermGB is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	TermGB is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with TermGB.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+	x86-64 dynamic recompiler
+
+	Hot blocks from the block cache are translated to x86-64 code.
+	Only the simple instructions that make up most tight loops are
+	translated: register loads, INC/DEC, ADD/SUB without carry, the
+	logic ops and compares, rotates of A, and JP/JR. A block is
+	compiled up to the first instruction the JIT doesn't know, the
+	rest of it keeps running through the interpreter.
+
+	Inside native code the guest registers live in host registers,
+	they are loaded on entry and only the ones that were changed are
+	written back on exit. Flags are written straight to F, in the
+	same form the interpreter's helpers leave them, so both back ends
+	can be swapped at any block boundary. PC and cycles are synced
+	once, when the native code exits.
+
+	Native code is tied to its cached block, so when a write drops
+	the block from the cache the native code goes with it. Each
+	machine has its own buffer, since the code points straight at
+	that machine's registers. When it fills up the whole cache is
+	flushed and compiling starts again from the beginning.
+
+	Host register use (SysV, no calls are made from native code so
+	only caller-saved registers are used):
+		A: r8b   B: r9b   C: r10b   D: r11b
+		E: sil   H: dil   L: dl
+		rcx: &F   rax: scratch
+*/
+
+#if defined(CPU_JIT) && defined(__x86_64__)
+/* For MAP_ANONYMOUS */
+#define _DEFAULT_SOURCE
+#endif
+
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include "gb.h"
+#include "cpu_jit.h"
+#include "cpu.h"
+
+byte jit_compare;
+
+#if defined(CPU_JIT) && defined(__x86_64__)
+
+#include <sys/mman.h>
+
+/* x86-64 register numbers */
+#define RAX 0
+#define RCX 1
+#define RDX 2
+#define RSI 6
+#define RDI 7
+#define R8 8
+#define R9 9
+#define R10 10
+#define R11 11
+
+/* Register index used by the SM83 opcodes for (HL) */
+#define GUEST_HL 6
+
+/*
+	Guest registers in SM83 opcode order (B, C, D, E, H, L, (HL), A),
+	as offsets into the context, and the host register each one
+	lives in
+*/
+static const size_t guest[8] = {
+	offsetof(struct gb_context, BC.b.hi),
+	offsetof(struct gb_context, BC.b.lo),
+	offsetof(struct gb_context, DE.b.hi),
+	offsetof(struct gb_context, DE.b.lo),
+	offsetof(struct gb_context, HL.b.hi),
+	offsetof(struct gb_context, HL.b.lo),
+	0,
+	offsetof(struct gb_context, AF.b.hi)
+};
+static const byte host[8] = { R9, R10, R11, RSI, RDI, RDX, 0, R8 };
+
+/* ++++ EMITTERS ++++ */
+
+static void emit8(struct gb_context *gb, byte b)
+{
+	*gb->jit_out++ = b;
+}
+
+static void emit16(struct gb_context *gb, word w)
+{
+	emit8(gb, w & 0xFF);
+	emit8(gb, w >> 8);
+}
+
+static void emit32(struct gb_context *gb, unsigned long l)
+{
+	emit16(gb, l & 0xFFFF);
+	emit16(gb, (l >> 16) & 0xFFFF);
+}
+
+static void emit_pointer(struct gb_context *gb, void *p)
+{
+	size_t value = (size_t)p;
+
+	emit32(gb, value & 0xFFFFFFFFUL);
+	emit32(gb, (value >> 16) >> 16);
+}
+
+/*
+	REX prefix for a byte register operation, always emitted so that
+	SIL/DIL are used rather than DH/BH
+*/
+static void emit_rex(struct gb_context *gb, byte reg, byte rm)
+{
+	emit8(gb, 0x40 | ((reg >> 3) << 2) | (rm >> 3));
+}
+
+/* mov reg64, imm64 */
+static void emit_mov_pointer(struct gb_context *gb, byte reg, void *p)
+{
+	emit8(gb, 0x48 | (reg >> 3));
+	emit8(gb, 0xB8 | (reg & 7));
+	emit_pointer(gb, p);
+}
+
+/* Register to register byte op, opcode takes r/m8, r8 */
+static void emit_op_rr(struct gb_context *gb, byte opcode, byte dst, byte src)
+{
+	emit_rex(gb, src, dst);
+	emit8(gb, opcode);
+	emit8(gb, 0xC0 | ((src & 7) << 3) | (dst & 7));
+}
+
+/* Byte op with an immediate, 0x80 /ext */
+static void emit_op_ri(struct gb_context *gb, byte ext, byte dst,
+	byte immediate)
+{
+	emit_rex(gb, 0, dst);
+	emit8(gb, 0x80);
+	emit8(gb, 0xC0 | (ext << 3) | (dst & 7));
+	emit8(gb, immediate);
+}
+
+/* mov byte [rcx + offset], immediate */
+static void emit_flag(struct gb_context *gb, size_t offset, byte immediate)
+{
+	emit8(gb, 0xC6);
+	emit8(gb, 0x41);
+	emit8(gb, offset);
+	emit8(gb, immediate);
+}
+
+/* setcc byte [rcx + offset] */
+static void emit_set_flag(struct gb_context *gb, byte condition, size_t offset)
+{
+	emit8(gb, 0x0F);
+	emit8(gb, condition);
+	emit8(gb, 0x41);
+	emit8(gb, offset);
+}
+
+/* Condition codes for setcc */
+#define SETE 0x94
+#define SETNE 0x95
+#define SETB 0x92
+
+/* Byte op between al and [rcx + offset] */
+static void emit_op_al_flag(struct gb_context *gb, byte opcode, size_t offset)
+{
+	emit8(gb, opcode);
+	emit8(gb, 0x41);
+	emit8(gb, offset);
+}
+
+/* Shift a host register by one, ext 4 is shl, 5 is shr */
+static void emit_shift(struct gb_context *gb, byte ext, byte reg)
+{
+	emit_rex(gb, 0, reg);
+	emit8(gb, 0xD0);
+	emit8(gb, 0xC0 | (ext << 3) | (reg & 7));
+}
+
+/* Load a guest register from memory into its host register */
+static void emit_load(struct gb_context *gb, byte r)
+{
+	emit_mov_pointer(gb, RAX, (byte*)gb + guest[r]);
+	emit_rex(gb, host[r], RAX);
+	emit8(gb, 0x8A);
+	emit8(gb, (host[r] & 7) << 3);
+}
+
+/* Store a host register back to its guest register */
+static void emit_store(struct gb_context *gb, byte r)
+{
+	emit_mov_pointer(gb, RAX, (byte*)gb + guest[r]);
+	emit_rex(gb, host[r], RAX);
+	emit8(gb, 0x88);
+	emit8(gb, (host[r] & 7) << 3);
+}
+
+/*
+	Flags the logic ops and compares always leave the same, the
+	rest are set with setcc
+*/
+static void emit_clear_flags(struct gb_context *gb, byte n, byte h)
+{
+	emit_flag(gb, offsetof(struct fREG, N), n);
+	emit_flag(gb, offsetof(struct fREG, H), h);
+	emit_flag(gb, offsetof(struct fREG, C), 0);
+}
+
+/* ++++ TRANSLATION ++++ */
+
+/* Mark the guest registers an instruction reads and writes */
+static void use(struct gb_context *gb, byte r, byte writes)
+{
+	gb->jit_used |= 1 << r;
+
+	if(writes)
+		gb->jit_changed |= 1 << r;
+}
+
+/*
+	Work out whether an instruction can be compiled, and which guest
+	registers it touches
+
+	Returns 1 if it can be compiled.
+*/
+static byte JIT_scan(struct gb_context *gb,
+	struct cached_instruction *instruction)
+{
+	byte op = instruction->opcode;
+	byte dst = (op >> 3) & 7;
+	byte src = op & 7;
+
+	/* LD r, r' */
+	if(op >= 0x40 && op <= 0x7F)
+	{
+		if(dst == GUEST_HL || src == GUEST_HL)
+			return 0;
+
+		use(gb, src, 0);
+		use(gb, dst, 1);
+		return 1;
+	}
+
+	/*
+		ADD r, SUB r; ADD A, A is left out as CPU_add_8 works out
+		its half carry from the already doubled A
+	*/
+	if((op >= 0x80 && op <= 0x86) ||
+		(op >= 0x90 && op <= 0x97))
+	{
+		if(src == GUEST_HL)
+			return 0;
+
+		use(gb, src, 0);
+		use(gb, 7, 1);
+		return 1;
+	}
+
+	/* AND/XOR/OR/CP r */
+	if(op >= 0xA0 && op <= 0xBF)
+	{
+		if(src == GUEST_HL)
+			return 0;
+
+		use(gb, src, 0);
+		use(gb, 7, 1);
+		return 1;
+	}
+
+	switch(op)
+	{
+		/* NOP, JP, JR */
+		case 0x00:
+		case 0xC3: case 0xC2: case 0xCA: case 0xD2: case 0xDA:
+		case 0x18: case 0x20: case 0x28: case 0x30: case 0x38:
+			return 1;
+
+		/* ADD/SUB/AND/XOR/OR/CP n, rotates of A */
+		case 0xC6: case 0xD6:
+		case 0xE6: case 0xEE: case 0xF6: case 0xFE:
+		case 0x07: case 0x17: case 0x0F: case 0x1F:
+			use(gb, 7, 1);
+			return 1;
+
+		/* LD r, n; INC r; DEC r */
+		case 0x06: case 0x0E: case 0x16: case 0x1E:
+		case 0x26: case 0x2E: case 0x3E:
+		case 0x04: case 0x0C: case 0x14: case 0x1C:
+		case 0x24: case 0x2C: case 0x3C:
+		case 0x05: case 0x0D: case 0x15: case 0x1D:
+		case 0x25: case 0x2D: case 0x3D:
+			use(gb, dst, 1);
+			return 1;
+
+		/* INC rr; DEC rr */
+		case 0x03: case 0x13: case 0x23:
+		case 0x0B: case 0x1B: case 0x2B:
+			use(gb, dst & 6, 1);
+			use(gb, (dst & 6) + 1, 1);
+			return 1;
+	}
+
+	return 0;
+}
+
+/*
+	The logic ops and compares, matching CPU_and_8, CPU_xor_8,
+	CPU_or_8 and CPU_compare_8
+
+	kind: 0 AND, 1 XOR, 2 OR, 3 CP
+*/
+static void JIT_logic(struct gb_context *gb, byte kind, byte src,
+	byte immediate, byte use_immediate)
+{
+	/* r/m8, r8 opcodes and 0x80 extensions for each kind */
+	static const byte rr[4] = { 0x20, 0x30, 0x08, 0x38 };
+	static const byte ri[4] = { 4, 6, 1, 7 };
+
+	if(use_immediate)
+		emit_op_ri(gb, ri[kind], host[7], immediate);
+	else
+		emit_op_rr(gb, rr[kind], host[7], host[src]);
+
+	emit_set_flag(gb, SETE, offsetof(struct fREG, Z));
+
+	if(kind == 3)
+	{
+		/* Carry if A was smaller, subtract sets N */
+		emit_set_flag(gb, SETB, offsetof(struct fREG, C));
+		emit_flag(gb, offsetof(struct fREG, N), 1);
+		emit_flag(gb, offsetof(struct fREG, H), 0);
+	}
+	else
+	{
+		/* AND sets half carry */
+		emit_clear_flags(gb, 0, kind == 0);
+	}
+}
+
+/*
+	ADD or SUB, matching CPU_add_8 and CPU_subtract_8 without carry
+
+	The subtract helper never ends up setting half carry, so neither
+	does this.
+*/
+static void JIT_add_sub(struct gb_context *gb, byte subtract, byte src,
+	byte immediate, byte use_immediate)
+{
+	if(!subtract)
+	{
+		/* al = A ^ operand, for the half carry below */
+		emit_op_rr(gb, 0x88, RAX, host[7]);
+		if(use_immediate)
+		{
+			emit8(gb, 0x34);
+			emit8(gb, immediate);
+		}
+		else
+		{
+			emit_op_rr(gb, 0x30, RAX, host[src]);
+		}
+	}
+
+	if(use_immediate)
+		emit_op_ri(gb, subtract ? 5 : 0, host[7], immediate);
+	else
+		emit_op_rr(gb, subtract ? 0x28 : 0x00, host[7], host[src]);
+
+	emit_set_flag(gb, SETB, offsetof(struct fREG, C));
+	emit_set_flag(gb, SETE, offsetof(struct fREG, Z));
+	emit_flag(gb, offsetof(struct fREG, N), subtract);
+
+	if(subtract)
+	{
+		emit_flag(gb, offsetof(struct fREG, H), 0);
+		return;
+	}
+
+	/* Carry out of bit 3 shows up in bit 4 of A ^ operand ^ result */
+	emit_op_rr(gb, 0x30, RAX, host[7]);
+	emit8(gb, 0x24);
+	emit8(gb, 0x10);
+	emit_set_flag(gb, SETNE, offsetof(struct fREG, H));
+}
+
+/*
+	RLCA, RLA, RRCA and RRA, matching CPU_rotate and
+	CPU_rotate_through on A, quirks included: the left rotates keep
+	bit 7 itself in the carry flag and add it back as is, RRA puts
+	the old carry back into bit 0.
+
+	kind: 0 RLCA, 1 RRCA, 2 RLA, 3 RRA
+*/
+static void JIT_rotate(struct gb_context *gb, byte kind)
+{
+	byte right = kind & 1;
+	byte through = kind >> 1;
+
+	/* al = the bit that moves into the carry */
+	emit_op_rr(gb, 0x88, RAX, host[7]);
+	emit8(gb, 0x24);
+	emit8(gb, right ? 0x01 : 0x80);
+
+	if(through)
+	{
+		/* Swap it with the old carry, al = old carry */
+		emit_op_al_flag(gb, 0x86, offsetof(struct fREG, C));
+
+		if(right)
+		{
+			/* Only a carry of exactly 1 goes back in */
+			emit8(gb, 0x3C);
+			emit8(gb, 0x01);
+			emit8(gb, 0x0F);
+			emit8(gb, SETE);
+			emit8(gb, 0xC0);
+		}
+	}
+	else
+	{
+		emit_op_al_flag(gb, 0x88, offsetof(struct fREG, C));
+
+		/* A bit going out on the right comes back in as bit 7 */
+		if(right)
+		{
+			emit8(gb, 0xC0);
+			emit8(gb, 0xE0);
+			emit8(gb, 7);
+		}
+	}
+
+	emit_shift(gb, right ? 5 : 4, host[7]);
+
+	/* Put the bit back, add on the left and or on the right */
+	emit_op_rr(gb, right ? 0x08 : 0x00, host[7], RAX);
+	emit_set_flag(gb, SETE, offsetof(struct fREG, Z));
+	emit_flag(gb, offsetof(struct fREG, N), 0);
+	emit_flag(gb, offsetof(struct fREG, H), 0);
+}
+
+/* INC r or DEC r, matching CPU_incdec_8 */
+static void JIT_incdec(struct gb_context *gb, byte r, byte direction)
+{
+	/* Half carry from the low nibble before the change */
+	emit_op_rr(gb, 0x88, RAX, host[r]);
+	/* and al, 0xF; cmp al, 0xF (or 0) */
+	emit8(gb, 0x24);
+	emit8(gb, 0x0F);
+	emit8(gb, 0x3C);
+	emit8(gb, direction == 0 ? 0x0F : 0x00);
+	emit_set_flag(gb, SETE, offsetof(struct fREG, H));
+
+	/* inc/dec r8 */
+	emit_rex(gb, 0, host[r]);
+	emit8(gb, 0xFE);
+	emit8(gb, 0xC0 | (direction << 3) | (host[r] & 7));
+	emit_set_flag(gb, SETE, offsetof(struct fREG, Z));
+
+	emit_flag(gb, offsetof(struct fREG, N), direction);
+	emit_flag(gb, offsetof(struct fREG, C), 0);
+}
+
+/*
+	Emit an instruction
+
+	pc is the address of the following instruction. Returns 1 if
+	the instruction is a jump, with *target set to where it goes
+	and *flag and *condition set to the test for conditional ones
+	(condition is 0xFF if it always jumps). Returns 0 otherwise.
+*/
+static byte JIT_emit(struct gb_context *gb,
+	struct cached_instruction *instruction, word pc, word *target,
+	size_t *flag, byte *condition)
+{
+	byte op = instruction->opcode;
+	byte dst = (op >> 3) & 7;
+	byte src = op & 7;
+
+	*flag = 0;
+	*condition = 0xFF;
+
+	if(op >= 0x40 && op <= 0x7F)
+	{
+		if(dst != src)
+			emit_op_rr(gb, 0x88, host[dst], host[src]);
+		return 0;
+	}
+
+	if(op >= 0x80 && op <= 0x97)
+	{
+		JIT_add_sub(gb, op >= 0x90, src, 0, 0);
+		return 0;
+	}
+
+	if(op >= 0xA0 && op <= 0xBF)
+	{
+		JIT_logic(gb, (op - 0xA0) >> 3, src, 0, 0);
+		return 0;
+	}
+
+	switch(op)
+	{
+		case 0xC6:
+			JIT_add_sub(gb, 0, 0, instruction->operand8, 1);
+			return 0;
+		case 0xD6:
+			JIT_add_sub(gb, 1, 0, instruction->operand8, 1);
+			return 0;
+
+		case 0x07:
+			JIT_rotate(gb, 0);
+			return 0;
+		case 0x0F:
+			JIT_rotate(gb, 1);
+			return 0;
+		case 0x17:
+			JIT_rotate(gb, 2);
+			return 0;
+		case 0x1F:
+			JIT_rotate(gb, 3);
+			return 0;
+
+		case 0xE6:
+			JIT_logic(gb, 0, 0, instruction->operand8, 1);
+			return 0;
+		case 0xEE:
+			JIT_logic(gb, 1, 0, instruction->operand8, 1);
+			return 0;
+		case 0xF6:
+			JIT_logic(gb, 2, 0, instruction->operand8, 1);
+			return 0;
+		case 0xFE:
+			JIT_logic(gb, 3, 0, instruction->operand8, 1);
+			return 0;
+
+		case 0x06: case 0x0E: case 0x16: case 0x1E:
+		case 0x26: case 0x2E: case 0x3E:
+			/* mov r8, imm8 */
+			emit_rex(gb, 0, host[dst]);
+			emit8(gb, 0xB0 | (host[dst] & 7));
+			emit8(gb, instruction->operand8);
+			return 0;
+
+		case 0x04: case 0x0C: case 0x14: case 0x1C:
+		case 0x24: case 0x2C: case 0x3C:
+			JIT_incdec(gb, dst, 0);
+			return 0;
+
+		case 0x05: case 0x0D: case 0x15: case 0x1D:
+		case 0x25: case 0x2D: case 0x3D:
+			JIT_incdec(gb, dst, 1);
+			return 0;
+
+		/* INC rr: add low, 1; adc high, 0 */
+		case 0x03: case 0x13: case 0x23:
+			emit_op_ri(gb, 0, host[dst + 1], 1);
+			emit_op_ri(gb, 2, host[dst], 0);
+			return 0;
+
+		/* DEC rr: sub low, 1; sbb high, 0 */
+		case 0x0B: case 0x1B: case 0x2B:
+			emit_op_ri(gb, 5, host[dst], 1);
+			emit_op_ri(gb, 3, host[dst - 1], 0);
+			return 0;
+
+		case 0xC3:
+			*target = instruction->operand16;
+			return 1;
+		case 0x18:
+			*target = pc + (s_byte)instruction->operand8;
+			return 1;
+
+		/* Conditional jumps, CPU_jump(flag, address, condition) */
+		case 0xC2: case 0xCA: case 0xD2: case 0xDA:
+		case 0x20: case 0x28: case 0x30: case 0x38:
+			if(op & 0x10)
+				*flag = offsetof(struct fREG, C);
+			else
+				*flag = offsetof(struct fREG, Z);
+			*condition = (op >> 3) & 1;
+
+			if(op & 0x80)
+				*target = instruction->operand16;
+			else
+				*target = pc + (s_byte)instruction->operand8;
+			return 1;
+	}
+
+	return 0;
+}
+
+/*
+	Compile the block to native code, or as much of it as the JIT
+	can translate
+
+	Returns 1 if native code was produced.
+*/
+byte JIT_compile(struct gb_context *gb, struct cached_block *block)
+{
+	struct cached_instruction *instruction;
+	byte count = 0, r;
+	int total = 0;
+	word pc = block->start, target = 0;
+	size_t flag = 0;
+	byte condition = 0xFF, jumps = 0;
+	byte *start;
+
+	if(gb->jit_buffer == NULL)
+	{
+		gb->jit_buffer = mmap(NULL, JIT_BUFFER_SIZE,
+			PROT_READ | PROT_WRITE | PROT_EXEC,
+			MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+		if(gb->jit_buffer == MAP_FAILED)
+		{
+			gb->jit_buffer = NULL;
+			return 0;
+		}
+	}
+
+	/*
+		Out of room, start over. Flushing drops every block, so
+		the caller has to look its block up again.
+	*/
+	if(JIT_BUFFER_SIZE - gb->jit_buffer_used < 4096)
+	{
+		gb->jit_buffer_used = 0;
+		CACHE_flush(gb);
+		return 0;
+	}
+
+	/* Find how many instructions can be compiled */
+	gb->jit_used = 0;
+	gb->jit_changed = 0;
+
+	while(count < block->count)
+	{
+		instruction = &block->instructions[count];
+
+		if(total + instruction->cycles > JIT_BLOCK_CYCLES)
+			break;
+		if(!JIT_scan(gb, instruction))
+			break;
+
+		total += instruction->cycles;
+		count++;
+	}
+
+	if(count == 0)
+		return 0;
+
+	start = gb->jit_buffer + gb->jit_buffer_used;
+	gb->jit_out = start;
+
+	emit_mov_pointer(gb, RCX, &gb->F);
+
+	for(r = 0; r < 8; r++)
+	{
+		if(gb->jit_used & (1 << r))
+			emit_load(gb, r);
+	}
+
+	for(instruction = block->instructions;
+		instruction < block->instructions + count; instruction++)
+	{
+		pc += instruction->length;
+		jumps = JIT_emit(gb, instruction, pc, &target, &flag,
+			&condition);
+	}
+
+	for(r = 0; r < 8; r++)
+	{
+		if(gb->jit_changed & (1 << r))
+			emit_store(gb, r);
+	}
+
+	/* mov dword [cycles], total */
+	emit_mov_pointer(gb, RAX, &gb->cycles);
+	emit8(gb, 0xC7);
+	emit8(gb, 0x00);
+	emit32(gb, total);
+
+	/*
+		mov word [PC], next; then for a jump overwrite it with the
+		target, unless it's conditional and the test fails
+	*/
+	emit_mov_pointer(gb, RAX, &gb->PC);
+	emit8(gb, 0x66);
+	emit8(gb, 0xC7);
+	emit8(gb, 0x00);
+	emit16(gb, pc);
+
+	if(condition != 0xFF)
+	{
+		/* cmp byte [rcx + flag], condition; jne past the store */
+		emit8(gb, 0x80);
+		emit8(gb, 0x79);
+		emit8(gb, flag);
+		emit8(gb, condition);
+		emit8(gb, 0x75);
+		emit8(gb, 12);
+	}
+
+	if(jumps)
+	{
+		emit8(gb, 0x66);
+		emit8(gb, 0xC7);
+		emit8(gb, 0x00);
+		emit16(gb, target);
+	}
+
+	/* add dword [rax + cycles - PC], extra; the jump taken costs more */
+	if(condition != 0xFF)
+	{
+		emit8(gb, 0x83);
+		emit8(gb, 0x80);
+		emit32(gb, (byte*)&gb->cycles - (byte*)&gb->PC);
+		emit8(gb, JUMP_TAKEN_CYCLES);
+	}
+
+	/* ret */
+	emit8(gb, 0xC3);
+
+	gb->jit_buffer_used += gb->jit_out - start;
+
+	memcpy(&block->native, &start, sizeof(start));
+	block->native_count = count;
+	block->native_cycles = total;
+
+	return 1;
+}
+
+void JIT_free(struct gb_context *gb)
+{
+	if(gb->jit_buffer != NULL)
+		munmap(gb->jit_buffer, JIT_BUFFER_SIZE);
+
+	gb->jit_buffer = NULL;
+	gb->jit_buffer_used = 0;
+}
+
+#else
+
+/* No JIT for this host, every block stays with the interpreter */
+byte JIT_compile(struct gb_context *gb, struct cached_block *block)
+{
+	return 0;
+}
+
+void JIT_free(struct gb_context *gb)
+{
+}
+
+#endif
+
+/* Guest state compared between the two back ends */
+struct jit_state {
+	union reg_pair AF, BC, DE, HL;
+	struct fREG F;
+	word PC;
+	int cycles;
+};
+
+static void JIT_save(struct gb_context *gb, struct jit_state *state)
+{
+	state->AF = gb->AF;
+	state->BC = gb->BC;
+	state->DE = gb->DE;
+	state->HL = gb->HL;
+	state->F = gb->F;
+	state->PC = gb->PC;
+	state->cycles = gb->cycles;
+}
+
+static void JIT_restore(struct gb_context *gb, struct jit_state *state)
+{
+	gb->AF = state->AF;
+	gb->BC = state->BC;
+	gb->DE = state->DE;
+	gb->HL = state->HL;
+	gb->F = state->F;
+	gb->PC = state->PC;
+	gb->cycles = state->cycles;
+}
+
+/*
+	Run the native code of a block, PC and cycles are left set for
+	CPU_tick
+
+	With jit_compare set the same instructions are also run through
+	the interpreter from the same starting state, a mismatch is
+	reported and the interpreter's result is kept.
+*/
+void JIT_run(struct gb_context *gb, struct cached_block *block)
+{
+	struct jit_state before, native;
+	struct cached_instruction *instruction;
+	word next;
+
+	/* Native code reads and writes the members of F directly */
+	CPU_flags(gb);
+
+	if(!jit_compare)
+	{
+		block->native();
+		return;
+	}
+
+	JIT_save(gb, &before);
+	block->native();
+	JIT_save(gb, &native);
+	JIT_restore(gb, &before);
+
+	/* A jump taken adds to cycles, the rest are added after */
+	gb->cycles = 0;
+
+	for(instruction = block->instructions;
+		instruction < block->instructions + block->native_count;
+		instruction++)
+	{
+		gb->operand8 = instruction->operand8;
+		gb->operand16 = instruction->operand16;
+		next = gb->PC + instruction->length;
+		gb->PC = next;
+
+		instruction->execute(gb);
+
+		if(gb->PC != next)
+			break;
+	}
+
+	gb->cycles += block->native_cycles;
+	CPU_flags(gb);
+
+	if(native.F.Z != gb->F.Z || native.F.N != gb->F.N ||
+		native.F.H != gb->F.H ||
+		native.F.C != gb->F.C || native.PC != gb->PC ||
+		native.AF.b.hi != gb->AF.b.hi || native.BC.w != gb->BC.w ||
+		native.DE.w != gb->DE.w || native.HL.w != gb->HL.w)
+	{
+		printf("JIT mismatch in block %X: "
+			"native A %X BC %X DE %X HL %X "
+			"ZNHC %X%X%X%X PC %X; "
+			"interpreter A %X BC %X DE %X HL %X "
+			"ZNHC %X%X%X%X PC %X\n", block->start,
+			native.AF.b.hi, native.BC.w, native.DE.w, native.HL.w,
+			native.F.Z, native.F.N, native.F.H, native.F.C,
+			native.PC, gb->AF.b.hi, gb->BC.w, gb->DE.w, gb->HL.w,
+			gb->F.Z, gb->F.N, gb->F.H, gb->F.C, gb->PC);
+	}
+}
@@ -0,0 +1,53 @@
+/*
+	Copyright 2012, 2013 Charles O.
+	Email: charles.0x4f@gmail.com
+	Github: https://github.com/charles-0x4f/
+
+	This file is part of TermGB.
+
+	TermGB is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	TermGB is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with TermGB.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* cpu_jit.h */
+
+#ifndef CPU_JIT_H
+#define CPU_JIT_H
+
+#include "cpu_cache.h"
+
+/* Number of runs before a cached block is compiled */
+#define JIT_THRESHOLD 16
+/*
+	Most cycles a compiled block may cover, time is only synced when
+	the native code exits so this keeps each sync within a scanline
+*/
+#define JIT_BLOCK_CYCLES 64
+/* Size of the buffer native code is written to */
+#define JIT_BUFFER_SIZE (4 * 1024 * 1024)
+
+/*
+	If set, every native block is also run through the interpreter
+	and any difference between the two is reported
+*/
+extern byte jit_compare;
+
+
+/* Compile the block to native code if possible, 1 on success */
+byte JIT_compile(struct gb_context*, struct cached_block*);
+/* Run the native code of a compiled block */
+void JIT_run(struct gb_context*, struct cached_block*);
+/* Release the native code buffer */
+void JIT_free(struct gb_context*);
+
+#endif
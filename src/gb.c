@@ -0,0 +1,46 @@
+/*
+	Copyright 2012, 2013 Charles O.
+	Email: charles.0x4f@gmail.com
+	Github: https://github.com/charles-0x4f/
+
+	This file is part of TermGB.
+
+	TermGB is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	TermGB is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with TermGB.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/* gb.c */
+
+#include <stdlib.h>
+#include "gb.h"
+#include "cpu_jit.h"
+
+/*
+	Allocate a context with everything zeroed, load_rom,
+	memory_init and CPU_reset then get it ready to run
+*/
+struct gb_context *GB_create()
+{
+	return calloc(1, sizeof(struct gb_context));
+}
+
+void GB_destroy(struct gb_context *gb)
+{
+	if(gb == NULL)
+		return;
+
+	JIT_free(gb);
+	unload_rom(gb);
+	free(gb);
+}
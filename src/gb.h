@@ -0,0 +1,267 @@
+/*
+	Copyright 2012, 2013 Charles O.
+	Email: charles.0x4f@gmail.com
+	Github: https://github.com/charles-0x4f/
+
+	This file is part of TermGB.
+
+	TermGB is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	TermGB is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with TermGB.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/* gb.h */
+
+#ifndef GB_H
+#define GB_H
+
+#include <stddef.h>
+#include "memory.h"
+#include "cpu.h"
+#include "cpu_cache.h"
+#include "scheduler.h"
+#include "mbc.h"
+#include "gl_simd.h"
+
+struct SDL_Surface;
+struct presenter;
+
+/*
+	Everything one emulated Game Boy is made of
+
+	Every subsystem is handed the context it works on and nothing
+	about the machine is kept anywhere else, so any number of them
+	can be created and run side by side, each on its own thread.
+*/
+struct gb_context {
+	/* +++++ CPU +++++ */
+
+	/*
+		The CPU registers as pairs
+
+		A: AF.b.hi	F: AF.b.lo (compiled flags, see compiler_F)
+		B: BC.b.hi	C: BC.b.lo
+		D: DE.b.hi	E: DE.b.lo
+		H: HL.b.hi	L: HL.b.lo
+	*/
+	union reg_pair AF;
+	union reg_pair BC;
+	union reg_pair DE;
+	union reg_pair HL;
+
+	/* Flags, up to date after CPU_flags() */
+	struct fREG F;
+	/* The last flag setting operation, see struct lazy_flags */
+	struct lazy_flags flags;
+
+	word SP; /* Stack pointer */
+	word PC; /* Program counter */
+
+	/*
+		Immediate operands of the instruction being executed,
+		these are fetched by CPU() before the handler is called
+
+		operand8: first byte after the opcode
+		operand16: two bytes after the opcode (LSB first) as a word
+	*/
+	byte operand8;
+	word operand16;
+
+	/* Hold the number of cycles an instruction takes to execute */
+	int cycles;
+	/* Used as a total number of cycles for use in timing */
+	int total_cycles;
+	/* Hold the maximum number of cycles between Vsyncs */
+	int max_cycles;
+
+	/* Frames run since reset */
+	long frames;
+	/*
+		CPU_run sets stop and returns once frames reaches this,
+		0 to keep running
+	*/
+	long frame_limit;
+	byte stop;
+
+	/* Master interupt enable switch */
+	byte ie;
+	/*
+		The enable/disable instructions are silly gooses and
+		don't actually set or reset until after the instruction
+		following them. This variable will be used to emulate
+		this function. I would like this comment to be just a
+		little bit longer. This should satisfy my want.
+	*/
+	byte interrupt_step;
+	/*
+		Note whether interrupts will be disabled (0) or enabled
+		(1) after interrupt step is zeroed
+	*/
+	byte interrupt_direction;
+
+	/* +++++ MEMORY +++++ */
+
+	/* The entire ROM, mapped or read in by load_rom */
+	byte *ROM;
+	/* Size of ROM, a whole number of 16KB banks */
+	unsigned long ROM_size;
+	/* Set if ROM is mapped from the file rather than allocated */
+	byte ROM_mapped;
+	/* Raw emulation of the GB memory map, may change in the future. */
+	byte memory[0xFFFF+1];
+
+	/*
+		The memory map as 256 byte pages, see memory_map(). An
+		access to a page with a pointer goes straight to it, a
+		NULL pointer sends it to the page's handler instead.
+	*/
+	byte *read_page[0x100];
+	byte *write_page[0x100];
+	memory_read_handler read_handler[0x100];
+	memory_write_handler write_handler[0x100];
+	/* The map as it was before memory_lock() */
+	byte *locked_read_page[0x100];
+	byte *locked_write_page[0x100];
+	memory_read_handler locked_read_handler[0x100];
+	memory_write_handler locked_write_handler[0x100];
+	/* Hooks for the I/O registers (0xFF00-0xFF7F), see io.h */
+	memory_read_handler io_read[0x80];
+	memory_write_handler io_write[0x80];
+
+	/* Buttons held down, see joypad.h */
+	byte buttons;
+
+	/* +++++ CARTRIDGE +++++ */
+
+	/* MBC_ type from the header, see mbc.h */
+	byte mbc;
+	/* Number of 16KB ROM banks and 8KB RAM banks */
+	word rom_banks;
+	byte ram_banks;
+	/* Bank register values as last written */
+	word rom_select;
+	byte ram_select;
+	byte mbc1_mode;
+	byte ram_enabled;
+	/* Banks mapped at 0x0000, 0x4000 and 0xA000 */
+	word rom_bank0;
+	word rom_bank;
+	byte ram_bank;
+	/* MBC3 clock registers, their latched copy and the last latch write */
+	byte rtc[5];
+	byte rtc_latched[5];
+	byte rtc_latch;
+	byte cart_ram[MBC_RAM_SIZE];
+
+	/* +++++ SCHEDULER +++++ */
+
+	/* Cycles run since the scheduler was reset */
+	long scheduler_now;
+	/* Cycle the earliest queued event is due at */
+	long scheduler_next;
+	/* When each event is due, EVENT_NEVER if it isn't queued */
+	long event_due[EVENTS];
+
+	/* +++++ LCD AND TIMER +++++ */
+
+	/* Current mode, kept apart from STAT since games can write to that */
+	byte lcd_mode;
+	/* Set while the LCD is switched off */
+	byte lcd_off;
+	/* TAC as of the last write, to tell if the timer has changed */
+	byte timer_control;
+	/* Cycle the divider was last reset at, DIV is worked out from it */
+	long div_base;
+
+	/* +++++ VIDEO +++++ */
+
+	byte video_buffer[144][160];
+	/*
+		The 384 tiles in VRAM (0x8000-0x97FF) decoded to a color
+		number per pixel. Writing to a tile sets its tile_dirty
+		and it's decoded again the next time it's drawn.
+	*/
+	byte tiles[384][8][8];
+	byte tile_dirty[384];
+	/*
+		Bit n is set in a line if sprite n in OAM covers it, kept
+		up to date as OAM is written, for sprites sprite_height
+		tall
+	*/
+	uint64_t sprite_lines[144];
+	byte sprite_height;
+	/* The window's own line count for this frame */
+	byte window_line;
+	/* The pixel kernels for this host, see gl_simd.h */
+	tile_kernel decode_tile;
+	palette_kernel palette;
+	/*
+		Set from an OAM DMA transfer starting until it's finished,
+		the memory map is locked meanwhile
+	*/
+	byte dma_active;
+
+	/*
+		Puts a whole frame on the screen, set by the frontend, NULL
+		to run without one. It's handed a copy of video_buffer
+		from V-blank, on the presenter thread if there is one.
+	*/
+	void (*draw_frame)(struct gb_context*, byte (*)[160]);
+	/* The presenter thread and its queue of frames, see gl_present.h */
+	struct presenter *presenter;
+	/* The SDL frontend's surface and palette */
+	struct SDL_Surface *LCD;
+	uint32_t color[4];
+	/* What each terminal cell was showing, for the terminal frontends */
+	byte term_cells[72][160];
+	/* The terminal's colors 16-19 from before the curses frontend */
+	short term_colors[4][3];
+	byte term_colors_changed;
+	/*
+		The ANSI frontend's output buffer, where it left the cursor
+		and colors (-1 when it can't be sure) and how many bytes and
+		write() calls its frames have taken
+	*/
+	char *term_buffer;
+	int term_row, term_column, term_fg, term_bg;
+	unsigned long term_frames, term_bytes, term_writes;
+	/* How the ANSI frontend is drawing, see gl_ansi.h */
+	byte term_mode;
+	/* The last frame the image modes sent, to skip ones the same */
+	byte term_picture[144][160];
+
+	/* +++++ BLOCK CACHE AND JIT +++++ */
+
+	struct cached_block cache[CACHE_SIZE];
+	/*
+		Number of valid blocks covering each address, so that a
+		write can tell in one lookup whether it touched cached code
+	*/
+	byte cache_marks[0xFFFF+1];
+
+	/* Native code buffer and how much of it is in use */
+	byte *jit_buffer;
+	size_t jit_buffer_used;
+	/* Where code is being emitted to */
+	byte *jit_out;
+	/* Guest registers used and changed by the block being compiled */
+	byte jit_used;
+	byte jit_changed;
+};
+
+/* Create a powered off machine, NULL if out of memory */
+struct gb_context *GB_create();
+/* Free a machine and everything it holds */
+void GB_destroy(struct gb_context*);
+
+#endif
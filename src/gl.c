@@ -20,7 +20,12 @@
 */
 
 #include <stdio.h>
+#include <string.h>
+#include "gb.h"
 #include "gl.h"
+#include "trace.h"
+#include "scheduler.h"
+#include "cpu_cache.h"
 
 /*
 	This function replicates the DMA transfer the Gameboy does when
@@ -30,455 +35,464 @@
 	defined by the byte written to 0xFF46 to the OAM (sprite attribute
 	memory) at 0xFE00-0xFE9F.
 
-	The byte written to 0xFF46 is a little odd, the source address the
-	data is copied from must be an interval of 0x100, anywhere from
-	0x0000 to 0xF100.
-
-	So, the source address must be multiplied by 100 to find the real
-	source address.
+	The byte written to 0xFF46 is the high byte of the source
+	address, so the source is always a multiple of 0x100.
 
 	Example:
-	a = 0xA0
+	a = 0xC1
 	load a into 0xFF46
-	real source address = a(0xA0) * 100
-	real source address = 0x3E80
-	DMA: transfer all bytes from 0x3E80 to 0x3F1F(0xA0 bytes)
+	real source address = a(0xC1) << 8
+	real source address = 0xC100
+	DMA: transfer all bytes from 0xC100 to 0xC19F(0xA0 bytes)
 		to OAM (0xFE00 through 0xFE9F)
+
+	The bytes are copied all at once, straight from the page the
+	source is mapped to. The real transfer takes 160 machine cycles
+	and while it runs the CPU can only get at HRAM and the I/O
+	registers, so the rest of the memory map is locked until
+	GL_dma_event.
 */
-void GL_dma(byte source)
+void GL_dma(struct gb_context *gb, word reg, byte source)
 {
+	byte *page;
 	int x;
-	word address = (word)source * 100;
 
-	for(x = 0; x < 0xA0; x++)
+	gb->memory[0xFF46] = source;
+
+	/* Starting again part way through copies from the real map */
+	if(gb->dma_active)
+		memory_unlock(gb);
+
+	/* Sources past WRAM read from its echo, like the hardware */
+	if(source > 0xDF)
+		source -= 0x20;
+
+	page = gb->read_page[source];
+
+	if(page != NULL)
 	{
-		memory_writeb((0xFE00 + x), memory_readb(address + x));
+		memcpy(gb->memory + 0xFE00, page, 0xA0);
 	}
+	else
+	{
+		for(x = 0; x < 0xA0; x++)
+			gb->memory[0xFE00 + x] =
+				memory_readb(gb, (source << 8) + x);
+	}
+
+	/* Every sprite may have moved */
+	GL_build_sprite_lines(gb);
+
+	gb->dma_active = 1;
+	memory_lock(gb);
+	SCHEDULER_add(gb, EVENT_DMA, 640);
+}
+
+/* The DMA transfer has finished, give the CPU its bus back */
+void GL_dma_event(struct gb_context *gb, long due)
+{
+	gb->dma_active = 0;
+	memory_unlock(gb);
 }
 
 /*
-	Return true color value of TODO finish this
+	Tile data (0x8000-0x97FF) is written through here so the tile
+	cache knows which of the 384 tiles to decode again, the
+	background maps after it are written straight to memory
 */
-byte GL_get_bit_color(byte color)
+void GL_write_vram(struct gb_context *gb, word address, byte data)
 {
-	byte final_color, palette;
+	gb->memory[address] = data;
+	gb->tile_dirty[(address - 0x8000) >> 4] = 1;
 
-	palette = memory_readb(0xFF47);
+	if(gb->cache_marks[address])
+		CACHE_invalidate(gb, address);
+}
 
-	if(color > 0)
-		printf("DBG VIDEO BIT COLOR: %x\n", color);
-	printf("DBG VIDEO PALETTE: %x\n", palette);
+/* Decode a tile from VRAM into the tile cache */
+void GL_decode_tile(struct gb_context *gb, int tile)
+{
+	gb->decode_tile(gb->memory + 0x8000 + tile * 16, gb->tiles[tile][0]);
+	gb->tile_dirty[tile] = 0;
+}
 
-	switch(color)
-	{
-		case 0:
-		{
-			/*
-				If color is 0, we need to look for the bit
-				code in bit 0-1 of the palette.
-			*/
-			final_color = palette & 0x3;
+/* Add a sprite to or take it off the lines its Y position covers */
+static void GL_sprite_lines(struct gb_context *gb, int sprite, int add)
+{
+	uint64_t bit = (uint64_t)1 << sprite;
+	int line, end;
 
-			break;
-		}
-		case 1:
-		{
-			/*
-				Color == 1 (01) is associated with bit 2-3 of
-				the palette.
-			*/
-			final_color = palette & 0xC;
-			final_color >>= 2;
-
-			break;
-		}
-		case 2:
-		{
-			/*
-				Color == 2 (10) is associated with bit 4-5
-				of the color palette.
-			*/
-			final_color = palette & 0x30;
-			final_color >>= 4;
-
-			break;
-		}
-		case 3:
-		{
-			/*
-				Color == 3 (11) is associated with bit 6-7
-				of the color palette.
-			*/
-			final_color = palette & 0xC0;
-			final_color >>= 6;
-
-			break;
-		}
-	}
+	line = gb->memory[0xFE00 + sprite * 4] - 16;
+	end = line + gb->sprite_height;
 
-	if(final_color > 0)
-		printf("DBG VIDEO FINAL COLOR: %i\n", final_color);
+	if(line < 0)
+		line = 0;
+	if(end > 144)
+		end = 144;
 
-	return final_color;
+	for(; line < end; line++)
+	{
+		if(add)
+			gb->sprite_lines[line] |= bit;
+		else
+			gb->sprite_lines[line] &= ~bit;
+	}
 }
 
-void GL_draw_scanline()
+/* Put every sprite on its lines again, at the current sprite height */
+void GL_build_sprite_lines(struct gb_context *gb)
 {
-	byte LCD_status, LCD_control;
+	byte LCDC = gb->memory[0xFF40];
+	int sprite;
 
-	LCD_status = memory_readb(0xFF41);
-	LCD_control = memory_readb(0xFF40);
+	gb->sprite_height = bitset(&LCDC, 2) ? 16 : 8;
+	memset(gb->sprite_lines, 0, sizeof(gb->sprite_lines));
 
-	/*
-		If bit 0 of LCD control is set, then the background
-		is enabled, and we should draw them.
-	*/
-	if(bitset(&LCD_control, 0))
-		GL_draw_tiles();
+	for(sprite = 0; sprite < 40; sprite++)
+		GL_sprite_lines(gb, sprite, 1);
+}
 
-	/*
-		If bit 1 of the LCD control is set, then sprites are
-		enabled and we should draw them.
-	*/
-	if(bitset(&LCD_control, 1))
+/*
+	OAM (0xFE00-0xFE9F) is written through here, a change to a
+	sprite's Y position moves it from the lines it was on to the
+	ones it's on now
+*/
+void GL_write_oam(struct gb_context *gb, word address, byte data)
+{
+	int sprite = (address - 0xFE00) >> 2;
+
+	if(address < 0xFEA0 && (address & 3) == 0 &&
+		gb->memory[address] != data)
 	{
-		/*GL_draw_sprites();*/
+		GL_sprite_lines(gb, sprite, 0);
+		gb->memory[address] = data;
+		GL_sprite_lines(gb, sprite, 1);
+	}
+	else
+	{
+		gb->memory[address] = data;
 	}
-
-	/*
-		Now that the video buffer has been filled for this scanline,
-		go ahead and start the video library and put that data on
-		the screen.
-	*/
-	GL_SDL_draw_scanline();
 }
 
 /*
-	Fill video buffer with appropriate pixel data from this scanline
-	so that it can be rendered to the screen later.
+	Hook tile data writes up to the tile cache, nothing's decoded yet,
+	and OAM writes up to the sprite lines
 */
-/*void GL_draw_tiles()
-{*/
-	/*
-		Store memory regions for the maps and data
+void GL_init(struct gb_context *gb)
+{
+	memory_map(gb, 0x8000, 0x97FF, gb->memory + 0x8000, NULL);
+	memory_handle(gb, 0x8000, 0x97FF, NULL, GL_write_vram);
 
-		Map: A region of memory that contains a number that
-			corresponds to a particular tile to be displayed
+	memory_map(gb, 0xFE00, 0xFEFF, gb->memory + 0xFE00, NULL);
+	memory_handle(gb, 0xFE00, 0xFEFF, NULL, GL_write_oam);
 
-		Data: A region of memory that contains the actual tile
-			data that the map makes reference to
-	*/
-/*	word bg_map, bg_data, win_map, tileX, tileY, tile_location;
-	word temp_address;*/
+	memset(gb->tile_dirty, 1, sizeof(gb->tile_dirty));
+	GL_build_sprite_lines(gb);
 
-	/*
-		The background is 32*32 tiles (256*256 pixels) in total.
+	GL_SIMD_init(gb);
+}
 
-		Only part of this can be displayed on the 160*144 screen.
-		We'll call this the viewing area. ScrollX and ScrollY are
-		registers that determine where in this background the
-		viewing area is showing.
+/*
+	Return the true color value a color number from a tile maps to
+	in the background palette (0xFF47). Each color number has a
+	pair of bits in the palette, color 0 bits 0-1 up to color 3 in
+	bits 6-7, so games can switch colors around without having to
+	modify tile data. Whole lines go through gb->palette instead.
+*/
+byte GL_get_bit_color(struct gb_context *gb, byte color)
+{
+	byte final_color, palette;
 
-		In addition to this, we have the window, which is drawn on
-		top of the background. The window is positioned relative
-		to the viewing area and doesn't move. WinX and WinY are
-		where in the viewing area the window should be drawn.
+	palette = memory_readb(gb, 0xFF47);
+	final_color = (palette >> (color * 2)) & 3;
 
-		(Note: to draw the window in the top left position, WinX
-			must be 7 and WinY must be 0. The window X position
-			is offset by 7 for reasons unknown at this time)
-	*/ 
-/*	byte scrollX, scrollY, winX, winY;*/
+	TRACE3(TRACE_VIDEO_COLOR, color, palette, final_color);
 
-	/*
-		drawWindow - Are we drawing the window in this scanline?
-			Used as a boolean.
+	return final_color;
+}
 
-		scanline - What scanline we're currently drawing
+void GL_draw_scanline(struct gb_context *gb)
+{
+	byte LCD_status, LCD_control, scanline, x;
+	/* The background's color numbers, before the palette */
+	byte line[160];
+	byte *pixel;
 
-		usingSigned - Certain tile data regions use signed numbers,
-			this will designate if we're using one. Used as
-			boolean
+	LCD_status = memory_readb(gb, 0xFF41);
+	LCD_control = memory_readb(gb, 0xFF40);
+	scanline = memory_readb(gb, 0xFF44);
+	pixel = gb->video_buffer[scanline];
 
-		LCDC - Used to store the LCD Control register
+	TRACE1(TRACE_VIDEO_SCANLINE, scanline);
 
-		pixelLoc - Where on the scanline we're smactually drawing
+	/*
+		If bit 0 of LCD control is set, then the background
+		is enabled, and we should draw them. Otherwise the
+		background is white, and color 0 as far as sprites
+		are concerned.
 	*/
-/*	byte drawWindow, scanline, usingSigned, LCDC, pixelLoc;*/
+	if(bitset(&LCD_control, 0))
+	{
+		GL_draw_tiles(gb, line);
+		gb->palette(pixel, line, 160, memory_readb(gb, 0xFF47));
+	}
+	else
+	{
+		memset(line, 0, sizeof(line));
+		memset(pixel, 0, 160);
+	}
 
 	/*
-		These will be used to store actual tile data
+		If bit 1 of the LCD control is set, then sprites are
+		enabled and we should draw them.
 	*/
-/*	byte tile_ident, tile_byte1, tile_byte2, tile_line, tile_color;
-	byte tile_offset, true_color;*/
+	if(bitset(&LCD_control, 1))
+		GL_draw_sprites(gb, line, pixel);
 
-	/* Assume we're not using the window until proven guilty */
-/*	drawWindow = 0;*/
-	/* Get current ScrollX (register 0xFF43) */
-/*	scrollX = memory_readb(0xFF43);*/
-	/* Get current ScrollY (register 0xFF42) */
-/*	scrollY = memory_readb(0xFF42);*/
-	/* Get current scanline (register LY: 0xFF44) */
-/*	scanline = memory_readb(0xFF44);*/
-	/* Get current LCDC (register 0xFF40) */
-/*	LCDC = memory_readb(0xFF40);*/
+	if(trace_enabled[TRACE_VIDEO_PIXEL])
+	{
+		for(x = 0; x < 160; x++)
+			TRACE2(TRACE_VIDEO_PIXEL, x, pixel[x]);
+	}
+}
 
-	/* Check if the window is enabled (bit 5 in the LCDC) */
-/*	if(bitset(&LCDC, 5))
-	{*/
-		/*
-			See if the window will be being drawn this scanline:
+/*
+	Lay count 8 pixel rows from the tile cache end to end in out,
+	for the tiles at first and on along one row of a 32*32 tile
+	map, wrapping at the end of the row. tile_y is the line of the
+	tiles wanted.
+*/
+static void GL_tile_rows(struct gb_context *gb, word map, int first,
+	int count, byte tile_y, byte LCDC, byte *out)
+{
+	int i, tile;
+	byte tile_ident;
 
-			If winY <= scanline, then the window may be being
-			drawn, if the Y position of the window is greater
-			than the current scanline, then the window has not
-			come into play yet and drawWindow will remain reset
-			(false)
-		*/
-/*		if(winY <= scanline)
-			drawWindow = 1;*/
+	for(i = 0; i < count; i++)
+	{
+		/* The LCD reads VRAM itself, OAM DMA doesn't lock it out */
+		tile_ident = gb->memory[map + ((first + i) & 31)];
 
 		/*
-			If window is enabled, check to see where the
-			window map is located.
-			-TODO figure out what the ****'s up with the
-				window being in the bg map
-
-			Bit 6 of the LCDC register determines the location
-			of the window map.
-
-			0 - 0x9800-9BFF
-			1 - 0x9C00-9FFF
+			With bit 4 set tile numbers count up from 0x8000,
+			otherwise they're signed around 0x9000, tile 256
 		*/
-/*		if(bitset(&LCDC, 6))
-			bg_map = 0x9C00;
+		if(bitset(&LCDC, 4))
+			tile = tile_ident;
 		else
-			bg_map = 0x9800;
-	}
-	else
-	{*/
-		/*
-			If window not enabled, the bg map will be determined
-			by a different bit, though the locations will be the
-			same per bit as if the window was enabled
+			tile = 256 + (signed char)tile_ident;
 
-			(Bit 3 of LCDC is the non-windowed BG map select)
-		*/
-/*		if(bitset(&LCDC, 3))
-			bg_map = 0x9C00;
-		else
-			bg_map = 0x9800;
-	}*/
+		if(gb->tile_dirty[tile])
+			GL_decode_tile(gb, tile);
 
-	/*
-		Now that we have the map locations figured out, let's deal
-		with the tile data locations.
+		memcpy(out + i * 8, gb->tiles[tile][tile_y], 8);
+	}
+}
 
-		There are two locations the tile data can be, this can be
-		determined by bit 4 in the LCDC.
+/*
+	Fill line with this scanline of the background's color numbers,
+	with the window over it if it's on.
+
+	The background map is 32*32 tile numbers, the scroll registers
+	pick which 160 pixels of the 256 pixel wide line we see. Every
+	tile the line crosses gives one 8 pixel row from the tile cache,
+	those are laid end to end and the line is shifted by the fine
+	horizontal scroll on the way out.
+
+	The window doesn't scroll, its top left corner is at WX - 7, WY
+	on screen (0xFF4B, 0xFF4A) and it covers everything right of
+	and below that. It's drawn the same way from its own map (bit 6
+	of LCDC), except its lines are counted separately: the window
+	line only moves on when a line of the window was drawn, so a
+	window hidden for a few lines carries on where it left off.
+*/
+void GL_draw_tiles(struct gb_context *gb, byte *line)
+{
+	word map;
+	byte line_y, scrollX, scrollY, scanline, LCDC, winX, winY;
+	int start, skip;
+	/* 21 tiles, so a line scrolled part way into a tile still fits */
+	byte rows[21 * 8];
 
-		0: 0x8800-0x97FF
-		1: 0x8000-0x8FFF
+	scrollX = memory_readb(gb, 0xFF43);
+	/* Get current ScrollY (register 0xFF42) */
+	scrollY = memory_readb(gb, 0xFF42);
+	/* Get current scanline (register LY: 0xFF44) */
+	scanline = memory_readb(gb, 0xFF44);
+	/* Get current LCDC (register 0xFF40) */
+	LCDC = memory_readb(gb, 0xFF40);
 
-		One major thing to keep in mind with the tile data is that
-		if bit 4 is 0, then the tile data TODO ? will be signed, not
-		unsigned
-	*/
-/*	if(bitset(&LCDC, 4))
-	{
-		bg_data = 0x8000;
-		usingSigned = 0;
-	}
+	if(bitset(&LCDC, 3))
+		map = 0x9C00;
 	else
-	{
-		bg_data = 0x8800;
-		usingSigned = 1;
-	}*/
+		map = 0x9800;
 
-	/*
-		Get the overall vertical tile we're scanning, since
-		tileY is a byte type, this should just give us the
-		rounded vertical tile number
-	*/
-/*	tileY = ((scrollY + scanline) / 8);*/
-	/*printf("DBG VIDEO TILEY: %i\n", tileY);*/
+	/* The line of the background we're on, wrapping at the bottom */
+	line_y = scrollY + scanline;
 
-/*	for(pixelLoc = 0; pixelLoc < 160; pixelLoc++)
-	{*/
-		/*
-			Now we need to find out a bunch of information
-			before we can start drawing to the video buffer.
+	GL_tile_rows(gb, map + (line_y / 8) * 32, scrollX / 8, 21,
+		line_y % 8, LCDC, rows);
+	memcpy(line, rows + scrollX % 8, 160);
 
-			First we need to determine which horizontal and
-			vertical tile in the overall background map (not
-			just the viewing area, but the complete 32*32 map)
-			we're at.
-		*/
-/*		tileX = ((pixelLoc + scrollX) / 8);*/
-		/*printf("DBG VIDEO TILEX: %i\n", tileX);*/
+	/* Check if the window is enabled (bit 5 in the LCDC) */
+	if(!bitset(&LCDC, 5))
+		return;
 
-		/*
-			Now let's find out the tile identification number
-			for the tile we're over
+	winX = memory_readb(gb, 0xFF4B);
+	winY = memory_readb(gb, 0xFF4A);
 
-			TODO strip these under 80 chars
-		*/
-/*		if(usingSigned == 0)
-			tile_ident = memory_readb(bg_map + tileX + (tileY * 32));
-		else
-			tile_ident = (signed)memory_readb(bg_map + tileX + (tileY * 32));
+	if(winY > scanline || winX > 166)
+		return;
 
-		printf("DBG VIDEO TILE MAKEUP: BG_MAP: %X; tileX: %i; tileY: %i; identloc: %X\n",
-			bg_map, tileX, tileY, (bg_map+tileX+(tileY*32)));
+	if(bitset(&LCDC, 6))
+		map = 0x9C00;
+	else
+		map = 0x9800;
 
-		if(tile_ident > 0)
-			printf("DBG VIDEO TILEI: %i\n", tile_ident);*/
+	/* With WX under 7 the window's left edge is off screen */
+	start = winX - 7;
+	skip = 0;
+	if(start < 0)
+	{
+		skip = -start;
+		start = 0;
+	}
 
-		/*
-			Now we know the number of the tile we want, let's
-			get dat tile data.
-
-			First we'll find the exact location in memory the
-			tile data is located at. bg_data is our starting
-			tile data location, we'll add an offset of tile
-			identification number * 16 (each tile is 16 bytes)
-			Example: bg_data starts at 0x8000, tile_ident is
-			35, 0x8000 + (35 * size of tile(16)); tile_location
-			= 0x8230 TODO add info on signed  location
-		*/
-/*		if(usingSigned == 0)
-			tile_location = bg_data + (tile_ident * 16);
-		else
-			tile_location = bg_data + ((tile_ident + 128) * 16);
+	GL_tile_rows(gb, map + (gb->window_line / 8) * 32, 0,
+		(skip + 160 - start + 7) / 8, gb->window_line % 8, LCDC, rows);
+	memcpy(line + start, rows + skip, 160 - start);
 
-		printf("DBG VIDEO BGDATA: BG_MAP: %X; U_OFFSET: %X; TOTAL: %X\n",
-			bg_data, (tile_ident * 16), tile_location);*/
+	gb->window_line++;
+}
 
-		/*
-			Now let's figure out which line of the tile we're
-			going to be drawing
-		*/
-/*		tile_line = (tileY % 8) * 2;*/
+/*
+	Draw this scanline's sprites over the background.
 
-		/*
-			Read in the actual tile data finally
-		*/
-/*		tile_byte1 = memory_readb(tile_location + tile_line);
-		tile_byte2 = memory_readb(tile_location + tile_line + 1);*/
+	OAM holds 40 sprites of 4 bytes: Y + 16, X + 8, tile number
+	and attributes. The attributes are:
 
-		/*
-			Now we have the whole tile block we need, but
-			because of scrolling we'll often be drawing
-			part of a tile. Let's figure out how far into
-			the tile (horizontally) we're going to actually
-			start from.
-		*/
-/*		tile_offset = (scrollX % 8) * 2;*/
+	bit 7 - behind background colors 1-3
+	bit 6 - Y flip
+	bit 5 - X flip
+	bit 4 - palette, OBP0 (0xFF48) or OBP1 (0xFF49)
 
-		/*
-			Are we done yet? NOPE! Now we need to read in
-			the color information from the tile data bytes.
+	Only the first 10 sprites in OAM on a line are shown. Where
+	sprites overlap the one with the lower X wins, then the one
+	first in OAM, so they're drawn the other way round with each
+	one covering the last. Whether the winner shows over the
+	background is worked out for the whole line at the end.
 
-			The color data is two bits, say we're reading
-			the fourth pixel in the tile. The first color bit
-			is in bit 3 of tile_data2, the second color bit
-			will be in bit 3 of tile_data1.
+	bg is the background's color numbers, pixel the line in the
+	video buffer.
+*/
+void GL_draw_sprites(struct gb_context *gb, const byte *bg, byte *pixel)
+{
+	/* Indexed by X, screen pixel 0 is at 8 */
+	byte color[256 + 8], opaque[256 + 8], front[256 + 8];
+	byte sprites[10], row[8], shades[8], palettes[2];
+	const byte *oam, *source;
+	uint64_t lines;
+	int count, i, j, x, y, tile, start, end;
+	byte scanline, LCDC, sprite, attributes, mask, in_front;
 
-			So, bit 3 of tile_data2: 1
-			bit 3 of tile_data1: 0
+	scanline = memory_readb(gb, 0xFF44);
+	LCDC = memory_readb(gb, 0xFF40);
 
-			Color value: 10 (2)
-		*/
-/*		tile_color = bitset(&tile_byte2, tile_offset) << 1;
-		tile_color += bitset(&tile_byte1, tile_offset);*/
+	/* Sprites are 8*16 when bit 2 is set */
+	if(gb->sprite_height != (bitset(&LCDC, 2) ? 16 : 8))
+		GL_build_sprite_lines(gb);
 
-		/*
-			My brain hurts, seriously. Now we must compare
-			this color value to the palette register (0xFF47).
-
-			tile_color will correspond to a bit pair in the
-			palette register. This bit pair in the palette
-			register will correspond to the actual color.
-			Doing colors this way will allow games to switch
-			colors around without having to modify tile data.
-			Think mario when he becomes invincible, blinking
-			with different colors, this is done by simple
-			palette manipulation.
-
-			Here we're calling GL_get_color to get the true
-			color identification number which will be put
-			into the video buffer.
-		*/
-/*		true_color = GL_get_bit_color(tile_color);*/
+	count = 0;
+	lines = gb->sprite_lines[scanline];
 
-		/*
-			Here we're going to put the true color identifier
-			number into the video buffer at the appropriate
-			location.
+	for(i = 0; lines != 0 && count < 10; i++, lines >>= 1)
+	{
+		if(lines & 1)
+			sprites[count++] = i;
+	}
 
-			We will be done here and soon the graphics library
-			will do the final drawing to the screen according
-			to the data in the video buffer.
+	if(count == 0)
+		return;
 
-			We're done now. Congrats.
-		*/
-/*		if(true_color > 0)
-			printf("DBG VIDEO TRUECOLOR > 0: %i\n", true_color);
+	/* Lowest X first, OAM order stays for the same X */
+	for(i = 1; i < count; i++)
+	{
+		sprite = sprites[i];
+		x = gb->memory[0xFE01 + sprite * 4];
+
+		for(j = i; j > 0 &&
+			gb->memory[0xFE01 + sprites[j - 1] * 4] > x; j--)
+			sprites[j] = sprites[j - 1];
 
-		video_buffer[scanline][pixelLoc] = true_color;
+		sprites[j] = sprite;
 	}
-}*/
 
-void GL_draw_tiles()
-{
-        int i;
-        word map, tiles, tile_loc;
-        byte tileY, tileX, tile_ident, tile_line, tile_data1, tile_data2;
-        byte tile_offset, tile_color;
-	byte scrollX, scrollY, scanline, LCDC, true_color;
+	palettes[0] = memory_readb(gb, 0xFF48);
+	palettes[1] = memory_readb(gb, 0xFF49);
 
-        scrollX = memory_readb(0xFF43);
-        /* Get current ScrollY (register 0xFF42) */
-        scrollY = memory_readb(0xFF42);
-        /* Get current scanline (register LY: 0xFF44) */
-        scanline = memory_readb(0xFF44);
-        /* Get current LCDC (register 0xFF40) */
-        LCDC = memory_readb(0xFF40);
+	/* Only the span the sprites cover needs clearing and merging */
+	start = gb->memory[0xFE01 + sprites[0] * 4];
+	end = gb->memory[0xFE01 + sprites[count - 1] * 4] + 8;
 
-        if(bitset(&LCDC, 3))
-                map = 0x9C00;
-        else
-                map = 0x9800;
+	memset(color + start, 0, end - start);
+	memset(opaque + start, 0, end - start);
+	memset(front + start, 0, end - start);
 
-        if(bitset(&LCDC, 4))
-                tiles = 0x8000;
-        else
-                tiles = 0x8800;
+	for(i = count - 1; i >= 0; i--)
+	{
+		oam = gb->memory + 0xFE00 + sprites[i] * 4;
+		attributes = oam[3];
 
-        tileY = ((scrollY + scanline) / 8);
+		y = scanline - (oam[0] - 16);
+		if(attributes & 0x40)
+			y = gb->sprite_height - 1 - y;
 
-        for(i = 0; i < 160; i++)
-        {
-                tileX = ((i + scrollX) / 8);
+		/* The bottom of an 8*16 sprite is the next tile */
+		tile = oam[2];
+		if(gb->sprite_height == 16)
+			tile &= 0xFE;
+		tile += y / 8;
 
-                tile_ident = memory_readb(map + tileX + (tileY * 32));
+		if(gb->tile_dirty[tile])
+			GL_decode_tile(gb, tile);
 
-                tile_loc = tiles + (tile_ident * 16);
+		source = gb->tiles[tile][y % 8];
 
-		tile_line = (scanline % 8);
+		if(attributes & 0x20)
+		{
+			for(j = 0; j < 8; j++)
+				row[j] = source[7 - j];
+		}
+		else
+		{
+			memcpy(row, source, 8);
+		}
 
-                tile_data1 = memory_readb(tile_loc + tile_line);
-                tile_data2 = memory_readb(tile_loc + tile_line + 1);
+		gb->palette(shades, row, 8, palettes[(attributes >> 4) & 1]);
 
-                /* no horizontal offset yet */
+		in_front = (attributes & 0x80) ? 0x00 : 0xFF;
+		x = oam[1];
 
-                tile_offset = (i % 8) * 2;
-                tile_color = bitset(&tile_data2, tile_offset) << 1;
-                tile_color += bitset(&tile_data1, tile_offset);
+		/* Color 0 is transparent */
+		for(j = 0; j < 8; j++, x++)
+		{
+			mask = -(row[j] != 0);
 
-                true_color = GL_get_bit_color(tile_color);
+			color[x] = (color[x] & ~mask) | (shades[j] & mask);
+			front[x] = (front[x] & ~mask) | (in_front & mask);
+			opaque[x] |= mask;
+		}
+	}
 
-                video_buffer[scanline][i] = true_color;
-        }
-}
+	/* Sprites behind the background only show over its color 0 */
+	if(start < 8)
+		start = 8;
+	if(end > 168)
+		end = 168;
 
+	for(x = start; x < end; x++)
+	{
+		mask = opaque[x] & (front[x] | -(bg[x - 8] == 0));
+		pixel[x - 8] = (pixel[x - 8] & ~mask) | (color[x] & mask);
+	}
+}
@@ -24,13 +24,17 @@
 
 #include "memory.h"
 
-byte video_buffer[144][160];
-
-void GL_init();
-void GL_dma(byte);
-byte GL_get_bit_color(byte);
-void GL_draw_scanline();
-void GL_draw_tiles();
-void GL_draw_sprites();
+
+void GL_init(struct gb_context*);
+void GL_write_vram(struct gb_context*, word, byte);
+void GL_decode_tile(struct gb_context*, int);
+void GL_write_oam(struct gb_context*, word, byte);
+void GL_build_sprite_lines(struct gb_context*);
+void GL_dma(struct gb_context*, word, byte);
+void GL_dma_event(struct gb_context*, long);
+byte GL_get_bit_color(struct gb_context*, byte);
+void GL_draw_scanline(struct gb_context*);
+void GL_draw_tiles(struct gb_context*, byte*);
+void GL_draw_sprites(struct gb_context*, const byte*, byte*);
 
 #endif
@@ -0,0 +1,928 @@
+/*
+	Copyright 2012, 2013 Charles O.
+	Email: charles.0x4f@gmail.com
+	Github: https://github.com/charles-0x4f/
+
+	This file is part of TermGB.
+
+	TermGB is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	TermGB is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with TermGB.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/* gl_ansi.c */
+
+/* For write(), termios and the terminal's size */
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <termios.h>
+#include <sys/ioctl.h>
+#include "gb.h"
+#include "gl_ansi.h"
+
+/*
+	No cell takes more than 32 bytes: a cursor move, a color change
+	and a 3 byte character
+*/
+#define ANSI_BUFFER_SIZE (ANSI_ROWS * 160 * 32)
+
+/*
+	The shades are the 16 color palette's white, light grey, dark
+	grey and black, the shortest color escapes there are
+*/
+static const int fg_codes[4] = { 97, 37, 90, 30 };
+static const int bg_codes[4] = { 107, 47, 100, 40 };
+
+/*
+	Ordered dither thresholds for the 2*4 pixels of a braille cell,
+	a dot is lit when a pixel's lightness (3 - shade) * 8 beats
+	three times its threshold, so 0, 3, 6 or all 8 dots of a cell
+	light up for the four shades
+*/
+static const int dither[4][2] = {
+	{ 0, 4 },
+	{ 6, 2 },
+	{ 1, 5 },
+	{ 7, 3 }
+};
+
+/* Which bit of a braille character each dot is, by row and column */
+static const int dot_bits[4][2] = {
+	{ 0x01, 0x08 },
+	{ 0x02, 0x10 },
+	{ 0x04, 0x20 },
+	{ 0x40, 0x80 }
+};
+
+/*
+	For each column of a braille cell, the dots for its four pixels
+	packed as shade | shade << 2 | shade << 4 | shade << 6 from the
+	top down, and each of the 256 braille characters in UTF-8, built
+	by GL_ANSI_braille_init
+*/
+static byte braille_dots[2][256];
+static char braille_text[256][3];
+
+/*
+	For the sixel mode, the bits of three pixels stacked up by shade,
+	indexed by shade | shade << 2 | shade << 4 from the top down:
+	byte n has the bits of the ones in shade n. A column of a sixel
+	band is two of them, the lower shifted up 3.
+*/
+static uint32_t sixel_masks[64];
+
+/*
+	For the kitty mode, a PNG's worth of space and the CRC-32 of
+	each byte for its chunks
+*/
+#define PNG_ROW (1 + 160 / 4)
+#define PNG_SIZE (8 + 25 + 24 + 12 + 2 + 5 + 144 * PNG_ROW + 4 + 12)
+
+static byte png[PNG_SIZE];
+static uint32_t crc_table[256];
+
+/* The terminal's settings from before, for GL_ANSI_exit */
+static struct termios saved_termios;
+static int termios_changed;
+
+/*
+	A way of drawing a cell and the colors it needs, -1 for a color
+	that doesn't matter
+*/
+struct ansi_glyph {
+	const char *text;
+	int length;
+	int fg, bg;
+};
+
+/*
+	The two ways of drawing each cell, which the cheaper is picked
+	from given the colors already set: a space or a full block for a
+	solid cell, otherwise the upper half block or the lower half
+	block with the colors the other way around
+*/
+static void ANSI_glyphs(byte cell, struct ansi_glyph *glyphs)
+{
+	int top = cell >> 2, bottom = cell & 3;
+
+	if(top == bottom)
+	{
+		glyphs[0].text = " ";
+		glyphs[0].length = 1;
+		glyphs[0].fg = -1;
+		glyphs[0].bg = top;
+
+		glyphs[1].text = "\342\226\210";
+		glyphs[1].length = 3;
+		glyphs[1].fg = top;
+		glyphs[1].bg = -1;
+	}
+	else
+	{
+		glyphs[0].text = "\342\226\200";
+		glyphs[0].length = 3;
+		glyphs[0].fg = top;
+		glyphs[0].bg = bottom;
+
+		glyphs[1].text = "\342\226\204";
+		glyphs[1].length = 3;
+		glyphs[1].fg = bottom;
+		glyphs[1].bg = top;
+	}
+}
+
+static int ANSI_digits(int n)
+{
+	return (n >= 100) ? 3 : (n >= 10) ? 2 : 1;
+}
+
+/* Bytes it'd take to change to these colors from the ones set */
+static int ANSI_color_cost(struct gb_context *gb, int fg, int bg)
+{
+	int length = 0;
+
+	if(fg >= 0 && fg != gb->term_fg)
+		length += ANSI_digits(fg_codes[fg]) + 1;
+	if(bg >= 0 && bg != gb->term_bg)
+		length += ANSI_digits(bg_codes[bg]) + 1;
+
+	/* The ESC [ and the m, which takes the last ;'s place */
+	return length ? length + 2 : 0;
+}
+
+static char *ANSI_color(struct gb_context *gb, char *out, int fg, int bg)
+{
+	int fg_changed = fg >= 0 && fg != gb->term_fg;
+	int bg_changed = bg >= 0 && bg != gb->term_bg;
+
+	if(fg_changed && bg_changed)
+		out += sprintf(out, "\033[%i;%im", fg_codes[fg],
+			bg_codes[bg]);
+	else if(fg_changed)
+		out += sprintf(out, "\033[%im", fg_codes[fg]);
+	else if(bg_changed)
+		out += sprintf(out, "\033[%im", bg_codes[bg]);
+
+	if(fg_changed)
+		gb->term_fg = fg;
+	if(bg_changed)
+		gb->term_bg = bg;
+
+	return out;
+}
+
+/* Draw a cell at the cursor whichever way is cheaper */
+static char *ANSI_cell(struct gb_context *gb, char *out, byte cell)
+{
+	struct ansi_glyph glyphs[2], *glyph = &glyphs[0];
+
+	if(gb->term_mode == ANSI_BRAILLE)
+	{
+		memcpy(out, braille_text[cell], 3);
+		return out + 3;
+	}
+
+	ANSI_glyphs(cell, glyphs);
+
+	if(ANSI_color_cost(gb, glyphs[1].fg, glyphs[1].bg) +
+		glyphs[1].length <
+		ANSI_color_cost(gb, glyphs[0].fg, glyphs[0].bg) +
+		glyphs[0].length)
+		glyph = &glyphs[1];
+
+	out = ANSI_color(gb, out, glyph->fg, glyph->bg);
+	memcpy(out, glyph->text, glyph->length);
+
+	return out + glyph->length;
+}
+
+/*
+	Bytes it'd take to draw the cells from the cursor up to x again,
+	in the colors already set, -1 if any of them needs others. These
+	cells haven't changed, so term_cells is what they're showing.
+*/
+static int ANSI_redraw_cost(struct gb_context *gb, int y, int x)
+{
+	struct ansi_glyph glyphs[2];
+	int column, length = 0, best, i;
+
+	/* Braille's all one color */
+	if(gb->term_mode == ANSI_BRAILLE)
+		return (x - gb->term_column) * 3;
+
+	for(column = gb->term_column; column < x; column++)
+	{
+		ANSI_glyphs(gb->term_cells[y][column], glyphs);
+		best = -1;
+
+		for(i = 0; i < 2; i++)
+		{
+			if(ANSI_color_cost(gb, glyphs[i].fg, glyphs[i].bg) == 0
+				&& (best < 0 || glyphs[i].length < best))
+				best = glyphs[i].length;
+		}
+
+		if(best < 0)
+			return -1;
+
+		length += best;
+	}
+
+	return length;
+}
+
+/* A cursor movement escape, the count is left out when it's 1 */
+static int ANSI_csi(char *out, int count, char command)
+{
+	if(count == 1)
+		return sprintf(out, "\033[%c", command);
+
+	return sprintf(out, "\033[%i%c", count, command);
+}
+
+/*
+	Move along the line from column from (-1 if it isn't known) to
+	x, returning the length
+*/
+static int ANSI_along(char *out, int from, int x)
+{
+	if(from == x)
+		return 0;
+
+	if(x == 0)
+	{
+		*out = '\r';
+		return 1;
+	}
+
+	if(from >= 0 && x > from)
+		return ANSI_csi(out, x - from, 'C');
+	if(from >= 0 && from - x < x + 1)
+		return ANSI_csi(out, from - x, 'D');
+
+	return ANSI_csi(out, x + 1, 'G');
+}
+
+/*
+	Move the cursor to row y, column x with the shortest of:
+
+	the cursor position escape,
+	moving up or down and then along the line,
+	a carriage return and line feeds down, then along the line,
+	or, on the same row, drawing the cells in between again
+*/
+static char *ANSI_move(struct gb_context *gb, char *out, int y, int x)
+{
+	char moves[3][32];
+	int lengths[3], best, i, rows, redraw;
+
+	if(x == 0 && y == 0)
+		lengths[0] = sprintf(moves[0], "\033[H");
+	else if(x == 0)
+		lengths[0] = sprintf(moves[0], "\033[%iH", y + 1);
+	else
+		lengths[0] = sprintf(moves[0], "\033[%i;%iH", y + 1, x + 1);
+
+	lengths[1] = lengths[2] = -1;
+	rows = y - gb->term_row;
+
+	if(gb->term_row >= 0)
+	{
+		lengths[1] = 0;
+		if(rows > 0)
+			lengths[1] = ANSI_csi(moves[1], rows, 'B');
+		else if(rows < 0)
+			lengths[1] = ANSI_csi(moves[1], -rows, 'A');
+
+		lengths[1] += ANSI_along(moves[1] + lengths[1],
+			gb->term_column, x);
+	}
+
+	/* Line feeds are only worth it for a few rows */
+	if(gb->term_row >= 0 && rows > 0 && rows < 8)
+	{
+		moves[2][0] = '\r';
+		memset(moves[2] + 1, '\n', rows);
+		lengths[2] = 1 + rows;
+		lengths[2] += ANSI_along(moves[2] + lengths[2], 0, x);
+	}
+
+	best = 0;
+	for(i = 1; i < 3; i++)
+	{
+		if(lengths[i] >= 0 && lengths[i] < lengths[best])
+			best = i;
+	}
+
+	if(rows == 0 && gb->term_column >= 0 && gb->term_column < x)
+	{
+		redraw = ANSI_redraw_cost(gb, y, x);
+
+		if(redraw >= 0 && redraw <= lengths[best])
+		{
+			for(i = gb->term_column; i < x; i++)
+				out = ANSI_cell(gb, out, gb->term_cells[y][i]);
+
+			gb->term_column = x;
+			return out;
+		}
+	}
+
+	memcpy(out, moves[best], lengths[best]);
+	gb->term_row = y;
+	gb->term_column = x;
+
+	return out + lengths[best];
+}
+
+/* Write all of it, returning how many write() calls that took */
+static unsigned long ANSI_write(const char *data, size_t length)
+{
+	unsigned long calls = 0;
+	ssize_t written;
+
+	while(length > 0)
+	{
+		written = write(STDOUT_FILENO, data, length);
+		calls++;
+
+		if(written < 0)
+		{
+			if(errno == EINTR)
+				continue;
+			break;
+		}
+
+		data += written;
+		length -= written;
+	}
+
+	return calls;
+}
+
+/* Send the frame put together in term_buffer up to out */
+static void ANSI_send(struct gb_context *gb, char *out)
+{
+	size_t length = out - gb->term_buffer;
+
+	gb->term_frames++;
+	gb->term_bytes += length;
+	gb->term_writes += ANSI_write(gb->term_buffer, length);
+}
+
+/*
+	Get the terminal ready for a picture columns*rows cells big,
+	setup is sent first, and sets the colors the picture starts with
+*/
+static void ANSI_start(struct gb_context *gb, int columns, int rows,
+	const char *setup, const char *name)
+{
+	struct winsize size;
+	struct termios quiet;
+
+	/* Anything smaller would clip or wrap the picture */
+	if(ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 &&
+		(size.ws_row < rows || size.ws_col < columns))
+	{
+		fprintf(stderr, "The %s frontend needs a terminal of at "
+			"least %ix%i, this one is %ix%i\n", name, columns,
+			rows, size.ws_col, size.ws_row);
+		exit(1);
+	}
+
+	gb->term_buffer = malloc(ANSI_BUFFER_SIZE);
+	if(gb->term_buffer == NULL)
+	{
+		fprintf(stderr, "Couldn't allocate the terminal buffer\n");
+		exit(1);
+	}
+
+	/* Keys typed would otherwise be echoed over the picture */
+	if(tcgetattr(STDIN_FILENO, &saved_termios) == 0)
+	{
+		quiet = saved_termios;
+		quiet.c_lflag &= ~(ECHO | ICANON);
+		tcsetattr(STDIN_FILENO, TCSANOW, &quiet);
+		termios_changed = 1;
+	}
+
+	/* Anything printed so far has to come out before the picture */
+	fflush(stdout);
+	ANSI_write(setup, strlen(setup));
+
+	/* Nothing's on screen yet, so every cell has changed */
+	memset(gb->term_cells, 0xFF, sizeof(gb->term_cells));
+	gb->term_row = gb->term_column = -1;
+}
+
+void GL_ANSI_init(struct gb_context *gb)
+{
+	ANSI_start(gb, 160, ANSI_ROWS,
+		"\033[?1049h\033[?25l\033[0m\033[2J", "ansi");
+	gb->term_fg = gb->term_bg = -1;
+	gb->term_mode = ANSI_HALF_BLOCKS;
+
+	gb->draw_frame = GL_ANSI_draw_frame;
+}
+
+/*
+	Build the dot and character tables, then start out with light
+	dots on black, clearing the screen to it
+*/
+void GL_ANSI_braille_init(struct gb_context *gb)
+{
+	int column, row, pixels, shade, dots, pattern;
+
+	for(column = 0; column < 2; column++)
+	{
+		for(pixels = 0; pixels < 256; pixels++)
+		{
+			dots = 0;
+
+			for(row = 0; row < 4; row++)
+			{
+				shade = pixels >> (row * 2) & 3;
+				if((3 - shade) * 8 > dither[row][column] * 3)
+					dots |= dot_bits[row][column];
+			}
+
+			braille_dots[column][pixels] = dots;
+		}
+	}
+
+	/* U+2800 on, the low 8 bits being the dots */
+	for(pattern = 0; pattern < 256; pattern++)
+	{
+		braille_text[pattern][0] = (char)0xE2;
+		braille_text[pattern][1] = (char)(0xA0 | pattern >> 6);
+		braille_text[pattern][2] = (char)(0x80 | (pattern & 0x3F));
+	}
+
+	ANSI_start(gb, BRAILLE_COLUMNS, BRAILLE_ROWS,
+		"\033[?1049h\033[?25l\033[97;40m\033[2J", "braille");
+	gb->term_fg = 0;
+	gb->term_bg = 3;
+	gb->term_mode = ANSI_BRAILLE;
+
+	gb->draw_frame = GL_ANSI_draw_braille;
+}
+
+void GL_ANSI_sixel_init(struct gb_context *gb)
+{
+	int pixels, row;
+
+	for(pixels = 0; pixels < 64; pixels++)
+	{
+		sixel_masks[pixels] = 0;
+
+		for(row = 0; row < 3; row++)
+			sixel_masks[pixels] |= (uint32_t)1 <<
+				((pixels >> (row * 2) & 3) * 8 + row);
+	}
+
+	ANSI_start(gb, 0, 0, "\033[?1049h\033[?25l\033[2J", "sixel");
+	memset(gb->term_picture, 0xFF, sizeof(gb->term_picture));
+	gb->term_mode = ANSI_SIXEL;
+
+	gb->draw_frame = GL_ANSI_draw_sixel;
+}
+
+void GL_ANSI_kitty_init(struct gb_context *gb)
+{
+	uint32_t crc;
+	int i, bit;
+
+	for(i = 0; i < 256; i++)
+	{
+		crc = i;
+		for(bit = 0; bit < 8; bit++)
+			crc = (crc & 1) ? 0xEDB88320 ^ (crc >> 1) : crc >> 1;
+
+		crc_table[i] = crc;
+	}
+
+	ANSI_start(gb, 0, 0, "\033[?1049h\033[?25l\033[2J", "kitty");
+	memset(gb->term_picture, 0xFF, sizeof(gb->term_picture));
+	gb->term_mode = ANSI_KITTY;
+
+	gb->draw_frame = GL_ANSI_draw_kitty;
+}
+
+void GL_ANSI_exit(struct gb_context *gb)
+{
+	static const char *mode_names[4] = {
+		"ansi", "braille", "sixel", "kitty"
+	};
+	static const char restore[] = "\033[0m\033[?25h\033[?1049l";
+	/* Take kitty's picture down too */
+	static const char kitty_delete[] = "\033_Ga=d,q=2\033\\";
+
+	if(gb->term_mode == ANSI_KITTY)
+		ANSI_write(kitty_delete, sizeof(kitty_delete) - 1);
+	ANSI_write(restore, sizeof(restore) - 1);
+
+	if(termios_changed)
+		tcsetattr(STDIN_FILENO, TCSANOW, &saved_termios);
+
+	free(gb->term_buffer);
+	gb->term_buffer = NULL;
+
+	if(gb->term_frames > 0)
+		printf("%s: %lu frames, %lu bytes and %.2f write() calls "
+			"per frame\n", mode_names[gb->term_mode],
+			gb->term_frames,
+			gb->term_bytes / gb->term_frames,
+			(double)gb->term_writes / gb->term_frames);
+}
+
+/*
+	Cells are worked out the same as for the curses frontend, the
+	top pixel's shade * 4 + the bottom's. Cells that changed are
+	drawn in order, the cursor only being moved over the ones that
+	didn't, so a run of changed cells is just their characters plus
+	any color changes. A frame where nothing changed isn't written
+	at all.
+*/
+void GL_ANSI_draw_frame(struct gb_context *gb, byte (*frame)[160])
+{
+	int x, y;
+	byte cell;
+	byte *top, *bottom, *old;
+	char *out = gb->term_buffer;
+
+	for(y = 0; y < ANSI_ROWS; y++)
+	{
+		top = frame[y * 2];
+		bottom = frame[y * 2 + 1];
+		old = gb->term_cells[y];
+
+		for(x = 0; x < 160; x++)
+		{
+			cell = (top[x] & 3) << 2 | (bottom[x] & 3);
+
+			if(cell == old[x])
+				continue;
+
+			if(y != gb->term_row || x != gb->term_column)
+				out = ANSI_move(gb, out, y, x);
+
+			old[x] = cell;
+			out = ANSI_cell(gb, out, cell);
+
+			/*
+				After the last column the cursor may be
+				waiting to wrap, so only trust it once it's
+				been moved
+			*/
+			gb->term_column = (x == 159) ? -1 : x + 1;
+		}
+	}
+
+	ANSI_send(gb, out);
+}
+
+/*
+	Each cell's dots are looked up a column at a time from its four
+	pixels, no branching per pixel. As every pattern is a braille
+	character there's no spare value for "not drawn yet" in
+	term_cells, so the first frame draws all of them.
+*/
+void GL_ANSI_draw_braille(struct gb_context *gb, byte (*frame)[160])
+{
+	int x, y, first = gb->term_frames == 0;
+	byte cell;
+	byte *line0, *line1, *line2, *line3, *old;
+	char *out = gb->term_buffer;
+
+	for(y = 0; y < BRAILLE_ROWS; y++)
+	{
+		line0 = frame[y * 4];
+		line1 = frame[y * 4 + 1];
+		line2 = frame[y * 4 + 2];
+		line3 = frame[y * 4 + 3];
+		old = gb->term_cells[y];
+
+		for(x = 0; x < BRAILLE_COLUMNS; x++)
+		{
+			cell = braille_dots[0][(line0[x * 2] & 3) |
+				(line1[x * 2] & 3) << 2 |
+				(line2[x * 2] & 3) << 4 |
+				(line3[x * 2] & 3) << 6] |
+				braille_dots[1][(line0[x * 2 + 1] & 3) |
+				(line1[x * 2 + 1] & 3) << 2 |
+				(line2[x * 2 + 1] & 3) << 4 |
+				(line3[x * 2 + 1] & 3) << 6];
+
+			if(cell == old[x] && !first)
+				continue;
+
+			if(y != gb->term_row || x != gb->term_column)
+				out = ANSI_move(gb, out, y, x);
+
+			old[x] = cell;
+			out = ANSI_cell(gb, out, cell);
+
+			gb->term_column = (x == BRAILLE_COLUMNS - 1) ?
+				-1 : x + 1;
+		}
+	}
+
+	ANSI_send(gb, out);
+}
+
+/*
+	Whether the frame's the same as the last one the image modes
+	sent, keeping it for next time if not
+*/
+static int ANSI_same_picture(struct gb_context *gb, byte (*frame)[160])
+{
+	if(memcmp(gb->term_picture, frame, sizeof(gb->term_picture)) == 0)
+		return 1;
+
+	memcpy(gb->term_picture, frame, sizeof(gb->term_picture));
+	return 0;
+}
+
+/*
+	The frame goes out a band of 6 lines at a time, with a line of
+	sixels for each shade in the band: one per pixel column, 63 + the
+	bits of the pixels in that shade from the top down. Pixels
+	without a bit are left alone, and every pixel's in one shade or
+	another, so the empty sixels at the end of a line needn't be
+	sent. More than 3 of the same sixel in a row are sent as a run.
+*/
+void GL_ANSI_draw_sixel(struct gb_context *gb, byte (*frame)[160])
+{
+	static const char start[] = "\033[H\033P0;1;0q\"1;1;160;144"
+		"#0;2;89;89;89#1;2;64;64;64#2;2;41;41;41#3;2;22;22;22";
+	uint32_t columns[160], used;
+	int band, x, shade, shift, end, run, carriage;
+	char sixels[160];
+	byte (*lines)[160];
+	char *out = gb->term_buffer;
+
+	if(ANSI_same_picture(gb, frame))
+	{
+		ANSI_send(gb, out);
+		return;
+	}
+
+	memcpy(out, start, sizeof(start) - 1);
+	out += sizeof(start) - 1;
+
+	for(band = 0; band < 144; band += 6)
+	{
+		lines = &frame[band];
+		used = 0;
+
+		for(x = 0; x < 160; x++)
+		{
+			columns[x] = sixel_masks[(lines[0][x] & 3) |
+				(lines[1][x] & 3) << 2 |
+				(lines[2][x] & 3) << 4] |
+				sixel_masks[(lines[3][x] & 3) |
+				(lines[4][x] & 3) << 2 |
+				(lines[5][x] & 3) << 4] << 3;
+			used |= columns[x];
+		}
+
+		carriage = 0;
+		for(shade = 0; shade < 4; shade++)
+		{
+			shift = shade * 8;
+			if((used >> shift & 0x3F) == 0)
+				continue;
+
+			/* Back to the start of the band for another shade */
+			if(carriage)
+				*out++ = '$';
+			carriage = 1;
+
+			out += sprintf(out, "#%i", shade);
+
+			for(x = 0; x < 160; x++)
+				sixels[x] = 63 + (columns[x] >> shift & 0x3F);
+
+			end = 160;
+			while(sixels[end - 1] == 63)
+				end--;
+
+			for(x = 0; x < end; x += run)
+			{
+				run = 1;
+				while(x + run < end &&
+					sixels[x + run] == sixels[x])
+					run++;
+
+				if(run > 3)
+				{
+					out += sprintf(out, "!%i%c", run,
+						sixels[x]);
+				}
+				else
+				{
+					memset(out, sixels[x], run);
+					out += run;
+				}
+			}
+		}
+
+		/* On to the next band */
+		if(band + 6 < 144)
+			*out++ = '-';
+	}
+
+	memcpy(out, "\033\\", 2);
+	ANSI_send(gb, out + 2);
+}
+
+static byte *PNG_long(byte *out, uint32_t value)
+{
+	out[0] = value >> 24;
+	out[1] = value >> 16;
+	out[2] = value >> 8;
+	out[3] = value;
+
+	return out + 4;
+}
+
+/* Start a chunk of the given type, returning where its data goes */
+static byte *PNG_chunk(byte *chunk, const char *type)
+{
+	memcpy(chunk + 4, type, 4);
+	return chunk + 8;
+}
+
+/* Finish a chunk whose data ends at out with its length and CRC */
+static byte *PNG_end(byte *chunk, byte *out)
+{
+	uint32_t crc = 0xFFFFFFFF;
+	byte *data;
+
+	PNG_long(chunk, out - chunk - 8);
+
+	for(data = chunk + 4; data < out; data++)
+		crc = crc_table[(crc ^ *data) & 0xFF] ^ (crc >> 8);
+
+	return PNG_long(out, crc ^ 0xFFFFFFFF);
+}
+
+/*
+	The frame as a PNG with a 2 bit palette of the four shades, so
+	each pixel's shade goes straight in, 4 to a byte. The image data
+	is a single stored deflate block, saving on zlib: it's only 6K.
+*/
+static size_t PNG_frame(byte (*frame)[160])
+{
+	static const byte signature[8] = {
+		0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'
+	};
+	static const byte header[13] = {
+		0, 0, 0, 160, 0, 0, 0, 144, 2, 3, 0, 0, 0
+	};
+	static const byte palette[12] = {
+		227, 227, 227, 163, 163, 163, 105, 105, 105, 56, 56, 56
+	};
+	uint32_t a = 1, b = 0;
+	byte *out = png, *chunk, *data, *line;
+	int x, y;
+
+	memcpy(out, signature, 8);
+	out += 8;
+
+	chunk = out;
+	out = PNG_chunk(chunk, "IHDR");
+	memcpy(out, header, 13);
+	out = PNG_end(chunk, out + 13);
+
+	chunk = out;
+	out = PNG_chunk(chunk, "PLTE");
+	memcpy(out, palette, 12);
+	out = PNG_end(chunk, out + 12);
+
+	chunk = out;
+	out = PNG_chunk(chunk, "IDAT");
+
+	/* zlib's header, then the stored block's, length and ~length */
+	*out++ = 0x78;
+	*out++ = 0x01;
+	*out++ = 1;
+	*out++ = (144 * PNG_ROW) & 0xFF;
+	*out++ = (144 * PNG_ROW) >> 8;
+	*out++ = ~(144 * PNG_ROW) & 0xFF;
+	*out++ = (~(144 * PNG_ROW) >> 8) & 0xFF;
+
+	data = out;
+	for(y = 0; y < 144; y++)
+	{
+		line = frame[y];
+
+		/* No filter */
+		*out++ = 0;
+
+		for(x = 0; x < 160; x += 4)
+			*out++ = (line[x] & 3) << 6 | (line[x + 1] & 3) << 4 |
+				(line[x + 2] & 3) << 2 | (line[x + 3] & 3);
+	}
+
+	for(; data < out; data++)
+	{
+		a = (a + *data) % 65521;
+		b = (b + a) % 65521;
+	}
+
+	out = PNG_long(out, b << 16 | a);
+	out = PNG_end(chunk, out);
+
+	chunk = out;
+	out = PNG_end(chunk, PNG_chunk(chunk, "IEND"));
+
+	return out - png;
+}
+
+static char *ANSI_base64(char *out, const byte *data, size_t length)
+{
+	static const char digits[] =
+		"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz"
+		"0123456789+/";
+	uint32_t group;
+	size_t i;
+
+	for(i = 0; i + 2 < length; i += 3)
+	{
+		group = (uint32_t)data[i] << 16 | data[i + 1] << 8 |
+			data[i + 2];
+		*out++ = digits[group >> 18];
+		*out++ = digits[group >> 12 & 0x3F];
+		*out++ = digits[group >> 6 & 0x3F];
+		*out++ = digits[group & 0x3F];
+	}
+
+	if(i < length)
+	{
+		group = (uint32_t)data[i] << 16;
+		if(i + 1 < length)
+			group |= data[i + 1] << 8;
+
+		*out++ = digits[group >> 18];
+		*out++ = digits[group >> 12 & 0x3F];
+		*out++ = (i + 1 < length) ? digits[group >> 6 & 0x3F] : '=';
+		*out++ = '=';
+	}
+
+	return out;
+}
+
+/*
+	The PNG goes to kitty base64'd in pieces of at most 4096, as the
+	protocol wants, the first one saying what it is: image 1 shown
+	in place 1 at the top left, replacing the last frame, without
+	any reply and leaving the cursor where it is
+*/
+void GL_ANSI_draw_kitty(struct gb_context *gb, byte (*frame)[160])
+{
+	size_t length, sent, piece;
+	char *out = gb->term_buffer;
+
+	if(ANSI_same_picture(gb, frame))
+	{
+		ANSI_send(gb, out);
+		return;
+	}
+
+	length = PNG_frame(frame);
+
+	memcpy(out, "\033[H", 3);
+	out += 3;
+
+	for(sent = 0; sent < length; sent += piece)
+	{
+		piece = length - sent;
+		if(piece > 3072)
+			piece = 3072;
+
+		out += sprintf(out, "\033_G%sm=%i;", (sent == 0) ?
+			"a=T,f=100,i=1,p=1,q=2,C=1," : "",
+			sent + piece < length);
+		out = ANSI_base64(out, png + sent, piece);
+		memcpy(out, "\033\\", 2);
+		out += 2;
+	}
+
+	ANSI_send(gb, out);
+}
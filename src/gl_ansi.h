@@ -0,0 +1,75 @@
+/*
+	Copyright 2012, 2013 Charles O.
+	Email: charles.0x4f@gmail.com
+	Github: https://github.com/charles-0x4f/
+
+	This file is part of TermGB.
+
+	TermGB is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	TermGB is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with TermGB.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/* gl_ansi.h */
+
+#ifndef GL_ANSI_H
+#define GL_ANSI_H
+
+#include "memory.h"
+
+/*
+	The raw ANSI terminal frontend
+
+	The same two pixels per cell as the curses frontend, but the
+	escape sequences are put together by hand: each frame goes into
+	one buffer that's kept between frames and is sent with a single
+	write(). Only cells that changed are drawn, and the cursor moves
+	and color changes between them are the shortest ones that will
+	do. The bytes and write() calls per frame are reported on exit.
+*/
+
+/* Character rows the screen takes up */
+#define ANSI_ROWS 72
+
+/*
+	Braille mode puts 2*4 pixels in each cell instead, as the dots
+	of a braille character, so the whole screen fits in 80*36. The
+	four shades become dots through an ordered dither.
+*/
+#define BRAILLE_COLUMNS 80
+#define BRAILLE_ROWS 36
+
+/*
+	On terminals that can show pictures the frame can be sent as
+	one instead, pixel for pixel: as a sixel image, or through the
+	kitty graphics protocol as a PNG. Both are made straight from
+	the 2 bit shades, and a frame the same as the last isn't sent.
+*/
+
+/* What the ANSI frontend is drawing with */
+#define ANSI_HALF_BLOCKS 0
+#define ANSI_BRAILLE 1
+#define ANSI_SIXEL 2
+#define ANSI_KITTY 3
+
+void GL_ANSI_init(struct gb_context*);
+void GL_ANSI_braille_init(struct gb_context*);
+void GL_ANSI_sixel_init(struct gb_context*);
+void GL_ANSI_kitty_init(struct gb_context*);
+void GL_ANSI_exit(struct gb_context*);
+void GL_ANSI_draw_frame(struct gb_context*, byte (*)[160]);
+void GL_ANSI_draw_braille(struct gb_context*, byte (*)[160]);
+void GL_ANSI_draw_sixel(struct gb_context*, byte (*)[160]);
+void GL_ANSI_draw_kitty(struct gb_context*, byte (*)[160]);
+
+#endif
@@ -0,0 +1,173 @@
+/*
+	Copyright 2012, 2013 Charles O.
+	Email: charles.0x4f@gmail.com
+	Github: https://github.com/charles-0x4f/
+
+	This file is part of TermGB.
+
+	TermGB is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	TermGB is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with TermGB.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/* gl_curses.c */
+
+/* For the wide character curses calls */
+#define _XOPEN_SOURCE_EXTENDED
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <locale.h>
+#include <ncurses.h>
+#include "gb.h"
+#include "gl_curses.h"
+
+/*
+	The four shades as curses colors. With a palette that can be
+	changed they're set to the same greys the SDL frontend uses,
+	after saving what they were for GL_CURSES_exit, otherwise they
+	come from the 256 color grey ramp, and as a last resort from the
+	8 basic colors.
+*/
+static void GL_CURSES_colors(struct gb_context *gb, short *shades)
+{
+	static const short rgb[4] = { 890, 639, 412, 220 };
+	static const short ramp[4] = { 254, 248, 242, 237 };
+	static const short basic[4] = {
+		COLOR_WHITE, COLOR_CYAN, COLOR_BLUE, COLOR_BLACK
+	};
+	short *saved;
+	int i;
+
+	gb->term_colors_changed = can_change_color() && COLORS >= 20;
+
+	for(i = 0; i < 4; i++)
+	{
+		if(gb->term_colors_changed)
+		{
+			shades[i] = 16 + i;
+			saved = gb->term_colors[i];
+			color_content(shades[i], &saved[0], &saved[1],
+				&saved[2]);
+			init_color(shades[i], rgb[i], rgb[i], rgb[i]);
+		}
+		else if(COLORS >= 256)
+		{
+			shades[i] = ramp[i];
+		}
+		else
+		{
+			shades[i] = basic[i];
+		}
+	}
+}
+
+void GL_CURSES_init(struct gb_context *gb)
+{
+	short shades[4];
+	int top, bottom;
+
+	setlocale(LC_ALL, "");
+	initscr();
+
+	/* Anything smaller would clip or wrap the picture */
+	if(LINES < CURSES_ROWS || COLS < 160)
+	{
+		endwin();
+		fprintf(stderr, "The curses frontend needs a terminal of at "
+			"least 160x%i, this one is %ix%i\n", CURSES_ROWS,
+			COLS, LINES);
+		exit(1);
+	}
+
+	noecho();
+	curs_set(0);
+
+	start_color();
+	GL_CURSES_colors(gb, shades);
+
+	/*
+		A pair for each top and bottom shade, 1 + top * 4 + bottom,
+		as pair 0 can't be changed
+	*/
+	for(top = 0; top < 4; top++)
+	{
+		for(bottom = 0; bottom < 4; bottom++)
+			init_pair(1 + top * 4 + bottom, shades[top],
+				shades[bottom]);
+	}
+
+	/* Nothing's on screen yet, so every cell has changed */
+	memset(gb->term_cells, 0xFF, sizeof(gb->term_cells));
+
+	gb->draw_frame = GL_CURSES_draw_frame;
+}
+
+/* Put the terminal back the way it was, colors included */
+void GL_CURSES_exit(struct gb_context *gb)
+{
+	short *saved;
+	int i;
+
+	if(gb->term_colors_changed)
+	{
+		for(i = 0; i < 4; i++)
+		{
+			saved = gb->term_colors[i];
+			init_color(16 + i, saved[0], saved[1], saved[2]);
+		}
+
+		refresh();
+	}
+
+	endwin();
+}
+
+/*
+	A cell is the top pixel's shade * 4 + the bottom's, compared
+	against what the cell was showing last frame. A cell with the
+	same shade top and bottom is just a space in that color, which
+	is a third of the bytes of a half block.
+*/
+void GL_CURSES_draw_frame(struct gb_context *gb, byte (*frame)[160])
+{
+	int x, y;
+	byte cell;
+	byte *top, *bottom, *old;
+
+	for(y = 0; y < CURSES_ROWS; y++)
+	{
+		top = frame[y * 2];
+		bottom = frame[y * 2 + 1];
+		old = gb->term_cells[y];
+
+		for(x = 0; x < 160; x++)
+		{
+			cell = (top[x] & 3) << 2 | (bottom[x] & 3);
+
+			if(cell == old[x])
+				continue;
+
+			old[x] = cell;
+
+			attrset(COLOR_PAIR(1 + cell));
+			if((cell >> 2) == (cell & 3))
+				mvaddstr(y, x, " ");
+			else
+				mvaddwstr(y, x, L"\x2580");
+		}
+	}
+
+	refresh();
+}
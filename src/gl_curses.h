@@ -0,0 +1,46 @@
+/*
+	Copyright 2012, 2013 Charles O.
+	Email: charles.0x4f@gmail.com
+	Github: https://github.com/charles-0x4f/
+
+	This file is part of TermGB.
+
+	TermGB is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	TermGB is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with TermGB.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/* gl_curses.h */
+
+#ifndef GL_CURSES_H
+#define GL_CURSES_H
+
+#include "memory.h"
+
+/*
+	The ncurses frontend
+
+	Each character cell shows two pixels, one above the other: the
+	upper half block is drawn in the top pixel's shade over the
+	bottom pixel's shade, so the 160*144 screen takes 160*72 cells.
+	Only cells that changed since the last frame are drawn again.
+*/
+
+/* Character rows the screen takes up */
+#define CURSES_ROWS 72
+
+void GL_CURSES_init(struct gb_context*);
+void GL_CURSES_exit(struct gb_context*);
+void GL_CURSES_draw_frame(struct gb_context*, byte (*)[160]);
+
+#endif
@@ -0,0 +1,185 @@
+/*
+	Copyright 2012, 2013 Charles O.
+	Email: charles.0x4f@gmail.com
+	Github: https://github.com/charles-0x4f/
+
+	This file is part of TermGB.
+
+	TermGB is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	TermGB is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with TermGB.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/* gl_present.c */
+
+/* For threads and semaphores */
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include "gb.h"
+#include "gl_present.h"
+
+/* Frames the ring holds */
+#define PRESENT_QUEUE 4
+
+/*
+	head counts the frames GL_present has put in and is only written
+	by the emulation thread, tail the ones the presenter thread has
+	finished with and is only written by it. Neither ever goes down,
+	so frame n is in frames[n % PRESENT_QUEUE] and the ring's full
+	when head - tail reaches PRESENT_QUEUE. The presenter is drawing
+	frames[tail] while it's at it, so that's never written over.
+*/
+struct presenter {
+	byte frames[PRESENT_QUEUE][144][160];
+	unsigned long head, tail;
+	/* Frames dropped with the ring full, and skipped for newer ones */
+	unsigned long dropped, skipped;
+	int quit;
+	/* Posted for every frame put in, so the presenter can sleep */
+	sem_t ready;
+	pthread_t thread;
+};
+
+static void *GL_presenter(void *data)
+{
+	struct gb_context *gb = data;
+	struct presenter *presenter = gb->presenter;
+	unsigned long head, tail;
+
+	for(;;)
+	{
+		head = __atomic_load_n(&presenter->head, __ATOMIC_ACQUIRE);
+		tail = presenter->tail;
+
+		if(head == tail)
+		{
+			if(__atomic_load_n(&presenter->quit, __ATOMIC_ACQUIRE))
+				break;
+
+			/* EINTR just means going around again */
+			sem_wait(&presenter->ready);
+			continue;
+		}
+
+		/* Only the newest frame's worth drawing */
+		presenter->skipped += head - 1 - tail;
+		tail = head - 1;
+		__atomic_store_n(&presenter->tail, tail, __ATOMIC_RELEASE);
+
+		gb->draw_frame(gb, presenter->frames[tail % PRESENT_QUEUE]);
+
+		__atomic_store_n(&presenter->tail, tail + 1, __ATOMIC_RELEASE);
+	}
+
+	return NULL;
+}
+
+/*
+	The LCD has reached V-blank, so the video buffer holds a whole
+	frame. Hand it to the presenter thread if there is one, or let
+	the frontend, if there is one, put it on the screen right away.
+*/
+void GL_present(struct gb_context *gb)
+{
+	struct presenter *presenter = gb->presenter;
+	unsigned long head;
+
+	if(gb->draw_frame == NULL)
+		return;
+
+	if(presenter == NULL)
+	{
+		gb->draw_frame(gb, gb->video_buffer);
+		return;
+	}
+
+	head = presenter->head;
+
+	if(head - __atomic_load_n(&presenter->tail, __ATOMIC_ACQUIRE) >=
+		PRESENT_QUEUE)
+	{
+		presenter->dropped++;
+		return;
+	}
+
+	memcpy(presenter->frames[head % PRESENT_QUEUE], gb->video_buffer,
+		sizeof(gb->video_buffer));
+	__atomic_store_n(&presenter->head, head + 1, __ATOMIC_RELEASE);
+
+	sem_post(&presenter->ready);
+}
+
+/*
+	Start drawing frames on a thread of their own, once the frontend
+	has set draw_frame. Returns -1 if the thread couldn't be started,
+	frames are then drawn by GL_present as before.
+*/
+int GL_start_presenter(struct gb_context *gb)
+{
+	struct presenter *presenter;
+
+	if(gb->draw_frame == NULL)
+		return 0;
+
+	presenter = calloc(1, sizeof(struct presenter));
+	if(presenter == NULL)
+		return -1;
+
+	if(sem_init(&presenter->ready, 0, 0) < 0)
+	{
+		free(presenter);
+		return -1;
+	}
+
+	gb->presenter = presenter;
+
+	if(pthread_create(&presenter->thread, NULL, GL_presenter, gb) != 0)
+	{
+		gb->presenter = NULL;
+		sem_destroy(&presenter->ready);
+		free(presenter);
+		return -1;
+	}
+
+	return 0;
+}
+
+/*
+	Draw whatever frame's still waiting and stop the presenter
+	thread, before the frontend's shut down. Returns how many frames
+	it dropped or skipped.
+*/
+unsigned long GL_stop_presenter(struct gb_context *gb)
+{
+	struct presenter *presenter = gb->presenter;
+	unsigned long dropped;
+
+	if(presenter == NULL)
+		return 0;
+
+	__atomic_store_n(&presenter->quit, 1, __ATOMIC_RELEASE);
+	sem_post(&presenter->ready);
+	pthread_join(presenter->thread, NULL);
+
+	dropped = presenter->dropped + presenter->skipped;
+
+	gb->presenter = NULL;
+	sem_destroy(&presenter->ready);
+	free(presenter);
+
+	return dropped;
+}
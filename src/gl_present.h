@@ -0,0 +1,50 @@
+/*
+	Copyright 2012, 2013 Charles O.
+	Email: charles.0x4f@gmail.com
+	Github: https://github.com/charles-0x4f/
+
+	This file is part of TermGB.
+
+	TermGB is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	TermGB is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with TermGB.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/* gl_present.h */
+
+#ifndef GL_PRESENT_H
+#define GL_PRESENT_H
+
+#include "memory.h"
+
+/*
+	Getting finished frames to the screen
+
+	Frontends can be slow to draw, a terminal especially, and the
+	CPU shouldn't have to wait on them. With a presenter thread
+	started, GL_present copies the frame into a small ring that the
+	presenter thread takes frames out of and draws, so one frame is
+	drawn while the next is emulated. The ring has one writer and
+	one reader and needs no lock.
+
+	When the presenter can't keep up, frames are dropped rather
+	than held up: it always draws the newest frame waiting and skips
+	any older ones, and while the ring's full new frames are
+	dropped.
+*/
+
+void GL_present(struct gb_context*);
+int GL_start_presenter(struct gb_context*);
+unsigned long GL_stop_presenter(struct gb_context*);
+
+#endif
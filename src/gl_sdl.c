@@ -21,49 +21,52 @@
 
 #include <stdio.h>
 #include <signal.h>
+#include "gb.h"
 #include "gl_sdl.h"
 #include "memory.h"
 #include "gl.h"
+#include "trace.h"
 
-void GL_SDL_init()
+void GL_SDL_init(struct gb_context *gb)
 {
 	SDL_Init(SDL_INIT_VIDEO | SDL_INIT_NOPARACHUTE);
 	signal(SIGINT, SIG_DFL);
 
-	LCD = SDL_SetVideoMode(160, 144, 32, SDL_SWSURFACE);
-	SDL_Flip(LCD);
+	gb->LCD = SDL_SetVideoMode(160, 144, 32, SDL_SWSURFACE);
+	SDL_Flip(gb->LCD);
 
-	color[0] = SDL_MapRGB(LCD->format, 227, 227, 227);
-	color[1] = SDL_MapRGB(LCD->format, 163, 163, 163);
-	color[2] = SDL_MapRGB(LCD->format, 105, 105, 105);
-	color[3] = SDL_MapRGB(LCD->format, 56, 56, 56);
+	gb->color[0] = SDL_MapRGB(gb->LCD->format, 227, 227, 227);
+	gb->color[1] = SDL_MapRGB(gb->LCD->format, 163, 163, 163);
+	gb->color[2] = SDL_MapRGB(gb->LCD->format, 105, 105, 105);
+	gb->color[3] = SDL_MapRGB(gb->LCD->format, 56, 56, 56);
+
+	gb->draw_frame = GL_SDL_draw_frame;
 }
 
-void GL_SDL_exit()
+void GL_SDL_exit(struct gb_context *gb)
 {
 	SDL_Quit();
 }
 
-void GL_SDL_draw_scanline()
+/*
+	Copy the whole frame to the window and update it once,
+	rather than a blit for every scanline
+*/
+void GL_SDL_draw_frame(struct gb_context *gb, byte (*frame)[160])
 {
-	byte x, scanline;
+	int x, y;
 	Uint32 *pixels;
-	
-	/*
-		Read the scanline in, i.e. the y location
-	*/
-	scanline = memory_readb(0xFF44);
+	byte *line;
 
-	printf("DBG VIDEO SCANLINE: %i\n", scanline);
-
-	for(x = 0; x < 160; x++)
+	for(y = 0; y < 144; y++)
 	{
-		printf("DBG VIDEOB %i: %i\n", x, video_buffer[scanline][x]);
+		line = frame[y];
+		pixels = (Uint32*)((Uint8*)gb->LCD->pixels +
+			y * gb->LCD->pitch);
 
-		pixels = (Uint32*)LCD->pixels + (scanline * LCD->w) + x;
-		*pixels = color[video_buffer[scanline][x]];
+		for(x = 0; x < 160; x++)
+			pixels[x] = gb->color[line[x]];
 	}
 
-	SDL_UpdateRect(LCD, 0, scanline, 160, 1);
+	SDL_UpdateRect(gb->LCD, 0, 0, 160, 144);
 }
-
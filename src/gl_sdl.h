@@ -24,11 +24,10 @@
 
 #include <SDL/SDL.h>
 
-Uint32 color[4];
-SDL_Surface *LCD;
+#include "memory.h"
 
-void GL_SDL_init();
-void GL_SDL_exit();
-void GL_SDL_draw_scanline();
+void GL_SDL_init(struct gb_context*);
+void GL_SDL_exit(struct gb_context*);
+void GL_SDL_draw_frame(struct gb_context*, byte (*)[160]);
 
 #endif
@@ -0,0 +1,262 @@
+/*
+	Copyright 2012, 2013 Charles O.
+	Email: charles.0x4f@gmail.com
+	Github: https://github.com/charles-0x4f/
+
+	This file is part of TermGB.
+
+	TermGB is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	TermGB is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with TermGB.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/*
+	gl_simd.c
+
+	Plain C, SSE2 and AVX2 versions of the tile decoder and palette
+	mapper, see gl_simd.h. x86 builds always have SSE2 to fall back
+	on, AVX2 is only used when the CPU says it has it.
+
+	Decoding puts each of a tile row's two bytes in all 8 bytes of
+	its row in the output, masks each byte with the bit for its
+	pixel and compares so set bits become 0xFF. The palette is a
+	lookup of 4 entries, a byte shuffle with AVX2 and four compares
+	with SSE2, which has no byte shuffle.
+*/
+
+#include <stdio.h>
+#include "gb.h"
+#include "gl_simd.h"
+
+#if defined(__GNUC__) && defined(__SSE2__) && \
+	(defined(__x86_64__) || defined(__i386__))
+#define GL_SIMD_X86
+#include <immintrin.h>
+#endif
+
+void GL_decode_tile_c(const byte *data, byte *pixels)
+{
+	int row, bit;
+
+	for(row = 0; row < 8; row++, data += 2)
+	{
+		for(bit = 7; bit >= 0; bit--)
+		{
+			*pixels++ = ((data[0] >> bit) & 1) |
+				(((data[1] >> bit) & 1) << 1);
+		}
+	}
+}
+
+void GL_palette_c(byte *out, const byte *in, int count, byte palette)
+{
+	byte colors[4];
+	int i;
+
+	for(i = 0; i < 4; i++)
+		colors[i] = (palette >> (i * 2)) & 3;
+
+	for(i = 0; i < count; i++)
+		out[i] = colors[in[i] & 3];
+}
+
+#ifdef GL_SIMD_X86
+
+/*
+	lo and hi hold a row's low and high byte in each of its pixels,
+	pixel 0 wants bit 7
+*/
+static __m128i sse2_pixels(__m128i lo, __m128i hi)
+{
+	const __m128i bits = _mm_setr_epi8((char)0x80, 0x40, 0x20, 0x10,
+		0x08, 0x04, 0x02, 0x01, (char)0x80, 0x40, 0x20, 0x10,
+		0x08, 0x04, 0x02, 0x01);
+
+	lo = _mm_cmpeq_epi8(_mm_and_si128(lo, bits), bits);
+	hi = _mm_cmpeq_epi8(_mm_and_si128(hi, bits), bits);
+
+	return _mm_or_si128(_mm_and_si128(lo, _mm_set1_epi8(1)),
+		_mm_and_si128(hi, _mm_set1_epi8(2)));
+}
+
+/* Two rows per 16 bytes written */
+static void decode_tile_sse2(const byte *data, byte *pixels)
+{
+	__m128i rows, lo, hi, lo4, hi4;
+	int half;
+
+	rows = _mm_loadu_si128((const __m128i*)data);
+
+	/* Split into the 8 low bytes and the 8 high bytes */
+	lo = _mm_and_si128(rows, _mm_set1_epi16(0xFF));
+	hi = _mm_srli_epi16(rows, 8);
+	lo = _mm_packus_epi16(lo, lo);
+	hi = _mm_packus_epi16(hi, hi);
+
+	/* Then spread them out, 2 then 4 then 8 copies of each */
+	lo = _mm_unpacklo_epi8(lo, lo);
+	hi = _mm_unpacklo_epi8(hi, hi);
+
+	for(half = 0; half < 2; half++)
+	{
+		if(half == 0)
+		{
+			lo4 = _mm_unpacklo_epi16(lo, lo);
+			hi4 = _mm_unpacklo_epi16(hi, hi);
+		}
+		else
+		{
+			lo4 = _mm_unpackhi_epi16(lo, lo);
+			hi4 = _mm_unpackhi_epi16(hi, hi);
+		}
+
+		_mm_storeu_si128((__m128i*)pixels, sse2_pixels(
+			_mm_unpacklo_epi32(lo4, lo4),
+			_mm_unpacklo_epi32(hi4, hi4)));
+		_mm_storeu_si128((__m128i*)(pixels + 16), sse2_pixels(
+			_mm_unpackhi_epi32(lo4, lo4),
+			_mm_unpackhi_epi32(hi4, hi4)));
+
+		pixels += 32;
+	}
+}
+
+static void palette_sse2(byte *out, const byte *in, int count,
+	byte palette)
+{
+	__m128i colors[4], pixels, result;
+	int i, color;
+
+	for(color = 0; color < 4; color++)
+		colors[color] = _mm_set1_epi8((palette >> (color * 2)) & 3);
+
+	for(i = 0; i + 16 <= count; i += 16)
+	{
+		pixels = _mm_loadu_si128((const __m128i*)(in + i));
+		result = _mm_setzero_si128();
+
+		for(color = 1; color < 4; color++)
+		{
+			result = _mm_or_si128(result, _mm_and_si128(colors[color],
+				_mm_cmpeq_epi8(pixels, _mm_set1_epi8(color))));
+		}
+
+		result = _mm_or_si128(result, _mm_and_si128(colors[0],
+			_mm_cmpeq_epi8(pixels, _mm_setzero_si128())));
+
+		_mm_storeu_si128((__m128i*)(out + i), result);
+	}
+
+	if(i < count)
+		GL_palette_c(out + i, in + i, count - i, palette);
+}
+
+/*
+	Which byte of the tile each output byte takes its low bit from,
+	four rows per 32 bytes. The shuffle works within each 16 byte
+	half so the tile is copied into both.
+*/
+static const byte avx2_rows[2][32] = {
+	{ 0, 0, 0, 0, 0, 0, 0, 0, 2, 2, 2, 2, 2, 2, 2, 2,
+	  4, 4, 4, 4, 4, 4, 4, 4, 6, 6, 6, 6, 6, 6, 6, 6 },
+	{ 8, 8, 8, 8, 8, 8, 8, 8, 10, 10, 10, 10, 10, 10, 10, 10,
+	  12, 12, 12, 12, 12, 12, 12, 12, 14, 14, 14, 14, 14, 14, 14, 14 }
+};
+
+__attribute__((target("avx2")))
+static void decode_tile_avx2(const byte *data, byte *pixels)
+{
+	__m256i bits, rows, select, lo, hi;
+	int half;
+
+	bits = _mm256_broadcastsi128_si256(_mm_setr_epi8((char)0x80, 0x40,
+		0x20, 0x10, 0x08, 0x04, 0x02, 0x01, (char)0x80, 0x40, 0x20,
+		0x10, 0x08, 0x04, 0x02, 0x01));
+	rows = _mm256_broadcastsi128_si256(
+		_mm_loadu_si128((const __m128i*)data));
+
+	for(half = 0; half < 2; half++)
+	{
+		select = _mm256_loadu_si256((const __m256i*)avx2_rows[half]);
+
+		lo = _mm256_shuffle_epi8(rows, select);
+		hi = _mm256_shuffle_epi8(rows,
+			_mm256_add_epi8(select, _mm256_set1_epi8(1)));
+
+		lo = _mm256_cmpeq_epi8(_mm256_and_si256(lo, bits), bits);
+		hi = _mm256_cmpeq_epi8(_mm256_and_si256(hi, bits), bits);
+
+		_mm256_storeu_si256((__m256i*)(pixels + half * 32),
+			_mm256_or_si256(
+				_mm256_and_si256(lo, _mm256_set1_epi8(1)),
+				_mm256_and_si256(hi, _mm256_set1_epi8(2))));
+	}
+}
+
+__attribute__((target("avx2")))
+static void palette_avx2(byte *out, const byte *in, int count,
+	byte palette)
+{
+	__m256i colors;
+	int i;
+
+	/*
+		The 4 colors a byte each, repeated across the table. Color
+		numbers are 0-3 so only the first 4 entries get used.
+	*/
+	colors = _mm256_set1_epi32((palette & 3) |
+		((palette >> 2) & 3) << 8 |
+		((palette >> 4) & 3) << 16 |
+		((palette >> 6) & 3) << 24);
+
+	for(i = 0; i + 32 <= count; i += 32)
+	{
+		_mm256_storeu_si256((__m256i*)(out + i),
+			_mm256_shuffle_epi8(colors,
+			_mm256_loadu_si256((const __m256i*)(in + i))));
+	}
+
+	if(i < count)
+		palette_sse2(out + i, in + i, count - i, palette);
+}
+
+#endif
+
+void GL_SIMD_init(struct gb_context *gb)
+{
+	gb->decode_tile = GL_decode_tile_c;
+	gb->palette = GL_palette_c;
+
+#ifdef GL_SIMD_X86
+	gb->decode_tile = decode_tile_sse2;
+	gb->palette = palette_sse2;
+
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx2"))
+	{
+		gb->decode_tile = decode_tile_avx2;
+		gb->palette = palette_avx2;
+	}
+#endif
+}
+
+const char *GL_SIMD_name(struct gb_context *gb)
+{
+#ifdef GL_SIMD_X86
+	if(gb->palette == palette_avx2)
+		return "avx2";
+	if(gb->palette == palette_sse2)
+		return "sse2";
+#endif
+	return "c";
+}
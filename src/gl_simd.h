@@ -0,0 +1,54 @@
+/*
+	Copyright 2012, 2013 Charles O.
+	Email: charles.0x4f@gmail.com
+	Github: https://github.com/charles-0x4f/
+
+	This file is part of TermGB.
+
+	TermGB is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	TermGB is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with TermGB.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/* gl_simd.h */
+
+#ifndef GL_SIMD_H
+#define GL_SIMD_H
+
+#include "memory.h"
+
+/*
+	Pixel kernels
+
+	The two jobs the renderer does most, turning 2bpp tile data into
+	color numbers and running color numbers through a palette, have
+	an SSE2 and an AVX2 version as well as plain C. GL_SIMD_init
+	picks the best one the host CPU can run and leaves it in the
+	context, other hosts and compilers only get the plain C ones.
+*/
+
+/* Decode a tile's 16 bytes into its 8*8 color numbers */
+typedef void (*tile_kernel)(const byte *data, byte *pixels);
+/* Map count color numbers through a BGP/OBP style palette */
+typedef void (*palette_kernel)(byte *out, const byte *in, int count,
+	byte palette);
+
+/* Pick the kernels for this host */
+void GL_SIMD_init(struct gb_context*);
+/* Name of the kernels GL_SIMD_init picked */
+const char *GL_SIMD_name(struct gb_context*);
+
+void GL_decode_tile_c(const byte*, byte*);
+void GL_palette_c(byte*, const byte*, int, byte);
+
+#endif
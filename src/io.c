@@ -0,0 +1,141 @@
+/*
+	Copyright 2012, 2013 Charles O.
+	Email: charles.0x4f@gmail.com
+	Github: https://github.com/charles-0x4f/
+
+	This file is part of TermGB.
+
+	TermGB is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	TermGB is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with TermGB.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+/* io.c */
+
+#include "gb.h"
+#include "io.h"
+#include "cpu_cache.h"
+#include "scheduler.h"
+#include "joypad.h"
+#include "timer.h"
+#include "lcd.h"
+#include "gl.h"
+
+/* For LY, unused registers and anything else that can't be written */
+static void IO_write_ignore(struct gb_context *gb, word address, byte data)
+{
+}
+
+/* IF, only the five interrupt bits are there, the rest read as 1 */
+static void IO_write_interrupt(struct gb_context *gb, word address,
+	byte data)
+{
+	gb->memory[0xFF0F] = 0xE0 | data;
+
+	/* A new interrupt request might need servicing */
+	SCHEDULER_add(gb, EVENT_INTERRUPT, 0);
+}
+
+/* Registers from start to end that don't exist read as 0xFF */
+static void IO_unused(struct gb_context *gb, word start, word end)
+{
+	word address;
+
+	for(address = start; address <= end; address++)
+	{
+		gb->memory[address] = 0xFF;
+		gb->io_write[address & 0x7F] = IO_write_ignore;
+	}
+}
+
+/* Fill in the register table, called by memory_init */
+void IO_init(struct gb_context *gb)
+{
+	int i;
+
+	for(i = 0; i < 0x80; i++)
+	{
+		gb->io_read[i] = NULL;
+		gb->io_write[i] = NULL;
+	}
+
+	IO_unused(gb, 0xFF03, 0xFF03);
+	IO_unused(gb, 0xFF08, 0xFF0E);
+	IO_unused(gb, 0xFF15, 0xFF15);
+	IO_unused(gb, 0xFF1F, 0xFF1F);
+	IO_unused(gb, 0xFF27, 0xFF2F);
+	IO_unused(gb, 0xFF4C, 0xFF7F);
+
+	/* Joypad */
+	gb->io_write[0x00] = JOYPAD_write;
+
+	/* Divider and timer */
+	gb->io_read[0x04] = TIMER_read_div;
+	gb->io_write[0x04] = TIMER_write;
+	gb->io_write[0x07] = TIMER_write;
+
+	/* Interrupt flags */
+	gb->memory[0xFF0F] = 0xE0;
+	gb->io_write[0x0F] = IO_write_interrupt;
+
+	/* LCD control, status, LY, LYC and OAM DMA */
+	gb->memory[0xFF41] = 0x80;
+	gb->io_write[0x40] = LCD_write_control;
+	gb->io_write[0x41] = LCD_write_status;
+	gb->io_write[0x44] = IO_write_ignore;
+	gb->io_write[0x45] = LCD_write_compare;
+	gb->io_write[0x46] = GL_dma;
+}
+
+/* Read handler for the 0xFF00 page */
+byte IO_read(struct gb_context *gb, word address)
+{
+	memory_read_handler read;
+
+	if(address < 0xFF80)
+	{
+		read = gb->io_read[address & 0x7F];
+		if(read != NULL)
+			return read(gb, address);
+	}
+
+	return gb->memory[address];
+}
+
+/* Write handler for the 0xFF00 page */
+void IO_write(struct gb_context *gb, word address, byte data)
+{
+	memory_write_handler write;
+
+	if(address >= 0xFF80)
+	{
+		gb->memory[address] = data;
+
+		/* HRAM is a popular place to run code from */
+		if(gb->cache_marks[address])
+			CACHE_invalidate(gb, address);
+
+		/* A new enable bit might need servicing */
+		if(address == 0xFFFF)
+			SCHEDULER_add(gb, EVENT_INTERRUPT, 0);
+
+		return;
+	}
+
+	write = gb->io_write[address & 0x7F];
+	if(write != NULL)
+		write(gb, address, data);
+	else
+		gb->memory[address] = data;
+}
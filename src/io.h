@@ -0,0 +1,49 @@
+/*
+	Copyright 2012, 2013 Charles O.
+	Email: charles.0x4f@gmail.com
+	Github: https://github.com/charles-0x4f/
+
+	This file is part of TermGB.
+
+	TermGB is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	TermGB is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with TermGB.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+/* io.h */
+
+#ifndef IO_H
+#define IO_H
+
+#include "memory.h"
+
+/*
+	I/O registers (0xFF00-0xFF7F)
+
+	Every register can have a read and a write hook in a 128 entry
+	table indexed by the low 7 bits of its address. Without a read
+	hook a register reads back whatever is in memory[]; without a
+	write hook the byte is just stored there. Write hooks store the
+	value themselves, after masking off read only bits, so most
+	registers never need a read hook.
+
+	HRAM and the interrupt enable register share the page but skip
+	the table.
+*/
+
+void IO_init(struct gb_context*);
+byte IO_read(struct gb_context*, word);
+void IO_write(struct gb_context*, word, byte);
+
+#endif
@@ -0,0 +1,64 @@
+/*
+	Copyright 2012, 2013 Charles O.
+	Email: charles.0x4f@gmail.com
+	Github: https://github.com/charles-0x4f/
+
+	This file is part of TermGB.
+
+	TermGB is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	TermGB is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with TermGB.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/* joypad.c */
+
+#include "gb.h"
+#include "joypad.h"
+
+/* Work out the register from the selected group of buttons */
+static void JOYPAD_update(struct gb_context *gb)
+{
+	byte select = gb->memory[0xFF00] & 0x30;
+	byte pressed = 0;
+
+	/* Bit 4 low: direction keys */
+	if(!(select & 0x10))
+		pressed |= gb->buttons & 0x0F;
+	/* Bit 5 low: A, B, Select, Start */
+	if(!(select & 0x20))
+		pressed |= gb->buttons >> 4;
+
+	gb->memory[0xFF00] = 0xC0 | select | (~pressed & 0x0F);
+}
+
+/*
+	Change which buttons are held down, a button going down
+	requests the joypad interrupt
+*/
+void JOYPAD_set(struct gb_context *gb, byte buttons)
+{
+	byte pressed = buttons & ~gb->buttons;
+
+	gb->buttons = buttons;
+	JOYPAD_update(gb);
+
+	if(pressed)
+		CPU_request_interrupt(gb, 4);
+}
+
+/* Write hook for 0xFF00, only the select bits can be written */
+void JOYPAD_write(struct gb_context *gb, word address, byte data)
+{
+	gb->memory[0xFF00] = data & 0x30;
+	JOYPAD_update(gb);
+}
@@ -0,0 +1,51 @@
+/*
+	Copyright 2012, 2013 Charles O.
+	Email: charles.0x4f@gmail.com
+	Github: https://github.com/charles-0x4f/
+
+	This file is part of TermGB.
+
+	TermGB is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	TermGB is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with TermGB.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/* joypad.h */
+
+#ifndef JOYPAD_H
+#define JOYPAD_H
+
+#include "memory.h"
+
+/*
+	The joypad register (0xFF00) shows four buttons at a time in
+	its low nibble, 0 meaning pressed. Writing 0 to bit 4 selects
+	the direction keys, writing 0 to bit 5 selects A/B/Select/Start.
+
+	Button states are kept in gb->buttons using the bits below,
+	1 meaning pressed, and the register is worked out from them
+	whenever either side changes.
+*/
+#define JOYPAD_RIGHT	0x01
+#define JOYPAD_LEFT	0x02
+#define JOYPAD_UP	0x04
+#define JOYPAD_DOWN	0x08
+#define JOYPAD_A	0x10
+#define JOYPAD_B	0x20
+#define JOYPAD_SELECT	0x40
+#define JOYPAD_START	0x80
+
+void JOYPAD_set(struct gb_context*, byte);
+void JOYPAD_write(struct gb_context*, word, byte);
+
+#endif
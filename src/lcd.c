@@ -22,200 +22,215 @@
 /* LCD.c */
 
 /* TODO make this file suck less */
+#include "gb.h"
 #include "lcd.h"
+#include "cpu.h"
+#include "gl.h"
+#include "gl_present.h"
+#include "scheduler.h"
 
 
+/*
+	Mode timings in cycles, each line takes 456:
+	OAM search (2) 80, transfer (3) 172, H-blank (0) 204.
+	Lines 144-153 are V-blank (1).
+*/
+#define LCD_OAM_CYCLES		80
+#define LCD_TRANSFER_CYCLES	172
+#define LCD_HBLANK_CYCLES	204
+#define LCD_LINE_CYCLES		456
+
 /* Initialize the LCD, obviously */
-void LCD_init()
+void LCD_init(struct gb_context *gb)
 {
-	scanline_cycles = 456;
+	gb->lcd_off = 0;
+	gb->memory[0xFF44] = 0;
+	LCD_set_mode(gb, 2);
+	LCD_compare_line(gb);
+
+	SCHEDULER_add(gb, EVENT_LCD, LCD_OAM_CYCLES);
 }
 
 /* Main graphical function
 
-	TODO refactor this.
+	Runs whenever the LCD is due to change mode and queues its next
+	change. A line goes OAM search -> transfer -> H-blank, the line
+	is drawn as the transfer finishes, then LY moves on. Line 144
+	starts V-blank, which runs until LY wraps back to 0 after 153.
 
-	Big thanks to Codeslinger for the current iteration of this
+	Big thanks to Codeslinger for the original iteration of this
 	function.
 	http://www.codeslinger.co.uk
 */
-void LCD_update(int cycles)
+void LCD_event(struct gb_context *gb, long due)
 {
-	byte currentline;
-
-	LCD_update_status();
+	byte line;
 
-	if(LCD_enabled())
-		scanline_cycles -= cycles;
-	else
-		return;
-
-	if(scanline_cycles <= 0)
+	switch(gb->lcd_mode)
 	{
-		memory[0xFF44]++;
-
-		currentline = memory[0xFF44];
-
-		scanline_cycles = 456;
-
-		if(currentline == 144)
+		case 2:
 		{
-			/* Request V-blank interrupt */
-			CPU_request_interrupt(0);
+			LCD_set_mode(gb, 3);
+			SCHEDULER_add_at(gb, EVENT_LCD,
+				due + LCD_TRANSFER_CYCLES);
+			break;
 		}
-		else if(currentline > 153)
+		case 3:
 		{
-			memory[0xFF44] = 0;
+			LCD_set_mode(gb, 0);
+			GL_draw_scanline(gb);
+			SCHEDULER_add_at(gb, EVENT_LCD,
+				due + LCD_HBLANK_CYCLES);
+			break;
 		}
-		else if(currentline <= 144)
+		case 0:
 		{
-			GL_draw_scanline();
+			line = ++gb->memory[0xFF44];
+			LCD_compare_line(gb);
+
+			if(line == 144)
+			{
+				LCD_set_mode(gb, 1);
+
+				/* The frame's finished, show it */
+				GL_present(gb);
+
+				/* Request V-blank interrupt */
+				CPU_request_interrupt(gb, 0);
+
+				SCHEDULER_add_at(gb, EVENT_LCD,
+					due + LCD_LINE_CYCLES);
+			}
+			else
+			{
+				LCD_set_mode(gb, 2);
+				SCHEDULER_add_at(gb, EVENT_LCD,
+					due + LCD_OAM_CYCLES);
+			}
+			break;
+		}
+		case 1:
+		{
+			line = gb->memory[0xFF44] + 1;
+
+			if(line > 153)
+			{
+				gb->memory[0xFF44] = 0;
+				/*
+					A new frame starts at the top of the
+					window, whether or not the last one drew
+					any background
+				*/
+				gb->window_line = 0;
+				LCD_set_mode(gb, 2);
+				SCHEDULER_add_at(gb, EVENT_LCD,
+					due + LCD_OAM_CYCLES);
+			}
+			else
+			{
+				gb->memory[0xFF44] = line;
+				SCHEDULER_add_at(gb, EVENT_LCD,
+					due + LCD_LINE_CYCLES);
+			}
+
+			LCD_compare_line(gb);
+			break;
 		}
 	}
 }
 
 /*
-	Update the LCD status register(0xFF41)
+	Switch the LCD to a new mode and show it in the low two bits
+	of the status register (0xFF41)
 
-	(Put more info here)
-	TODO write the 90 page comment for this function
+	Entering modes 0, 1 and 2 requests the LCD interrupt if the
+	matching enable bit (3, 4 and 5) of the status register is set.
 */
-void LCD_update_status()
+void LCD_set_mode(struct gb_context *gb, byte mode)
 {
-	byte mode, currentmode, requestint = 0;
-	byte current_status = memory_readb(0xFF41);
-	byte currentline = memory_readb(0xFF44);
-	byte mode_offset = 456 - scanline_cycles;
+	byte status = gb->memory[0xFF41];
 
-	/*
-		Get the current mode
+	gb->lcd_mode = mode;
 
-		current_status = ????-??XX
-		& 0x3 = get             ^^
-	*/
-	currentmode = LCD_get_mode();
+	gb->memory[0xFF41] = (status & ~0x3) | mode;
 
-	/*
-		If we're at scanline >= 144, we're in V-blank
-		and need to set the mode to 01, check interrupt
-		bit, if it's set, then request the LCD interrupt
-	*/
-	if(currentline >= 144)
+	if(mode < 3 && (status & (0x08 << mode)))
 	{
-		mode = 1;
-		requestint = bitset(&current_status, 4);
+		/* Request LCD interrupt (bit 1, duh) */
+		CPU_request_interrupt(gb, 1);
 	}
+}
 
-	/*
-		If mode_offset <= 204, we're in H-blank and need
-		to set mode to 00, check interrupt bit, if set,
-		request LCD interrupt
-	*/ 
-	if(mode_offset <= 204)
-	{
-		mode = 0;
-		requestint = bitset(&current_status, 3);
-	}
-	/*
-		If the offset is >= 376, we're in mode 2, which
-		is when the Gameboy is searching sprite attribute
-		data(OAM) and the CPU can't access the data there
-	*/
-	else if(mode_offset >= 376)
+/*
+	If the current line is the same as LYC(0xFF45), set the
+	coincidence flag. If bit 6 of the status register is set,
+	request an LCD interrupt.
+
+	If they're not equal, reset the coincidence bit.
+*/
+void LCD_compare_line(struct gb_context *gb)
+{
+	if(gb->memory[0xFF44] == gb->memory[0xFF45])
 	{
-		mode = 2;
-		requestint = bitset(&current_status, 5);
+		gb->memory[0xFF41] |= 0x04;
+
+		if(gb->memory[0xFF41] & 0x40)
+			CPU_request_interrupt(gb, 1);
 	}
-	/*
-		If the offset is somewhere between, then we're in
-		mode 3, when data is being transferred to the LCD.
-	*/
 	else
 	{
-		mode = 3;
+		gb->memory[0xFF41] &= ~0x04;
 	}
+}
 
-	/*
-		See if mode is different than it was before, indicating
-		a mode change, if there was a change, and the corresponding
-		interrupt bit is set, request the appropriate interrupt.
-
-		We make sure that the mode has actually changed so that
-		we're not requesting an interrupt 79 million times a frame
-	*/
-	if((mode != currentmode) && requestint > 0)
-	{
-		/* Request LCD interrupt (bit 1, duh) */
-		CPU_request_interrupt(1);
-	}
+/*
+	Write hook for LCDC (0xFF40), switching the LCD off stops it
+	with LY at 0 in H-blank, switching it back on starts line 0
+	over again
+*/
+void LCD_write_control(struct gb_context *gb, word address, byte data)
+{
+	gb->memory[0xFF40] = data;
 
-	/*
-		Don't bother to change the mode bits if they're gonna
-		be the same.
-	*/
-	if(mode != currentmode)
+	if(!(data & 0x80) && !gb->lcd_off)
 	{
-		/* Switch to handle the bit-level mode setting */
-		switch(mode)
-		{
-			/*
-				H-blank, mode 0.
-				bit-level: ...00
-			*/
-			case 0:
-			{
-				CPU_res(0, &currentmode);
-				CPU_res(1, &currentmode);
-				break;
-			}
-			/*
-				V-blank, mode 1.
-				bit-level: ...01
-			*/
-			case 1:
-			{
-				CPU_set(0, &currentmode);
-				CPU_res(1, &currentmode);
-				break;
-			}
-			/*
-				OAM search, mode 2.
-				bit-level: ...10
-			*/
-			case 2:
-			{
-				CPU_res(0, &currentmode);
-				CPU_set(1, &currentmode);
-				break;
-			}
-		}
-	}
-
-	/*
-		If the current line is the same as LYC(0xFF45),
-		set the coincidence flag. If bit 6 of the status
-		register is set, request an LCD interrupt.
+		gb->lcd_off = 1;
+		gb->memory[0xFF44] = 0;
 
-		If they're not equal, reset the coincidence bit.
-	*/
-	if(currentline == memory_readb(0xFF45))
-	{
-		CPU_set(2, &currentmode);
+		/* Not through LCD_set_mode, this doesn't raise STAT */
+		gb->lcd_mode = 0;
+		gb->memory[0xFF41] &= ~0x03;
 
-		/* TODO change to CPU_bit when defined */
-		if(bitset(&currentmode, 6))
-			CPU_request_interrupt(1);
+		SCHEDULER_remove(gb, EVENT_LCD);
 	}
-	else
+	else if((data & 0x80) && gb->lcd_off)
 	{
-		CPU_res(2, &currentmode);
+		gb->lcd_off = 0;
+		gb->window_line = 0;
+		LCD_set_mode(gb, 2);
+		LCD_compare_line(gb);
+
+		SCHEDULER_add(gb, EVENT_LCD, LCD_OAM_CYCLES);
 	}
+}
 
-	/*
-		Finally, write the updated currentmode to the real
-		status register (0xFF41)
-	*/
-	memory_writeb(0xFF41, currentmode);
+/*
+	Write hook for STAT (0xFF41), the mode and coincidence bits
+	are read only and bit 7 always reads as 1
+*/
+void LCD_write_status(struct gb_context *gb, word address, byte data)
+{
+	gb->memory[0xFF41] = 0x80 | (data & 0x78) |
+		(gb->memory[0xFF41] & 0x07);
+}
+
+/* Write hook for LYC (0xFF45), the comparison is redone straight away */
+void LCD_write_compare(struct gb_context *gb, word address, byte data)
+{
+	gb->memory[0xFF45] = data;
+
+	if(!gb->lcd_off)
+		LCD_compare_line(gb);
 }
 
 /*
@@ -225,10 +240,10 @@ void LCD_update_status()
 	0 - LCD not enabled, probably Vblank
 	1 - LCD enabled
 */
-byte LCD_enabled()
+byte LCD_enabled(struct gb_context *gb)
 {
 	/* TODO change this function to use the CPU's bit functions when they're done */
-	byte LCDstatus = memory_readb(0xFF40);
+	byte LCDstatus = memory_readb(gb, 0xFF40);
 
 	/* get bit 7 from 0xFF40, if set, LCD is enabled */
 	if(LCDstatus & 0x80)
@@ -241,12 +256,12 @@ byte LCD_enabled()
 	Return the current LCD mode
 	(bit 0 and 1 of the LCD status register 0xFF41)
 */
-byte LCD_get_mode()
+byte LCD_get_mode(struct gb_context *gb)
 {
 	byte ret;
 
 	/* Read in the status register */
-	ret = memory_readb(0xFF41);
+	ret = memory_readb(gb, 0xFF41);
 
 	/*
 		Get just bit 0 and 1 of the status register
@@ -26,15 +26,15 @@
 
 #include "memory.h"
 
-/* This will hold the number of cycles until the next scanline */
-int scanline_cycles;
-
-
 /* +++++ FUNCTIONS +++++ */
-void LCD_init();
-void LCD_update(int);
-void LCD_update_status();
-byte LCD_enabled();
-byte LCD_get_mode();
+void LCD_init(struct gb_context*);
+void LCD_event(struct gb_context*, long);
+void LCD_set_mode(struct gb_context*, byte);
+void LCD_compare_line(struct gb_context*);
+void LCD_write_control(struct gb_context*, word, byte);
+void LCD_write_status(struct gb_context*, word, byte);
+void LCD_write_compare(struct gb_context*, word, byte);
+byte LCD_enabled(struct gb_context*);
+byte LCD_get_mode(struct gb_context*);
 
 #endif
@@ -21,18 +21,86 @@
 
 /* Main.c */
 
+/* For clock_gettime() */
+#define _POSIX_C_SOURCE 200112L
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+#include <signal.h>
+#include "gb.h"
 #include "memory.h"
 #include "cpu.h"
+#include "cpu_jit.h"
 #include "lcd.h"
 #include "gl_sdl.h"
+#include "gl_curses.h"
+#include "gl_ansi.h"
+#include "gl_present.h"
+#include "trace.h"
+
+/* A way of putting the screen somewhere */
+struct frontend {
+	const char *name;
+	void (*init)(struct gb_context*);
+	void (*exit)(struct gb_context*);
+};
+
+/* The first one is used unless another is named */
+static const struct frontend frontends[] = {
+	{ "sdl", GL_SDL_init, GL_SDL_exit },
+	{ "curses", GL_CURSES_init, GL_CURSES_exit },
+	{ "ansi", GL_ANSI_init, GL_ANSI_exit },
+	{ "braille", GL_ANSI_braille_init, GL_ANSI_exit },
+	{ "sixel", GL_ANSI_sixel_init, GL_ANSI_exit },
+	{ "kitty", GL_ANSI_kitty_init, GL_ANSI_exit }
+};
+
+#define FRONTENDS (sizeof(frontends) / sizeof(frontends[0]))
+
+/* The machine main() is running, for interrupt() */
+static struct gb_context *running;
+
+/* Look a frontend up by name, NULL if there's no such frontend */
+static const struct frontend *find_frontend(const char *name)
+{
+	unsigned int i;
+
+	for(i = 0; i < FRONTENDS; i++)
+	{
+		if(strcmp(name, frontends[i].name) == 0)
+			return &frontends[i];
+	}
+
+	return NULL;
+}
+
+/*
+	Ctrl-C is the usual way out, so rather than quit on the spot
+	just stop the CPU. main() then goes out the same way as always,
+	putting the terminal back and keeping what the trace buffer was
+	holding.
+*/
+static void interrupt(int sig)
+{
+	running->stop = 1;
+}
 
 int main(int argc, char *argv[])
 {
+	struct gb_context *gb;
 	char deleteme;
-	int debugmode = 0;
-	int instruction_count = 0;
+	int debugmode = -1;
+	int categories = TRACE_ALL;
+	long records;
+	long instruction_count = 0;
+	const struct frontend *frontend = &frontends[0];
+	int arg, level_arg = 0;
+	struct timespec start, end;
+	double seconds;
+	unsigned long dropped;
 
 	if(argc < 2)
 	{
@@ -40,59 +108,124 @@ int main(int argc, char *argv[])
 		return 0;
 	}
 
-	if(argc == 3)
+	/*
+		After the ROM, in any order:
+
+		"jitcompare" runs every native block through the
+		interpreter as well and reports any difference.
+
+		A frontend name picks what to draw with, see frontends.
+
+		A debug level records trace events up to that level,
+		optionally only from the comma separated categories given
+		straight after it, e.g. "3 cpu,stack".
+	*/
+	for(arg = 2; arg < argc; arg++)
+	{
+		if(strcmp(argv[arg], "jitcompare") == 0)
+		{
+			jit_compare = 1;
+		}
+		else if(find_frontend(argv[arg]) != NULL)
+		{
+			frontend = find_frontend(argv[arg]);
+		}
+		else if(isdigit((unsigned char)argv[arg][0]) ||
+			argv[arg][0] == '-')
+		{
+			debugmode = atoi(argv[arg]);
+			level_arg = arg;
+		}
+		else if(level_arg == arg - 1)
+		{
+			categories = trace_parse_categories(argv[arg]);
+			if(categories < 0)
+			{
+				printf("Unknown trace category in %s\n",
+					argv[arg]);
+				return 0;
+			}
+		}
+		else
+		{
+			printf("Unknown option %s\n", argv[arg]);
+			return 0;
+		}
+	}
+
+	if(debugmode >= 0)
 	{
-		debugmode = atoi(argv[2]);
 		printf("Debug set: %i\n", debugmode);
+		trace_setup(categories, debugmode);
+
+		/* Level 4 steps through by hand, so show each event */
+		if(debugmode >= 4)
+			trace_echo = 1;
 	}
 
-	if(load_rom(&argv[1]) < 0)
+	gb = GB_create();
+	if(gb == NULL)
+	{
+		printf("Not enough memory\n");
+		return 0;
+	}
+
+	if(load_rom(gb, &argv[1]) < 0)
 	{
 		printf("Failed to load the ROM\n");
+		GB_destroy(gb);
 		return 0;
 	}
 
-	memory_init();
-	LCD_init();
-	GL_SDL_init();
+	memory_init(gb);
+	frontend->init(gb);
+
+	/* Drawing frames shouldn't hold up the CPU */
+	if(GL_start_presenter(gb) < 0)
+		printf("Couldn't start the presenter thread, frames will be "
+			"drawn in between emulating them\n");
 
-	CPU_reset();
+	CPU_reset(gb);
+
+	running = gb;
+	signal(SIGINT, interrupt);
 
 	/*loadBIOS();*/
 	/*memory[0x9904] = 1;
 	memory[0x9905] = 2;
 	memory[0x9910] = 19;*/
 
-	while(!(CPU(memory_readb(PC)) < 0))
+	/*
+		Without a debug level, let the CPU run flat out and
+		report how fast the dispatch loop it was built with is
+	*/
+	if(debugmode < 0)
 	{
-		total_cycles += cycles;
-
-		printf("PC: %X ", PC);
-		printf("OP: %X ", memory_readb(PC));
-		printf("ICount: %i ", instruction_count);
-
-		/*	Debug printing	*/
-		if(debugmode == 0)
-			printf("\n");
-		if(debugmode >= 1)
-			printf("NextB: %X\n", memory_readb(PC+1));
-		if(debugmode >= 2)
-			printf("Z: %X; N: %X; H: %X; C: %X\n", F.Z, F.N, F.H, F.C);
-		if(debugmode >= 3)
-			printf("A: %X; BC: %X%X; DE: %X%X; HL: %X%X; SP: %X\n", A, B, C, D, E, H, L, SP);
-		if(debugmode >= 4)
-			scanf("%c", &deleteme);
-
-		LCD_update(cycles);
-
-		CPU_check_interrupts();
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		instruction_count = CPU_run(gb);
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		seconds = (end.tv_sec - start.tv_sec) +
+			(end.tv_nsec - start.tv_nsec) / 1e9;
+	}
 
-		if(total_cycles >= max_cycles)
+	while(debugmode >= 0 && !gb->stop &&
+		!(CPU(gb, memory_readb(gb, gb->PC)) < 0))
+	{
+		/* PC has already moved past the instruction */
+		TRACE3(TRACE_STEP, gb->PC, memory_readb(gb, gb->PC),
+			instruction_count);
+		TRACE1(TRACE_NEXT_BYTE, memory_readb(gb, gb->PC+1));
+		if(trace_enabled[TRACE_FLAGS])
 		{
-			total_cycles = 0;
-
-			/* Do graphics stuff here */
+			CPU_flags(gb);
+			TRACE4(TRACE_FLAGS, gb->F.Z, gb->F.N, gb->F.H, gb->F.C);
 		}
+		TRACE5(TRACE_REGISTERS, gb->AF.b.hi, gb->BC.w, gb->DE.w,
+			gb->HL.w, gb->SP);
+		if(debugmode >= 4)
+			scanf("%c", &deleteme);
+
+		CPU_tick(gb);
 
 		/* Increase total instruction count for debugging */
 		instruction_count++;
@@ -100,7 +233,33 @@ int main(int argc, char *argv[])
 
 	/*printMEMORY();*/
 
-	GL_SDL_exit();
+	dropped = GL_stop_presenter(gb);
+
+	/* The frontend may own the terminal, give it back first */
+	frontend->exit(gb);
+
+	if(debugmode < 0)
+	{
+		printf("%s dispatch: %li instructions in %.2fs",
+			CPU_dispatch_mode, instruction_count, seconds);
+		if(seconds > 0)
+			printf(" (%.2f MIPS)",
+				instruction_count / seconds / 1000000);
+		printf("\n%li frames, %lu dropped by the presenter\n",
+			gb->frames, dropped);
+	}
+
+	if(trace_active())
+	{
+		records = trace_save(TRACE_FILE);
+		if(records < 0)
+			printf("Couldn't write %s\n", TRACE_FILE);
+		else
+			printf("Saved %li trace records to %s\n",
+				records, TRACE_FILE);
+	}
+
+	GB_destroy(gb);
 
 	return 0;
 }
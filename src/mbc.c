@@ -0,0 +1,234 @@
+/*
+	Copyright 2012, 2013 Charles O.
+	Email: charles.0x4f@gmail.com
+	Github: https://github.com/charles-0x4f/
+
+	This file is part of TermGB.
+
+	TermGB is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	TermGB is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with TermGB.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+/* mbc.c */
+
+#include <string.h>
+#include "gb.h"
+#include "mbc.h"
+
+/* Cartridge RAM sizes from the header (0x149) as 8KB banks */
+static const byte ram_sizes[6] = { 0, 1, 1, 4, 16, 8 };
+
+/* The MBC a cartridge type (0x147) uses */
+static byte MBC_type(byte cartridge)
+{
+	if(cartridge >= 0x01 && cartridge <= 0x03)
+		return MBC_1;
+	if(cartridge >= 0x0F && cartridge <= 0x13)
+		return MBC_3;
+	if(cartridge >= 0x19 && cartridge <= 0x1E)
+		return MBC_5;
+
+	return MBC_NONE;
+}
+
+/* Cartridge RAM that's disabled or missing reads as 0xFF */
+static byte MBC_read_ram(struct gb_context *gb, word address)
+{
+	/* MBC3 maps its clock registers here instead of a RAM bank */
+	if(gb->mbc == MBC_3 && gb->ram_enabled && gb->ram_select >= 0x08 &&
+		gb->ram_select <= 0x0C)
+		return gb->rtc_latched[gb->ram_select - 0x08];
+
+	return 0xFF;
+}
+
+static void MBC_write_ram(struct gb_context *gb, word address, byte data)
+{
+	if(gb->mbc == MBC_3 && gb->ram_enabled && gb->ram_select >= 0x08 &&
+		gb->ram_select <= 0x0C)
+	{
+		gb->rtc[gb->ram_select - 0x08] = data;
+		gb->rtc_latched[gb->ram_select - 0x08] = data;
+	}
+}
+
+/*
+	Work out which banks the registers select and repoint the
+	pages that changed
+*/
+static void MBC_update(struct gb_context *gb)
+{
+	word bank0 = 0, bank = gb->rom_select;
+	byte ram_bank = gb->ram_select;
+	byte ram_mapped;
+
+	/*
+		MBC1's two bit register is bits 5-6 of the ROM bank, in
+		mode 1 it also picks the bank at 0x0000 and the RAM bank
+	*/
+	if(gb->mbc == MBC_1)
+	{
+		bank |= (gb->ram_select & 0x3) << 5;
+		ram_bank = 0;
+
+		if(gb->mbc1_mode)
+		{
+			bank0 = (gb->ram_select & 0x3) << 5;
+			ram_bank = gb->ram_select & 0x3;
+		}
+	}
+
+	bank0 %= gb->rom_banks;
+	bank %= gb->rom_banks;
+
+	if(bank0 != gb->rom_bank0)
+	{
+		gb->rom_bank0 = bank0;
+		memory_map(gb, 0x0000, 0x3FFF, gb->ROM + bank0 * 0x4000L, NULL);
+	}
+
+	if(bank != gb->rom_bank)
+	{
+		gb->rom_bank = bank;
+		memory_map(gb, 0x4000, 0x7FFF, gb->ROM + bank * 0x4000L, NULL);
+	}
+
+	/* MBC3's clock registers aren't RAM, they go to the handlers */
+	ram_mapped = gb->ram_enabled && gb->ram_banks > 0 &&
+		!(gb->mbc == MBC_3 && ram_bank >= 0x08);
+
+	if(ram_mapped)
+	{
+		ram_bank %= gb->ram_banks;
+
+		if(ram_bank != gb->ram_bank ||
+			gb->read_page[0xA0] == NULL)
+		{
+			gb->ram_bank = ram_bank;
+			memory_map(gb, 0xA000, 0xBFFF,
+				gb->cart_ram + ram_bank * 0x2000L,
+				gb->cart_ram + ram_bank * 0x2000L);
+		}
+	}
+	else if(gb->read_page[0xA0] != NULL)
+	{
+		memory_map(gb, 0xA000, 0xBFFF, NULL, NULL);
+	}
+}
+
+/*
+	Read the cartridge header and map bank 0, bank 1 and the
+	cartridge RAM, called by memory_init
+*/
+void MBC_init(struct gb_context *gb)
+{
+	byte ram_size = gb->ROM[0x149];
+
+	gb->mbc = MBC_type(gb->ROM[0x147]);
+	gb->rom_banks = gb->ROM_size / 0x4000;
+	gb->ram_banks = (ram_size < 6) ? ram_sizes[ram_size] : 0;
+
+	/* Carts without an MBC can still have a single bank of RAM */
+	if(gb->mbc == MBC_NONE)
+		gb->ram_enabled = (gb->ram_banks > 0);
+	else
+		gb->ram_enabled = 0;
+
+	gb->rom_select = 1;
+	gb->ram_select = 0;
+	gb->mbc1_mode = 0;
+	gb->rtc_latch = 0xFF;
+	memset(gb->rtc, 0, sizeof(gb->rtc));
+	memset(gb->rtc_latched, 0, sizeof(gb->rtc_latched));
+
+	memory_handle(gb, 0x0000, 0x7FFF, NULL, MBC_write);
+	memory_handle(gb, 0xA000, 0xBFFF, MBC_read_ram, MBC_write_ram);
+
+	memory_map(gb, 0x0000, 0x3FFF, gb->ROM, NULL);
+	memory_map(gb, 0x4000, 0x7FFF, gb->ROM + 0x4000, NULL);
+	memory_map(gb, 0xA000, 0xBFFF, NULL, NULL);
+	gb->rom_bank0 = 0;
+	gb->rom_bank = 1;
+	gb->ram_bank = 0;
+
+	MBC_update(gb);
+}
+
+/* A write to ROM, which sets one of the MBC's registers */
+void MBC_write(struct gb_context *gb, word address, byte data)
+{
+	switch(gb->mbc)
+	{
+		case MBC_NONE:
+			return;
+
+		case MBC_1:
+			if(address < 0x2000)
+				gb->ram_enabled = ((data & 0x0F) == 0x0A);
+			else if(address < 0x4000)
+				gb->rom_select = (data & 0x1F) ? data & 0x1F : 1;
+			else if(address < 0x6000)
+				gb->ram_select = data & 0x3;
+			else
+				gb->mbc1_mode = data & 0x1;
+
+			break;
+
+		case MBC_3:
+			if(address < 0x2000)
+			{
+				gb->ram_enabled = ((data & 0x0F) == 0x0A);
+			}
+			else if(address < 0x4000)
+			{
+				gb->rom_select = (data & 0x7F) ? data & 0x7F : 1;
+			}
+			else if(address < 0x6000)
+			{
+				gb->ram_select = data;
+			}
+			else
+			{
+				/*
+					Writing 0 then 1 latches the clock. The
+					clock itself doesn't run yet, so it only
+					holds what the game wrote to it.
+				*/
+				if(gb->rtc_latch == 0x00 && data == 0x01)
+					memcpy(gb->rtc_latched, gb->rtc,
+						sizeof(gb->rtc));
+
+				gb->rtc_latch = data;
+			}
+
+			break;
+
+		case MBC_5:
+			/* Bank 0 can be mapped at 0x4000 on MBC5 */
+			if(address < 0x2000)
+				gb->ram_enabled = ((data & 0x0F) == 0x0A);
+			else if(address < 0x3000)
+				gb->rom_select = (gb->rom_select & 0x100) | data;
+			else if(address < 0x4000)
+				gb->rom_select = (gb->rom_select & 0xFF) |
+					((data & 0x1) << 8);
+			else if(address < 0x6000)
+				gb->ram_select = data & 0x0F;
+
+			break;
+	}
+
+	MBC_update(gb);
+}
@@ -0,0 +1,53 @@
+/*
+	Copyright 2012, 2013 Charles O.
+	Email: charles.0x4f@gmail.com
+	Github: https://github.com/charles-0x4f/
+
+	This file is part of TermGB.
+
+	TermGB is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	TermGB is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with TermGB.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+/* mbc.h */
+
+#ifndef MBC_H
+#define MBC_H
+
+#include "memory.h"
+
+/*
+	Cartridge memory bank controllers
+
+	The cartridge type in the header (0x147) picks the MBC. Writes
+	to ROM go to its registers, and switching a bank just points
+	the 0x4000-0x7FFF (or 0xA000-0xBFFF for RAM) pages at another
+	part of the ROM image or cartridge RAM, nothing is copied.
+
+	Carts with an MBC this doesn't know (MBC2 and the rarer ones)
+	are run as if they had none.
+*/
+#define MBC_NONE	0
+#define MBC_1		1
+#define MBC_3		3
+#define MBC_5		5
+
+/* Largest cartridge RAM, 16 banks of 8KB (MBC5) */
+#define MBC_RAM_SIZE	0x20000
+
+void MBC_init(struct gb_context*);
+void MBC_write(struct gb_context*, word, byte);
+
+#endif
@@ -21,129 +21,322 @@
 
 /* Memory.c */
 
+/* For mmap() and friends, which aren't part of ANSI C */
+#define _POSIX_C_SOURCE 200112L
+
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "gb.h"
 #include "memory.h"
 #include "cpu.h"
+#include "cpu_cache.h"
+#include "mbc.h"
+#include "io.h"
 #include "gl.h"
 
-/* Load ROM file into allocated memory */
-int load_rom(char **filename)
+/*
+	Load a ROM file. A ROM that's a whole number of 16KB banks, as
+	real ones are, is mapped read only instead of read in, so only
+	the banks that get used are paged in and every machine running
+	the same ROM shares one copy. Anything else is read into a
+	buffer padded out to whole banks.
+*/
+int load_rom(struct gb_context *gb, char **filename)
 {
-	int sigh;
+	struct stat info;
 	size_t error;
 	unsigned long size;
 	FILE *file;
+	void *mapped;
+	int fd;
 
-	file = fopen(*filename, "rb");
-	if(file == NULL)
+	fd = open(*filename, O_RDONLY);
+	if(fd < 0)
 		return -1;
-        fseek(file, 0, SEEK_END);
-        size = ftell(file);
-        rewind(file);
 
-	ROM = malloc(size * sizeof(char*));
-	if(ROM == NULL)
+	if(fstat(fd, &info) < 0)
+	{
+		close(fd);
 		return -1;
+	}
 
-	error = fread(ROM, 1, size, file);
-	if(error != size)
+	size = info.st_size;
+
+	/*
+		Round up to whole 16KB banks, and at least the two the
+		memory map starts with
+	*/
+	gb->ROM_size = (size + 0x3FFF) & ~0x3FFFUL;
+	if(gb->ROM_size < 0x8000)
+		gb->ROM_size = 0x8000;
+
+	if(size == gb->ROM_size)
+	{
+		mapped = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+
+		if(mapped == MAP_FAILED)
+			return -1;
+
+		gb->ROM = mapped;
+		gb->ROM_mapped = 1;
+
+		return 0;
+	}
+
+	file = fdopen(fd, "rb");
+	if(file == NULL)
+	{
+		close(fd);
+		return -1;
+	}
+
+	/* Past the end of the file is padded with zeroes */
+	gb->ROM = calloc(gb->ROM_size, 1);
+	gb->ROM_mapped = 0;
+	if(gb->ROM == NULL)
+	{
+		fclose(file);
 		return -1;
+	}
 
+	error = fread(gb->ROM, 1, size, file);
 	fclose(file);
 
+	if(error != size)
+	{
+		free(gb->ROM);
+		gb->ROM = NULL;
+		return -1;
+	}
+
 	return 0;
 }
 
-/* Initialize the memory map, load ROM initial ROM banks */
-void memory_init()
+/* Let go of the ROM however load_rom got hold of it */
+void unload_rom(struct gb_context *gb)
+{
+	if(gb->ROM == NULL)
+		return;
+
+	if(gb->ROM_mapped)
+		munmap(gb->ROM, gb->ROM_size);
+	else
+		free(gb->ROM);
+
+	gb->ROM = NULL;
+}
+
+/*
+	Point the pages covering start to end (inclusive) at read and
+	write, each page getting the next 256 bytes. A NULL pointer
+	leaves those accesses to the pages' handlers.
+*/
+void memory_map(struct gb_context *gb, word start, word end,
+	byte *read, byte *write)
+{
+	int page;
+
+	for(page = start >> 8; page <= end >> 8; page++)
+	{
+		gb->read_page[page] = read;
+		gb->write_page[page] = write;
+
+		if(read != NULL)
+			read += 0x100;
+		if(write != NULL)
+			write += 0x100;
+	}
+}
+
+/* Set the handlers for the pages covering start to end */
+void memory_handle(struct gb_context *gb, word start, word end,
+	memory_read_handler read, memory_write_handler write)
+{
+	int page;
+
+	for(page = start >> 8; page <= end >> 8; page++)
+	{
+		gb->read_handler[page] = read;
+		gb->write_handler[page] = write;
+	}
+}
+
+/* For pages with nothing behind them */
+static byte memory_read_open(struct gb_context *gb, word address)
+{
+	return 0xFF;
+}
+
+/* For pages that can't be written, or not right now */
+static void memory_write_ignore(struct gb_context *gb, word address,
+	byte data)
+{
+}
+
+/*
+	Shut off everything below 0xFF00 while OAM DMA has the bus,
+	reads give 0xFF and writes are dropped until memory_unlock()
+	puts the map back as it was
+*/
+void memory_lock(struct gb_context *gb)
+{
+	int page;
+
+	memcpy(gb->locked_read_page, gb->read_page,
+		sizeof(gb->read_page));
+	memcpy(gb->locked_write_page, gb->write_page,
+		sizeof(gb->write_page));
+	memcpy(gb->locked_read_handler, gb->read_handler,
+		sizeof(gb->read_handler));
+	memcpy(gb->locked_write_handler, gb->write_handler,
+		sizeof(gb->write_handler));
+
+	for(page = 0x00; page < 0xFF; page++)
+	{
+		gb->read_page[page] = NULL;
+		gb->write_page[page] = NULL;
+		gb->read_handler[page] = memory_read_open;
+		gb->write_handler[page] = memory_write_ignore;
+	}
+}
+
+void memory_unlock(struct gb_context *gb)
+{
+	memcpy(gb->read_page, gb->locked_read_page,
+		sizeof(gb->read_page));
+	memcpy(gb->write_page, gb->locked_write_page,
+		sizeof(gb->write_page));
+	memcpy(gb->read_handler, gb->locked_read_handler,
+		sizeof(gb->read_handler));
+	memcpy(gb->write_handler, gb->locked_write_handler,
+		sizeof(gb->write_handler));
+}
+
+/* Echo RAM is a mirror of 0xC000-0xDDFF */
+static void memory_write_echo(struct gb_context *gb, word address,
+	byte data)
+{
+	memory_writeb(gb, address - 0x2000, data);
+}
+
+/* Initialize the memory map, map in the cartridge */
+void memory_init(struct gb_context *gb)
 {
 	/* 0 out the memory for safety */
-	memset(memory, 0, 0xFFFF);
+	memset(gb->memory, 0, 0xFFFF);
+
+	/*
+		Everything else reads straight from memory[], echo RAM
+		needs a handler to write and the I/O page to do anything
+	*/
+	memory_handle(gb, 0x0000, 0xFFFF, memory_read_open, NULL);
+	memory_map(gb, 0x0000, 0xFFFF, gb->memory, gb->memory);
+
+	memory_map(gb, 0xE000, 0xFDFF, gb->memory + 0xC000, NULL);
+	memory_handle(gb, 0xE000, 0xFDFF, NULL, memory_write_echo);
+
+	memory_map(gb, 0xFF00, 0xFFFF, NULL, NULL);
+	memory_handle(gb, 0xFF00, 0xFFFF, IO_read, IO_write);
+	IO_init(gb);
+
+	/* Tile data writes go past the tile cache */
+	GL_init(gb);
 
-	/* Memory map always stores bank 0 of ROM in the first 16KB */
-	memmove(memory, ROM, 0x3FFF);
-	/* ROM bank 1 will be initialized here, carts with MBCs will be able
-		to switch this bank with other ROM banks */
-	memmove(memory+0x3FFF, ROM+0x3FFF, 0x3FFF);
+	/* ROM banks and cartridge RAM are up to the MBC */
+	MBC_init(gb);
+
+	/* Nothing decoded from the old memory contents is valid now */
+	CACHE_flush(gb);
 }
 
 /* Get and return a byte from memory */
-byte memory_readb(word address)
+byte memory_readb(struct gb_context *gb, word address)
 {
-	return memory[address];
+	byte *page = gb->read_page[address >> 8];
+
+	if(page != NULL)
+		return page[address & 0xFF];
+
+	return gb->read_handler[address >> 8](gb, address);
 }
 
 /* Read two bytes from memory and return a combined word */
-word memory_readw(word address)
+word memory_readw(struct gb_context *gb, word address)
 {
 	word result;
 	byte n1, n2;
 
-	n1 = memory[address];
-	n2 = memory[address+1];
+	n1 = memory_readb(gb, address);
+	n2 = memory_readb(gb, address+1);
 
-	convert_to_pair(&n1, &n2, &result);
+	result = (n1 << 8) | n2;
 
 	return result;
 }
 
 /* Write byte into memory address */
-void memory_writeb(word address, byte data)
+void memory_writeb(struct gb_context *gb, word address, byte data)
 {
-	memory[address] = data;
+	byte *page = gb->write_page[address >> 8];
 
-	/* If address is the DMA register, start DMA transfer */
-	if(address == 0xFF46)
+	if(page == NULL)
 	{
-		GL_dma(data);
+		gb->write_handler[address >> 8](gb, address, data);
+		return;
 	}
+
+	page[address & 0xFF] = data;
+
+	/* If this overwrote cached code, drop the blocks holding it */
+	if(gb->cache_marks[address])
+		CACHE_invalidate(gb, address);
 }
 
-void printROM()
+void printROM(struct gb_context *gb)
 {
-	int x;
-	int size;
+	unsigned long x;
 
-	/* note: this doesn't work with dynamic arrays */
-	size = (sizeof(ROM) / sizeof(ROM[0]));
-
-	for(x = 0; x < size; x++)
-		printf("ROM %X: %X\n", x, ROM[x]);
+	for(x = 0; x < gb->ROM_size; x++)
+		printf("ROM %lX: %X\n", x, gb->ROM[x]);
 }
 
-void printMEMORY()
+void printMEMORY(struct gb_context *gb)
 {
 	int x;
 	int size;
 
-	size = (sizeof(memory) / sizeof(uint8_t));
+	size = (sizeof(gb->memory) / sizeof(uint8_t));
 
 	for(x = 0; x < size; x++)
-		printf("memory %X: %X\n", x, memory[x]);
+		printf("memory %X: %X\n", x, gb->memory[x]);
 }
 
-void printBANK0()
+void printBANK0(struct gb_context *gb)
 {
 	int x;
 
 	for(x = 0; x <= 0x3FFF; x++)
-		printf("BANK0 %X: %X\n", x, memory[x]);
+		printf("BANK0 %X: %X\n", x, memory_readb(gb, x));
 }
 
-void printBANK1()
+void printBANK1(struct gb_context *gb)
 {
         int x;
 
         for(x = 0x4000; x <= 0x7FFF; x++)
-                printf("BANK1 %X: %X\n", x, memory[x]);
+                printf("BANK1 %X: %X\n", x, memory_readb(gb, x));
 }
 
-void printZEROPAGE()
+void printZEROPAGE(struct gb_context *gb)
 {
 	int x;
 
 	for(x = 0xFF80; x <= 0xFFFE; x++)
-		printf("ZEROP %X: %X\n", x, memory[x]);
+		printf("ZEROP %X: %X\n", x, gb->memory[x]);
 }
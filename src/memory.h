@@ -30,35 +30,45 @@ typedef uint8_t byte;
 typedef int8_t s_byte;
 typedef uint16_t word;
 
+/* The machine everything operates on, see gb.h */
+struct gb_context;
 
-/* Array of bytes to hold the entire ROM */
-byte *ROM;
-/* Raw emulation of the GB memory map, may change in the future. */
-byte memory[0xFFFF+1];
-
-
+/* Called for accesses to pages that aren't mapped to a pointer */
+typedef byte (*memory_read_handler)(struct gb_context*, word);
+typedef void (*memory_write_handler)(struct gb_context*, word, byte);
 
 
 /* Load ROM from file name into an array for easy access. */
-int load_rom(char **rom);
+int load_rom(struct gb_context*, char **rom);
+/* Free or unmap the ROM */
+void unload_rom(struct gb_context*);
 /* Initialize memory */
-void memory_init();
+void memory_init(struct gb_context*);
+/* Point the pages from start to end at host memory */
+void memory_map(struct gb_context*, word start, word end,
+	byte *read, byte *write);
+/* Give the pages from start to end handlers for unmapped accesses */
+void memory_handle(struct gb_context*, word start, word end,
+	memory_read_handler, memory_write_handler);
+/* Lock everything but HRAM and I/O for OAM DMA, and unlock it again */
+void memory_lock(struct gb_context*);
+void memory_unlock(struct gb_context*);
 /* Read byte from memory */
-byte memory_readb(word);
+byte memory_readb(struct gb_context*, word);
 /* Read word from memory */
-word memory_readw(word);
+word memory_readw(struct gb_context*, word);
 /* Write byte to memory */
-void memory_writeb(word, byte);
+void memory_writeb(struct gb_context*, word, byte);
 /* Write word to memory */
 void memory_writew(word, word);
 
 
 
 /* DEBUG FUNCTIONS - Remove these when real debugging is in */
-void printROM();
-void printMEMORY();
-void printBANK0();
-void printBANK1();
-void printZEROPAGE();
+void printROM(struct gb_context*);
+void printMEMORY(struct gb_context*);
+void printBANK0(struct gb_context*);
+void printBANK1(struct gb_context*);
+void printZEROPAGE(struct gb_context*);
 void loadBIOS();
 #endif
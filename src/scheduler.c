@@ -0,0 +1,140 @@
+/*
+	Copyright 2012, 2013 Charles O.
+	Email: charles.0x4f@gmail.com
+	Github: https://github.com/charles-0x4f/
+
+	This file is part of TermGB.
+
+	TermGB is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	TermGB is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with TermGB.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/* scheduler.c */
+
+#include "gb.h"
+#include "scheduler.h"
+#include "cpu.h"
+#include "lcd.h"
+#include "timer.h"
+#include "gl.h"
+
+/* Handlers, indexed by event */
+static void (*const handlers[EVENTS])(struct gb_context*, long) = {
+	LCD_event,
+	TIMER_event,
+	GL_dma_event,
+	CPU_interrupt_event
+};
+
+/*
+	Once scheduler_now gets this big, everything is moved back
+	so that it starts from 0 again, long may only be 32 bits
+*/
+#define SCHEDULER_REBASE 0x40000000L
+
+/* Work out which event is due next */
+static void SCHEDULER_find_next(struct gb_context *gb)
+{
+	int event;
+
+	gb->scheduler_next = EVENT_NEVER;
+
+	for(event = 0; event < EVENTS; event++)
+	{
+		if(gb->event_due[event] < gb->scheduler_next)
+			gb->scheduler_next = gb->event_due[event];
+	}
+}
+
+/* Empty the queue and start counting from 0 */
+void SCHEDULER_reset(struct gb_context *gb)
+{
+	int event;
+
+	for(event = 0; event < EVENTS; event++)
+		gb->event_due[event] = EVENT_NEVER;
+
+	gb->scheduler_now = 0;
+	gb->scheduler_next = EVENT_NEVER;
+}
+
+/*
+	Queue an event to happen in a number of cycles, 0 means as
+	soon as the current instruction has finished
+*/
+void SCHEDULER_add(struct gb_context *gb, int event, long delay)
+{
+	SCHEDULER_add_at(gb, event, gb->scheduler_now + delay);
+}
+
+/* Queue an event to happen at the given cycle */
+void SCHEDULER_add_at(struct gb_context *gb, int event, long time)
+{
+	gb->event_due[event] = time;
+
+	if(time < gb->scheduler_next)
+		gb->scheduler_next = time;
+	else
+		SCHEDULER_find_next(gb);
+}
+
+/* Take an event off the queue */
+void SCHEDULER_remove(struct gb_context *gb, int event)
+{
+	gb->event_due[event] = EVENT_NEVER;
+
+	SCHEDULER_find_next(gb);
+}
+
+/*
+	Run every event that's due, in the order they were due in.
+	Called from CPU_tick once scheduler_now reaches scheduler_next.
+*/
+void SCHEDULER_run(struct gb_context *gb)
+{
+	int event, first;
+	long time;
+
+	if(gb->scheduler_now >= SCHEDULER_REBASE)
+	{
+		for(event = 0; event < EVENTS; event++)
+		{
+			if(gb->event_due[event] != EVENT_NEVER)
+				gb->event_due[event] -= gb->scheduler_now;
+		}
+
+		/* The divider counts from a cycle too */
+		gb->div_base -= gb->scheduler_now;
+
+		gb->scheduler_now = 0;
+		SCHEDULER_find_next(gb);
+	}
+
+	while(gb->scheduler_now >= gb->scheduler_next)
+	{
+		/* Earliest first, ties go to the lower event */
+		first = 0;
+		for(event = 1; event < EVENTS; event++)
+		{
+			if(gb->event_due[event] < gb->event_due[first])
+				first = event;
+		}
+
+		time = gb->event_due[first];
+		gb->event_due[first] = EVENT_NEVER;
+		SCHEDULER_find_next(gb);
+
+		handlers[first](gb, time);
+	}
+}
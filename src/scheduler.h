@@ -0,0 +1,61 @@
+/*
+	Copyright 2012, 2013 Charles O.
+	Email: charles.0x4f@gmail.com
+	Github: https://github.com/charles-0x4f/
+
+	This file is part of TermGB.
+
+	TermGB is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	TermGB is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with TermGB.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/* scheduler.h */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+/*
+	Event scheduler
+
+	Rather than stepping every piece of hardware after each
+	instruction, each one queues the cycle it next needs attention
+	at. CPU_tick only adds up cycles and compares them against the
+	earliest queued event; once that's due, SCHEDULER_run calls its
+	handler, which usually queues the event's next occurrence.
+
+	Each event can be queued once, queueing it again moves it.
+	Handlers are given the cycle the event was due at so they can
+	queue the next one relative to that, without drifting by however
+	far the instruction or JIT block overshot it.
+*/
+
+/* Events, when two are due on the same cycle the lower runs first */
+#define EVENT_LCD		0	/* PPU mode change or next line */
+#define EVENT_TIMER		1	/* TIMA increment */
+#define EVENT_DMA		2	/* OAM DMA finished */
+#define EVENT_INTERRUPT		3	/* EI/DI delay, interrupt check */
+#define EVENTS			4
+
+/* Due time of an event that isn't queued */
+#define EVENT_NEVER 0x7FFFFFFFL
+
+struct gb_context;
+
+void SCHEDULER_reset(struct gb_context*);
+void SCHEDULER_add(struct gb_context*, int, long);
+void SCHEDULER_add_at(struct gb_context*, int, long);
+void SCHEDULER_remove(struct gb_context*, int);
+void SCHEDULER_run(struct gb_context*);
+
+#endif
@@ -0,0 +1,94 @@
+/*
+	Copyright 2012, 2013 Charles O.
+	Email: charles.0x4f@gmail.com
+	Github: https://github.com/charles-0x4f/
+
+	This file is part of TermGB.
+
+	TermGB is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	TermGB is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with TermGB.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/* timer.c */
+
+#include "gb.h"
+#include "timer.h"
+#include "cpu.h"
+#include "scheduler.h"
+
+/* Cycles between TIMA increments for each TAC clock select */
+static const long timer_periods[4] = { 1024, 16, 64, 256 };
+
+/* Queue the next TIMA increment, or stop it if TAC disabled it */
+static void TIMER_start(struct gb_context *gb, long from)
+{
+	if(gb->timer_control & 0x4)
+	{
+		SCHEDULER_add_at(gb, EVENT_TIMER,
+			from + timer_periods[gb->timer_control & 0x3]);
+	}
+	else
+	{
+		SCHEDULER_remove(gb, EVENT_TIMER);
+	}
+}
+
+/* Start the divider and the timer from the registers' values */
+void TIMER_reset(struct gb_context *gb)
+{
+	gb->div_base = gb->scheduler_now;
+
+	gb->timer_control = gb->memory[0xFF07];
+	TIMER_start(gb, gb->scheduler_now);
+}
+
+/* DIV is the number of 256 cycle periods since it was reset */
+byte TIMER_read_div(struct gb_context *gb, word address)
+{
+	return ((gb->scheduler_now - gb->div_base) >> 8) & 0xFF;
+}
+
+/* Write hook for DIV and TAC */
+void TIMER_write(struct gb_context *gb, word address, byte data)
+{
+	if(address == 0xFF04)
+	{
+		/* Any write resets the divider */
+		gb->div_base = gb->scheduler_now;
+		return;
+	}
+
+	/* Only the low three bits of TAC are there */
+	gb->memory[0xFF07] = 0xF8 | data;
+
+	if((data & 0x7) != (gb->timer_control & 0x7))
+	{
+		gb->timer_control = data;
+		TIMER_start(gb, gb->scheduler_now);
+	}
+}
+
+void TIMER_event(struct gb_context *gb, long due)
+{
+	gb->memory[0xFF05]++;
+
+	/* Overflowed, reload from TMA and request the timer interrupt */
+	if(gb->memory[0xFF05] == 0)
+	{
+		gb->memory[0xFF05] = gb->memory[0xFF06];
+		CPU_request_interrupt(gb, 2);
+	}
+
+	TIMER_start(gb, due);
+}
@@ -0,0 +1,43 @@
+/*
+	Copyright 2012, 2013 Charles O.
+	Email: charles.0x4f@gmail.com
+	Github: https://github.com/charles-0x4f/
+
+	This file is part of TermGB.
+
+	TermGB is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	TermGB is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with TermGB.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/* timer.h */
+
+#ifndef TIMER_H
+#define TIMER_H
+
+#include "memory.h"
+
+/*
+	The divider (0xFF04) counts up every 256 cycles, rather than
+	updating it that often it's worked out when it's read. The timer
+	counter TIMA (0xFF05) counts up at the rate picked by bits 0-1
+	of TAC (0xFF07) while bit 2 is set; when it overflows it's
+	reloaded from TMA (0xFF06) and the timer interrupt is requested.
+*/
+
+void TIMER_reset(struct gb_context*);
+byte TIMER_read_div(struct gb_context*, word);
+void TIMER_write(struct gb_context*, word, byte);
+void TIMER_event(struct gb_context*, long);
+
+#endif
@@ -0,0 +1,479 @@
+/*
+	Copyright 2012, 2013 Charles O.
+	Email: charles.0x4f@gmail.com
+	Github: https://github.com/charles-0x4f/
+
+	This file is part of TermGB.
+
+	TermGB is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	TermGB is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with TermGB.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/*
+	batch.c
+
+	Runs a batch of ROMs headless, without SDL, spread over a pool
+	of threads, and writes one report of how each run went.
+
+	Usage: termgb-batch [-j threads] [-f frames] [-o report]
+		[-s screenshot dir] joblist
+
+	Each line of the job list is a ROM optionally followed by an
+	input script, blank lines and lines starting with # are
+	skipped. An input script has a line per change in the buttons
+	held down, "<frame> <button>[,button...]" or "<frame> none",
+	buttons being right, left, up, down, a, b, select and start.
+
+	The report has a line per job: the frames it ran, how long it
+	took, its frames per second, a hash of the machine's state once
+	it finished and where its screenshot (a PGM of the last frame)
+	was saved, then a total for the whole batch. A frame ends at
+	V-blank, as the LCD finishes it, so frame numbers in the input
+	scripts count the game's frames and the screenshot is the frame
+	it last put out. Runs stop at the first instruction boundary
+	after V-blank, and JIT built blocks only check that on exit, so
+	compare hashes between runs of the same build.
+*/
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "../gb.h"
+#include "../joypad.h"
+
+#define MAX_JOBS 1024
+#define MAX_LINE 1024
+#define MAX_INPUTS 256
+
+/*
+	An LCD frame is 154 lines of 456 cycles. With the LCD off there's
+	no V-blank, so a frame ends once this many cycles have gone by,
+	a line later than it would have with the LCD on.
+*/
+#define FRAME_CYCLES (155 * 456)
+
+/* Buttons held down from a frame on */
+struct input {
+	long frame;
+	byte buttons;
+};
+
+struct job {
+	char rom[MAX_LINE];
+	char script[MAX_LINE];
+
+	struct input inputs[MAX_INPUTS];
+	int input_count;
+
+	/* "ok", "stopped" if an opcode wasn't handled, or "failed" */
+	const char *status;
+	long frames;
+	double seconds;
+	unsigned long hash;
+	char screenshot[MAX_LINE];
+};
+
+static struct job *jobs;
+static int job_count;
+/* Next job for a worker to take */
+static int job_next;
+static pthread_mutex_t job_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static long frame_count = 600;
+static const char *screenshot_dir;
+
+static double now()
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+
+	return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+/* Turn "a,b,start" into JOYPAD_ bits, -1 if a name isn't known */
+static int parse_buttons(char *list)
+{
+	static const char *names[] = {
+		"right", "left", "up", "down", "a", "b", "select", "start"
+	};
+	char *name;
+	int buttons = 0;
+	int i;
+
+	if(strcmp(list, "none") == 0)
+		return 0;
+
+	for(name = strtok(list, ","); name != NULL; name = strtok(NULL, ","))
+	{
+		for(i = 0; i < 8; i++)
+		{
+			if(strcmp(name, names[i]) == 0)
+				break;
+		}
+
+		if(i == 8)
+			return -1;
+
+		buttons |= 1 << i;
+	}
+
+	return buttons;
+}
+
+/* Read a job's input script, -1 if it can't be read */
+static int load_script(struct job *job)
+{
+	FILE *file;
+	char line[MAX_LINE], list[MAX_LINE];
+	long frame;
+	int buttons;
+
+	file = fopen(job->script, "r");
+	if(file == NULL)
+		return -1;
+
+	while(fgets(line, sizeof(line), file) != NULL)
+	{
+		if(line[0] == '#' || sscanf(line, "%ld %1023s", &frame, list) != 2)
+			continue;
+
+		buttons = parse_buttons(list);
+		if(buttons < 0 || job->input_count == MAX_INPUTS)
+		{
+			fclose(file);
+			return -1;
+		}
+
+		job->inputs[job->input_count].frame = frame;
+		job->inputs[job->input_count].buttons = buttons;
+		job->input_count++;
+	}
+
+	fclose(file);
+
+	return 0;
+}
+
+/* Read the job list, -1 if it can't be read */
+static int load_jobs(const char *path)
+{
+	FILE *file;
+	char line[MAX_LINE];
+	struct job *job;
+	int fields;
+
+	file = fopen(path, "r");
+	if(file == NULL)
+		return -1;
+
+	while(fgets(line, sizeof(line), file) != NULL && job_count < MAX_JOBS)
+	{
+		job = &jobs[job_count];
+		job->script[0] = '\0';
+
+		if(line[0] == '#')
+			continue;
+
+		fields = sscanf(line, "%1023s %1023s", job->rom, job->script);
+		if(fields < 1)
+			continue;
+
+		job->status = "ok";
+		if(fields == 2 && load_script(job) < 0)
+			job->status = "failed";
+
+		job_count++;
+	}
+
+	fclose(file);
+
+	return 0;
+}
+
+/* FNV-1a over the memory map and registers */
+static unsigned long hash_state(struct gb_context *gb)
+{
+	unsigned long hash = 2166136261UL;
+	byte registers[12];
+	long i;
+
+	CPU_flags(gb);
+	compiler_F(gb, 0);
+
+	registers[0] = gb->AF.b.hi;
+	registers[1] = gb->AF.b.lo;
+	registers[2] = gb->BC.b.hi;
+	registers[3] = gb->BC.b.lo;
+	registers[4] = gb->DE.b.hi;
+	registers[5] = gb->DE.b.lo;
+	registers[6] = gb->HL.b.hi;
+	registers[7] = gb->HL.b.lo;
+	registers[8] = gb->SP >> 8;
+	registers[9] = gb->SP & 0xFF;
+	registers[10] = gb->PC >> 8;
+	registers[11] = gb->PC & 0xFF;
+
+	for(i = 0; i < 12; i++)
+		hash = ((hash ^ registers[i]) * 16777619UL) & 0xFFFFFFFFUL;
+	for(i = 0; i <= 0xFFFF; i++)
+		hash = ((hash ^ memory_readb(gb, i)) * 16777619UL) &
+			0xFFFFFFFFUL;
+
+	return hash;
+}
+
+/* Save the video buffer as a greyscale PGM, -1 on failure */
+static int save_screenshot(struct gb_context *gb, const char *path)
+{
+	static const byte shades[4] = { 255, 170, 85, 0 };
+	FILE *file;
+	int x, y;
+
+	file = fopen(path, "wb");
+	if(file == NULL)
+		return -1;
+
+	fprintf(file, "P5\n160 144\n255\n");
+	for(y = 0; y < 144; y++)
+	{
+		for(x = 0; x < 160; x++)
+			fputc(shades[gb->video_buffer[y][x] & 3], file);
+	}
+
+	fclose(file);
+
+	return 0;
+}
+
+/*
+	Set as the frontend's draw_frame, so the LCD calls it at V-blank.
+	The video buffer then holds the whole frame, stop there.
+*/
+static void end_frame(struct gb_context *gb, byte (*frame)[160])
+{
+	gb->total_cycles = 0;
+	gb->frames++;
+	gb->stop = 1;
+}
+
+/* Run one job from power on to the last frame */
+static void run_job(struct job *job, int number)
+{
+	struct gb_context *gb;
+	char *rom = job->rom;
+	double start;
+	int input = 0;
+
+	if(strcmp(job->status, "ok") != 0)
+		return;
+
+	gb = GB_create();
+	if(gb == NULL || load_rom(gb, &rom) < 0)
+	{
+		job->status = "failed";
+		GB_destroy(gb);
+		return;
+	}
+
+	memory_init(gb);
+	CPU_reset(gb);
+
+	gb->draw_frame = end_frame;
+	gb->max_cycles = FRAME_CYCLES;
+
+	start = now();
+
+	/* A frame at a time, so the buttons change on the right one */
+	while(gb->frames < frame_count)
+	{
+		while(input < job->input_count &&
+			job->inputs[input].frame <= gb->frames)
+		{
+			JOYPAD_set(gb, job->inputs[input].buttons);
+			input++;
+		}
+
+		gb->frame_limit = gb->frames + 1;
+		gb->stop = 0;
+		CPU_run(gb);
+
+		/* Without stop set, CPU_run hit an unhandled opcode */
+		if(!gb->stop)
+		{
+			job->status = "stopped";
+			break;
+		}
+
+		/*
+			Ended for want of a V-blank while the LCD was off, but
+			it's been switched back on since, so that frame isn't
+			over yet, run on to its V-blank
+		*/
+		if((gb->memory[0xFF40] & 0x80) && gb->memory[0xFF44] != 144)
+			gb->frames--;
+	}
+
+	job->seconds = now() - start;
+	job->frames = gb->frames;
+	job->hash = hash_state(gb);
+
+	if(screenshot_dir != NULL)
+	{
+		sprintf(job->screenshot, "%.900s/job%i.pgm",
+			screenshot_dir, number);
+
+		if(save_screenshot(gb, job->screenshot) < 0)
+			strcpy(job->screenshot, "-");
+	}
+
+	GB_destroy(gb);
+}
+
+/* Keep taking jobs until there are none left */
+static void *worker(void *unused)
+{
+	int number;
+
+	for(;;)
+	{
+		pthread_mutex_lock(&job_lock);
+		number = job_next++;
+		pthread_mutex_unlock(&job_lock);
+
+		if(number >= job_count)
+			return NULL;
+
+		run_job(&jobs[number], number);
+	}
+}
+
+static void write_report(FILE *out, int threads, double seconds)
+{
+	struct job *job;
+	long frames = 0;
+	int i;
+
+	fprintf(out, "# job\trom\tinput\tstatus\tframes\tseconds\tfps"
+		"\tstate\tscreenshot\n");
+
+	for(i = 0; i < job_count; i++)
+	{
+		job = &jobs[i];
+		frames += job->frames;
+
+		fprintf(out, "%i\t%s\t%s\t%s\t%li\t%.3f\t%.1f\t%08lx\t%s\n",
+			i, job->rom, job->script[0] ? job->script : "-",
+			job->status, job->frames, job->seconds,
+			job->seconds > 0 ? job->frames / job->seconds : 0.0,
+			job->hash, job->screenshot[0] ? job->screenshot : "-");
+	}
+
+	fprintf(out, "# total: %i jobs on %i threads, %li frames in %.3fs"
+		" (%.1f fps)\n", job_count, threads, frames, seconds,
+		seconds > 0 ? frames / seconds : 0.0);
+}
+
+static void usage()
+{
+	printf("Usage: termgb-batch [-j threads] [-f frames] [-o report]"
+		" [-s screenshot dir] joblist\n");
+}
+
+int main(int argc, char *argv[])
+{
+	pthread_t *pool;
+	const char *report = NULL;
+	FILE *out = stdout;
+	int threads, started, i;
+	double start;
+
+	threads = sysconf(_SC_NPROCESSORS_ONLN);
+
+	for(i = 1; i < argc - 1 && argv[i][0] == '-'; i += 2)
+	{
+		if(strcmp(argv[i], "-j") == 0)
+			threads = atoi(argv[i + 1]);
+		else if(strcmp(argv[i], "-f") == 0)
+			frame_count = atol(argv[i + 1]);
+		else if(strcmp(argv[i], "-o") == 0)
+			report = argv[i + 1];
+		else if(strcmp(argv[i], "-s") == 0)
+			screenshot_dir = argv[i + 1];
+		else
+			break;
+	}
+
+	if(i != argc - 1)
+	{
+		usage();
+		return 1;
+	}
+
+	jobs = calloc(MAX_JOBS, sizeof(struct job));
+	if(jobs == NULL || load_jobs(argv[i]) < 0)
+	{
+		printf("Couldn't read the job list %s\n", argv[i]);
+		return 1;
+	}
+
+	if(threads < 1)
+		threads = 1;
+	if(threads > job_count && job_count > 0)
+		threads = job_count;
+
+	pool = malloc(threads * sizeof(pthread_t));
+	if(pool == NULL)
+		return 1;
+
+	start = now();
+
+	for(started = 0; started < threads; started++)
+	{
+		if(pthread_create(&pool[started], NULL, worker, NULL) != 0)
+			break;
+	}
+
+	/* Whatever threads did start will get through every job */
+	if(started == 0)
+		worker(NULL);
+
+	for(i = 0; i < started; i++)
+		pthread_join(pool[i], NULL);
+
+	if(report != NULL)
+	{
+		out = fopen(report, "w");
+		if(out == NULL)
+		{
+			printf("Couldn't write %s\n", report);
+			return 1;
+		}
+	}
+
+	write_report(out, started > 0 ? started : 1, now() - start);
+
+	if(out != stdout)
+		fclose(out);
+
+	free(pool);
+	free(jobs);
+
+	return 0;
+}
@@ -0,0 +1,58 @@
+/*
+	Copyright 2012, 2013 Charles O.
+	Email: charles.0x4f@gmail.com
+	Github: https://github.com/charles-0x4f/
+
+	This file is part of TermGB.
+
+	TermGB is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	TermGB is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with TermGB.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+	tracedump.c
+
+	Prints a trace saved by a debug run as text.
+	Usage: tracedump [file], file defaults to termgb.trace
+*/
+
+#include <stdio.h>
+#include "../trace.h"
+
+int main(int argc, char *argv[])
+{
+	FILE *file;
+	const char *path = TRACE_FILE;
+	long records;
+
+	if(argc >= 2)
+		path = argv[1];
+
+	file = fopen(path, "rb");
+	if(file == NULL)
+	{
+		printf("Couldn't open %s\n", path);
+		return 1;
+	}
+
+	records = trace_decode(file, stdout);
+	fclose(file);
+
+	if(records < 0)
+	{
+		printf("%s isn't a trace file\n", path);
+		return 1;
+	}
+
+	return 0;
+}
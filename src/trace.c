@@ -0,0 +1,311 @@
+/*
+	Copyright 2012, 2013 Charles O.
+	Email: charles.0x4f@gmail.com
+	Github: https://github.com/charles-0x4f/
+
+	This file is part of TermGB.
+
+	TermGB is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	TermGB is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with TermGB.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+	trace.c
+
+	The trace ring buffer, saving it and decoding it back into
+	text. This file doesn't depend on the rest of the emulator so
+	the tracedump tool can be built from it alone.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "trace.h"
+
+/* An event's category, level and the text it decodes to */
+struct trace_event {
+	int category;
+	int level;
+	const char *format;
+};
+
+/*
+	Indexed by the TRACE_ event numbers. The level is the lowest
+	debug level the event is recorded at; the format is given all
+	TRACE_ARGS values as longs.
+*/
+static const struct trace_event trace_events[TRACE_EVENTS] = {
+	{TRACE_CPU, 0, "PC: %lX OP: %lX ICount: %li"},
+	{TRACE_CPU, 1, "NextB: %lX"},
+	{TRACE_CPU, 2, "Z: %lX; N: %lX; H: %lX; C: %lX"},
+	{TRACE_CPU, 3, "A: %lX; BC: %lX; DE: %lX; HL: %lX; SP: %lX"},
+	{TRACE_CPU, 1, "DBG 2A; Address from HL: %lX"},
+	{TRACE_CPU, 1, "DBG JRCC PC: %lX; Z: %lX; PC+nb: %lX+(%li): %lX"},
+	{TRACE_STACK, 1, "DBG SP:ps %lX -> %lX; PC: %lX; Data: %lX"},
+	{TRACE_STACK, 1, "DBG SP:pop %lX -> %lX; Data: %lX"},
+	{TRACE_STACK, 0, "DBG CALL NEXT INSTR: %lX; PUSH: %lX %lX; PC: %lX"},
+	{TRACE_STACK, 0, "DBG RST OFFSET: %lX"},
+	{TRACE_STACK, 0, "DBG RET TEMP1: %lX; TEMP2: %lX; ADDRESS: %lX"},
+	{TRACE_STACK, 0, "RETI D9 PC: %lX"},
+	{TRACE_INTERRUPT, 1, "DBG INTSTEP 0, IE-B: %li; IE-A: %li"},
+	{TRACE_INTERRUPT, 1, "DBG IE; INTF: %lX, INTE: %lX"},
+	{TRACE_INTERRUPT, 0, "DBG SERV INT: %li; PC: %lX; low: %lX; high: %lX"},
+	{TRACE_INTERRUPT, 0, "DBG REQ INT: %li; FLAG: %lX; READ: %lX"},
+	{TRACE_VIDEO, 3, "DBG VIDEO BIT COLOR: %lx; PALETTE: %lx; FINAL: %li"},
+	{TRACE_VIDEO, 1, "DBG VIDEO SCANLINE: %li"},
+	{TRACE_VIDEO, 3, "DBG VIDEOB %li: %li"}
+};
+
+/* A recorded event */
+struct trace_record {
+	int event;
+	long args[TRACE_ARGS];
+};
+
+unsigned char trace_enabled[TRACE_EVENTS];
+int trace_echo;
+
+static struct trace_record ring[TRACE_RECORDS];
+/* Records written since trace_setup, the ring keeps the newest */
+static unsigned long written;
+
+/*
+	The saved file is a header followed by the records oldest
+	first, every number little endian so the file can be decoded
+	on any host:
+
+	"TGBTRACE", version (1 byte), TRACE_ARGS (1 byte),
+	record count (4 bytes)
+	each record: event (2 bytes), TRACE_ARGS values (4 bytes each)
+*/
+#define TRACE_MAGIC "TGBTRACE"
+#define TRACE_VERSION 1
+
+/* Print a record as its line of text */
+static void trace_print(FILE *out, int event, long *args)
+{
+	if(event < 0 || event >= TRACE_EVENTS)
+	{
+		fprintf(out, "Unknown trace event %i\n", event);
+		return;
+	}
+
+	fprintf(out, trace_events[event].format,
+		args[0], args[1], args[2], args[3], args[4]);
+	fprintf(out, "\n");
+}
+
+/*
+	Enable every event in one of the categories whose level is at
+	or below level; a negative level turns tracing off
+*/
+void trace_setup(int categories, int level)
+{
+	int event;
+
+	for(event = 0; event < TRACE_EVENTS; event++)
+	{
+		trace_enabled[event] =
+			(trace_events[event].category & categories) &&
+			trace_events[event].level <= level;
+	}
+
+	written = 0;
+}
+
+/*
+	Turn a comma separated list of category names ("cpu", "stack",
+	"int", "video" or "all") into TRACE_ bits, -1 if a name isn't
+	recognised
+*/
+int trace_parse_categories(const char *list)
+{
+	static const char *names[] = { "cpu", "stack", "int", "video" };
+	int categories = 0;
+	int i;
+	size_t length;
+
+	while(*list != '\0')
+	{
+		length = strcspn(list, ",");
+
+		if(length == 3 && strncmp(list, "all", 3) == 0)
+		{
+			categories |= TRACE_ALL;
+		}
+		else
+		{
+			for(i = 0; i < 4; i++)
+			{
+				if(strlen(names[i]) == length &&
+					strncmp(list, names[i], length) == 0)
+					break;
+			}
+
+			if(i == 4)
+				return -1;
+
+			categories |= 1 << i;
+		}
+
+		list += length;
+		if(*list == ',')
+			list++;
+	}
+
+	return categories;
+}
+
+/* Non-zero if any event is being recorded */
+int trace_active()
+{
+	int event;
+
+	for(event = 0; event < TRACE_EVENTS; event++)
+	{
+		if(trace_enabled[event])
+			return 1;
+	}
+
+	return 0;
+}
+
+/*
+	Record an event, only reached through the TRACE macros once
+	trace_enabled has been checked
+*/
+void trace_write(int event, long a, long b, long c, long d, long e)
+{
+	struct trace_record *record;
+
+	record = &ring[written & (TRACE_RECORDS - 1)];
+	written++;
+
+	record->event = event;
+	record->args[0] = a;
+	record->args[1] = b;
+	record->args[2] = c;
+	record->args[3] = d;
+	record->args[4] = e;
+
+	if(trace_echo)
+		trace_print(stdout, event, record->args);
+}
+
+/* Write n bytes of value, least significant first */
+static void put_le(FILE *file, unsigned long value, int n)
+{
+	while(n-- > 0)
+	{
+		fputc(value & 0xFF, file);
+		value >>= 8;
+	}
+}
+
+/* Read n little endian bytes, -1 on end of file */
+static int get_le(FILE *file, unsigned long *value, int n)
+{
+	int shift, c;
+
+	*value = 0;
+
+	for(shift = 0; shift < n * 8; shift += 8)
+	{
+		c = fgetc(file);
+		if(c == EOF)
+			return -1;
+
+		*value |= (unsigned long)c << shift;
+	}
+
+	return 0;
+}
+
+/*
+	Save what's in the ring buffer to path, returns the number of
+	records saved or -1 if the file can't be written
+*/
+long trace_save(const char *path)
+{
+	FILE *file;
+	unsigned long first, i;
+	struct trace_record *record;
+	int arg;
+
+	file = fopen(path, "wb");
+	if(file == NULL)
+		return -1;
+
+	/* Once the ring has wrapped, the oldest record is the next one */
+	first = (written > TRACE_RECORDS) ? written - TRACE_RECORDS : 0;
+
+	fwrite(TRACE_MAGIC, 1, strlen(TRACE_MAGIC), file);
+	fputc(TRACE_VERSION, file);
+	fputc(TRACE_ARGS, file);
+	put_le(file, written - first, 4);
+
+	for(i = first; i < written; i++)
+	{
+		record = &ring[i & (TRACE_RECORDS - 1)];
+
+		put_le(file, record->event, 2);
+		for(arg = 0; arg < TRACE_ARGS; arg++)
+			put_le(file, record->args[arg], 4);
+	}
+
+	fclose(file);
+
+	return written - first;
+}
+
+/*
+	Turn a saved trace back into lines of text, returns the number
+	of records decoded or -1 if in isn't a trace file
+*/
+long trace_decode(FILE *in, FILE *out)
+{
+	char magic[sizeof(TRACE_MAGIC)];
+	unsigned long count, i, value;
+	unsigned long event;
+	long args[TRACE_ARGS];
+	int arg;
+
+	if(fread(magic, 1, strlen(TRACE_MAGIC), in) != strlen(TRACE_MAGIC) ||
+		memcmp(magic, TRACE_MAGIC, strlen(TRACE_MAGIC)) != 0)
+		return -1;
+
+	if(fgetc(in) != TRACE_VERSION || fgetc(in) != TRACE_ARGS ||
+		get_le(in, &count, 4) < 0)
+		return -1;
+
+	for(i = 0; i < count; i++)
+	{
+		if(get_le(in, &event, 2) < 0)
+			return i;
+
+		for(arg = 0; arg < TRACE_ARGS; arg++)
+		{
+			if(get_le(in, &value, 4) < 0)
+				return i;
+
+			/* Values were saved as 32 bits, put the sign back */
+			if(value & 0x80000000UL)
+				args[arg] = -(long)((~value & 0xFFFFFFFFUL) + 1);
+			else
+				args[arg] = value;
+		}
+
+		trace_print(out, event, args);
+	}
+
+	return count;
+}
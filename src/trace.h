@@ -0,0 +1,115 @@
+/*
+	Copyright 2012, 2013 Charles O.
+	Email: charles.0x4f@gmail.com
+	Github: https://github.com/charles-0x4f/
+
+	This file is part of TermGB.
+
+	TermGB is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	TermGB is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with TermGB.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* trace.h */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdio.h>
+
+/*
+	Tracing
+
+	Debug output is recorded as small binary records in a ring
+	buffer rather than printed. Each event has a category and a
+	level; trace_setup() picks which ones are recorded at runtime.
+	A disabled event costs a single test of trace_enabled[event].
+	trace_save() writes the buffer to a file and trace_decode()
+	(or the tracedump tool) turns it back into text.
+
+	Building with -DTRACE_DISABLE compiles the TRACE macros away
+	completely.
+
+	There's one ring buffer for the whole process, it's meant for
+	debugging a single machine rather than a batch of them.
+*/
+
+/* Categories, or'd together for trace_setup() */
+#define TRACE_CPU		0x01	/* instruction stepping, jumps */
+#define TRACE_STACK		0x02	/* pushes, pops, calls, returns */
+#define TRACE_INTERRUPT		0x04	/* requests and servicing */
+#define TRACE_VIDEO		0x08	/* scanlines and pixels */
+#define TRACE_ALL		0x0F
+
+/* Events, see trace_events in trace.c for their text */
+#define TRACE_STEP		0
+#define TRACE_NEXT_BYTE		1
+#define TRACE_FLAGS		2
+#define TRACE_REGISTERS		3
+#define TRACE_LDI_HL		4
+#define TRACE_JR		5
+#define TRACE_PUSH		6
+#define TRACE_POP		7
+#define TRACE_CALL		8
+#define TRACE_RESTART		9
+#define TRACE_RETURN		10
+#define TRACE_RETI		11
+#define TRACE_IE_SWITCH		12
+#define TRACE_INT_PENDING	13
+#define TRACE_INT_SERVICE	14
+#define TRACE_INT_REQUEST	15
+#define TRACE_VIDEO_COLOR	16
+#define TRACE_VIDEO_SCANLINE	17
+#define TRACE_VIDEO_PIXEL	18
+#define TRACE_EVENTS		19
+
+/* Most values an event can record */
+#define TRACE_ARGS 5
+
+/* Records the ring buffer holds, must be a power of two */
+#define TRACE_RECORDS 65536
+
+/* Default file for trace_save() */
+#define TRACE_FILE "termgb.trace"
+
+/* Non-zero for each event that's currently being recorded */
+extern unsigned char trace_enabled[TRACE_EVENTS];
+
+/* When set, records are also printed to stdout as they're made */
+extern int trace_echo;
+
+#ifdef TRACE_DISABLE
+#define TRACE1(event, a)
+#define TRACE2(event, a, b)
+#define TRACE3(event, a, b, c)
+#define TRACE4(event, a, b, c, d)
+#define TRACE5(event, a, b, c, d, e)
+#else
+#define TRACE1(event, a) TRACE5(event, a, 0, 0, 0, 0)
+#define TRACE2(event, a, b) TRACE5(event, a, b, 0, 0, 0)
+#define TRACE3(event, a, b, c) TRACE5(event, a, b, c, 0, 0)
+#define TRACE4(event, a, b, c, d) TRACE5(event, a, b, c, d, 0)
+#define TRACE5(event, a, b, c, d, e) \
+	do { \
+		if(trace_enabled[event]) \
+			trace_write(event, a, b, c, d, e); \
+	} while(0)
+#endif
+
+void trace_setup(int, int);
+int trace_parse_categories(const char*);
+int trace_active();
+void trace_write(int, long, long, long, long, long);
+long trace_save(const char*);
+long trace_decode(FILE*, FILE*);
+
+#endif